@@ -170,6 +170,16 @@ struct vix::orm::Mapper<User>
         {"age", u.age},
     };
   }
+
+  // Lets BaseRepository::writeJson stream rows without building User.
+  template <class Fn>
+  static void visitRow(const vix::orm::RowView &row, Fn &&field)
+  {
+    field("id", row.getInt64Or(0, 0));
+    field("name", row.getTextOr(1, ""));
+    field("email", row.getTextOr(2, ""));
+    field("age", row.getInt64Or(3, 0));
+  }
 };
 
 // -----------------------------------------------------------------------------
@@ -314,21 +324,21 @@ static void register_user_routes(App &app, const AppState &state)
 {
   app.get("/users", [state](Request &, Response &res)
           {
-            const auto users = state.users->findAll();
-
-            std::vector<J::token> items;
-            items.reserve(users.size());
-
-            for (const auto &u : users)
-            {
-              items.emplace_back(user_to_json(u));
-            }
-
-            res.json(J::obj({
-                "ok", true,
-                "count", static_cast<long long>(items.size()),
-                "data", J::array(std::move(items)),
-            })); });
+            // Rows are written from the result set straight into one body
+            // string, skipping intermediate User objects and a JSON tree.
+            // The body is still buffered in full before it is sent.
+            std::string body;
+            vix::orm::JsonWriter json(body);
+            json.beginObject();
+            json("ok", true);
+            json.key("data");
+            const auto count = state.users->writeJson(json);
+            json("count", static_cast<std::int64_t>(count));
+            json.endObject();
+            json.flush();
+
+            res.header("Content-Type", "application/json");
+            res.send(body); });
 
   app.get("/users/{id}", [state](Request &req, Response &res)
           {
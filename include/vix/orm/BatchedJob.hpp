@@ -0,0 +1,225 @@
+/**
+ *
+ *  @file BatchedJob.hpp
+ *  @author Gaspard Kirira
+ *
+ *  Copyright 2025, Gaspard Kirira.
+ *  All rights reserved.
+ *  https://github.com/vixcpp/vix
+ *
+ *  Use of this source code is governed by a MIT license
+ *  that can be found in the License file.
+ *
+ *  Vix.cpp
+ */
+#ifndef VIX_ORM_BATCHED_JOB_HPP
+#define VIX_ORM_BATCHED_JOB_HPP
+
+#include <vix/orm/db_compat.hpp>
+#include <vix/orm/QueryBuilder.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+
+namespace vix::orm
+{
+  /**
+   * @brief Shared cancellation flag for long-running ORM jobs.
+   *
+   * Copies share the same flag, so one copy can be handed to the job
+   * and another kept by the code that decides to stop it.
+   */
+  class CancellationToken
+  {
+    std::shared_ptr<std::atomic<bool>> flag_ =
+        std::make_shared<std::atomic<bool>>(false);
+
+  public:
+    /**
+     * @brief Request cancellation.
+     */
+    void cancel() const noexcept
+    {
+      flag_->store(true, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Return whether cancellation was requested.
+     */
+    bool cancelled() const noexcept
+    {
+      return flag_->load(std::memory_order_relaxed);
+    }
+  };
+
+  /**
+   * @brief Configuration of a BatchedJob.
+   */
+  struct BatchedJobOptions
+  {
+    /// Table to walk.
+    std::string table;
+
+    /// Integer key column used for keyset ordering.
+    std::string keyColumn = "id";
+
+    /// Number of keys covered by one chunk.
+    std::size_t chunkSize = 1000;
+
+    /// Minimum pause between chunks.
+    std::chrono::milliseconds pause{0};
+
+    /**
+     * @brief Target fraction of wall time spent inside chunks, in (0, 1].
+     *
+     * After a chunk taking W, the job pauses W * (1 - dutyCycle) /
+     * dutyCycle (but at least @ref pause). 0.25 leaves the database
+     * idle three quarters of the time.
+     */
+    double dutyCycle = 1.0;
+
+    /// Optional extra predicate (without WHERE) restricting affected rows.
+    std::optional<QueryBuilder> filter;
+  };
+
+  /**
+   * @brief Progress of a BatchedJob, suitable for checkpointing.
+   */
+  struct BatchedJobProgress
+  {
+    /// Last key processed; resume with BatchedJob::resumeFrom(lastKey).
+    std::int64_t lastKey = 0;
+
+    /// Whether lastKey is meaningful (at least one chunk ran or resumed).
+    bool started = false;
+
+    /// Chunks committed by this run.
+    std::uint64_t chunks = 0;
+
+    /// Rows affected by this run.
+    std::uint64_t rows = 0;
+
+    /// True when the whole key range was processed.
+    bool finished = false;
+  };
+
+  /**
+   * @brief Chunked, throttled background maintenance over a table.
+   *
+   * The job walks the table in key order, @ref BatchedJobOptions::chunkSize
+   * keys at a time. Each chunk [first, last] runs in its own short
+   * transaction, so locks are held briefly and, on SQLite, writers
+   * interleave with live traffic between chunks. After each commit the
+   * checkpoint callback receives the progress, and the job pauses
+   * according to the configured pause and duty cycle.
+   *
+   * Example (purge expired sessions at ~20% duty cycle):
+   * @code
+   * vix::orm::BatchedJobOptions opt;
+   * opt.table = "sessions";
+   * opt.dutyCycle = 0.2;
+   * opt.filter = vix::orm::QueryBuilder("expires_at < ?");
+   * opt.filter->param(now);
+   *
+   * auto job = vix::orm::BatchedJob::purge(pool, opt);
+   * job.resumeFrom(loadCheckpoint());
+   * job.onCheckpoint([](const auto &p) { saveCheckpoint(p.lastKey); });
+   * job.run(token);
+   * @endcode
+   */
+  class BatchedJob
+  {
+  public:
+    /**
+     * @brief Work for one chunk: keys in [first, last], both inclusive.
+     *
+     * The first chunk starts at the smallest int64 value. Runs inside
+     * the chunk transaction and returns the affected rows.
+     */
+    using ChunkFn = std::function<std::uint64_t(vix::db::Connection &conn,
+                                                std::int64_t first,
+                                                std::int64_t last)>;
+
+    /**
+     * @brief Called after each committed chunk.
+     */
+    using CheckpointFn = std::function<void(const BatchedJobProgress &)>;
+
+    /**
+     * @brief Construct a job running @p work for each chunk.
+     *
+     * @throws vix::db::DBError on invalid options, including a table or
+     *         key column that is not a plain identifier.
+     */
+    BatchedJob(vix::db::ConnectionPool &pool, BatchedJobOptions options, ChunkFn work);
+
+    /**
+     * @brief Chunked UPDATE table SET <set> over the key range.
+     *
+     * @param pool Connection pool.
+     * @param options Job options.
+     * @param set SET list without the SET keyword, e.g. "score = score * 2".
+     * @return Configured job.
+     */
+    static BatchedJob update(vix::db::ConnectionPool &pool,
+                             BatchedJobOptions options,
+                             QueryBuilder set);
+
+    /**
+     * @brief Chunked DELETE over the key range.
+     *
+     * Use BatchedJobOptions::filter to restrict which rows are purged.
+     *
+     * @param pool Connection pool.
+     * @param options Job options.
+     * @return Configured job.
+     */
+    static BatchedJob purge(vix::db::ConnectionPool &pool, BatchedJobOptions options);
+
+    /**
+     * @brief Continue after a previously checkpointed key.
+     *
+     * @param lastKey Last key processed by an earlier run.
+     * @return Reference to this job.
+     */
+    BatchedJob &resumeFrom(std::int64_t lastKey);
+
+    /**
+     * @brief Install a checkpoint callback.
+     *
+     * @param fn Callback invoked after every committed chunk.
+     * @return Reference to this job.
+     */
+    BatchedJob &onCheckpoint(CheckpointFn fn);
+
+    /**
+     * @brief Run until the key range is exhausted or cancellation.
+     *
+     * Cancellation is checked before each chunk and during pauses; a
+     * committed chunk is never rolled back by cancellation.
+     *
+     * @param token Cancellation token.
+     * @return Progress of this run.
+     */
+    BatchedJobProgress run(const CancellationToken &token = CancellationToken{});
+
+  private:
+    std::optional<std::int64_t> nextUpperKey(std::optional<std::int64_t> lower);
+    std::chrono::nanoseconds pauseAfter(std::chrono::nanoseconds work) const;
+
+    vix::db::ConnectionPool &pool_;
+    BatchedJobOptions options_;
+    ChunkFn work_;
+    CheckpointFn checkpoint_;
+    std::optional<std::int64_t> resume_;
+  };
+
+} // namespace vix::orm
+
+#endif // VIX_ORM_BATCHED_JOB_HPP
@@ -0,0 +1,224 @@
+/**
+ *
+ *  @file BulkLoadSession.hpp
+ *  @author Gaspard Kirira
+ *
+ *  Copyright 2025, Gaspard Kirira.
+ *  All rights reserved.
+ *  https://github.com/vixcpp/vix
+ *
+ *  Use of this source code is governed by a MIT license
+ *  that can be found in the License file.
+ *
+ *  Vix.cpp
+ */
+#ifndef VIX_ORM_BULK_LOAD_SESSION_HPP
+#define VIX_ORM_BULK_LOAD_SESSION_HPP
+
+#include <vix/orm/db_compat.hpp>
+#include <vix/orm/Dialect.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace vix::orm
+{
+  /**
+   * @brief Configuration of a BulkLoadSession.
+   */
+  struct BulkLoadOptions
+  {
+    /// Tables being loaded; their secondary indexes are dropped.
+    std::vector<std::string> tables;
+
+    /// Defer (SQLite) or disable (MySQL) foreign key checks until commit.
+    bool deferForeignKeys = true;
+
+    /// Drop secondary indexes of @ref tables and rebuild them on commit.
+    bool dropIndexes = true;
+
+    /**
+     * @brief Also drop UNIQUE indexes (SQLite only).
+     *
+     * Duplicates are then detected when the index is rebuilt. MySQL
+     * always keeps unique indexes, see BulkLoadSession.
+     */
+    bool dropUniqueIndexes = false;
+
+    /// SQLite page cache size in KiB for the session; 0 leaves it unchanged.
+    std::int64_t sqliteCacheSizeKiB = 256 * 1024;
+
+    /// SQLite synchronous level for the session; empty leaves it unchanged.
+    std::string sqliteSynchronous = "OFF";
+
+    /// Check foreign keys and table integrity before committing.
+    bool verifyIntegrity = true;
+
+    /**
+     * @brief MySQL table recording dropped indexes until they are rebuilt.
+     *
+     * Created on first use in the current schema. Empty disables the
+     * journal, and a crash then loses the dropped definitions.
+     */
+    std::string mysqlIndexJournal = "vix_orm_bulk_load_indexes";
+  };
+
+  /**
+   * @brief Secondary index dropped for the duration of a session.
+   */
+  struct BulkLoadIndex
+  {
+    std::string table;
+    std::string name;
+
+    /// CREATE INDEX statement (SQLite) or ADD INDEX clause (MySQL).
+    std::string sql;
+
+    bool unique = false;
+  };
+
+  /**
+   * @brief Scoped session relaxing constraints and indexes for a large load.
+   *
+   * The session pins one pooled connection and opens a transaction on
+   * it. Load rows through conn(); other pooled connections do not see
+   * the session (and on SQLite block on its write lock).
+   *
+   * On SQLite the session lowers synchronous and raises cache_size,
+   * sets defer_foreign_keys, and drops secondary indexes inside the
+   * transaction. commit() recreates the indexes, runs
+   * foreign_key_check and integrity_check on the tables, commits, and
+   * restores the pragmas. Since SQLite DDL is transactional, any
+   * failure rolls back data and index changes together.
+   *
+   * On MySQL DDL commits implicitly, so non-unique secondary indexes
+   * not backing a foreign key are dropped before the transaction
+   * starts and recreated with one ALTER TABLE per table after the data
+   * commit. Unique indexes are kept so the rebuild cannot fail on data;
+   * a rebuild failure after the commit leaves the data committed.
+   * foreign_key_checks is disabled for the session, and orphan rows are
+   * searched for before committing. Rollback recreates the dropped
+   * indexes. Because the drop is committed before the load, a process
+   * that dies mid-session leaves the indexes missing; their definitions
+   * are written to BulkLoadOptions::mysqlIndexJournal first, and the
+   * next session on the same tables, or recoverIndexes(), recreates
+   * them.
+   *
+   * Other engines only get the transaction.
+   *
+   * Destroying an uncommitted session rolls it back.
+   *
+   * Example:
+   * @code
+   * vix::orm::BulkLoadOptions opt;
+   * opt.tables = {"orders", "order_items"};
+   *
+   * vix::orm::BulkLoadSession session(pool, opt);
+   * loadOrders(session.conn());
+   * session.commit();
+   * @endcode
+   */
+  class BulkLoadSession
+  {
+  public:
+    /**
+     * @brief Acquire a connection, relax settings and begin the session.
+     *
+     * @throws vix::db::DBError on invalid options or database errors;
+     *         partial changes are undone first.
+     */
+    BulkLoadSession(vix::db::ConnectionPool &pool, BulkLoadOptions options);
+
+    ~BulkLoadSession();
+
+    BulkLoadSession(const BulkLoadSession &) = delete;
+    BulkLoadSession &operator=(const BulkLoadSession &) = delete;
+
+    /**
+     * @brief Connection holding the session transaction.
+     */
+    vix::db::Connection &conn()
+    {
+      return conn_.get();
+    }
+
+    /**
+     * @brief Detected engine of the session connection.
+     */
+    const DialectInfo &dialect() const noexcept
+    {
+      return dialect_;
+    }
+
+    /**
+     * @brief Indexes dropped by this session.
+     */
+    const std::vector<BulkLoadIndex> &droppedIndexes() const noexcept
+    {
+      return dropped_;
+    }
+
+    /**
+     * @brief Return whether the session is neither committed nor rolled back.
+     */
+    [[nodiscard]] bool active() const noexcept
+    {
+      return active_;
+    }
+
+    /**
+     * @brief Rebuild indexes, verify integrity, commit and restore settings.
+     *
+     * @throws vix::db::DBError when verification or the commit fails;
+     *         the session is rolled back before rethrowing.
+     */
+    void commit();
+
+    /**
+     * @brief Discard the load and restore indexes and settings.
+     */
+    void rollback() noexcept;
+
+    /**
+     * @brief Recreate MySQL indexes left dropped by a session that died.
+     *
+     * Indexes listed in the journal that already exist are only
+     * removed from it. Other engines are left untouched.
+     *
+     * @param pool Pool of the database.
+     * @param journal Journal table, see BulkLoadOptions::mysqlIndexJournal.
+     * @return Number of indexes recreated.
+     * @throws vix::db::DBError on database errors.
+     */
+    static std::size_t recoverIndexes(vix::db::ConnectionPool &pool,
+                                      const std::string &journal = "vix_orm_bulk_load_indexes");
+
+  private:
+    void relaxSettings();
+    void restoreSettings() noexcept;
+    void dropIndexes();
+    void rebuildIndexes();
+    void verify();
+    void undo() noexcept;
+
+    vix::db::PooledConn conn_;
+    BulkLoadOptions options_;
+    DialectInfo dialect_;
+    std::vector<BulkLoadIndex> dropped_;
+
+    /// Dropped indexes not recreated yet, outside any transaction (MySQL).
+    std::vector<BulkLoadIndex> missing_;
+
+    std::optional<std::int64_t> savedCacheSize_;
+    std::optional<std::int64_t> savedSynchronous_;
+    std::optional<std::int64_t> savedForeignKeyChecks_;
+    bool inTransaction_ = false;
+    bool active_ = false;
+  };
+
+} // namespace vix::orm
+
+#endif // VIX_ORM_BULK_LOAD_SESSION_HPP
@@ -0,0 +1,279 @@
+/**
+ *
+ *  @file Columnar.hpp
+ *  @author Gaspard Kirira
+ *
+ *  Copyright 2025, Gaspard Kirira.
+ *  All rights reserved.
+ *  https://github.com/vixcpp/vix
+ *
+ *  Use of this source code is governed by a MIT license
+ *  that can be found in the License file.
+ *
+ *  Vix.cpp
+ */
+#ifndef VIX_ORM_COLUMNAR_HPP
+#define VIX_ORM_COLUMNAR_HPP
+
+#include <vix/orm/db_compat.hpp>
+#include <vix/orm/RowView.hpp>
+#include <vix/orm/TypedQuery.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace vix::orm
+{
+  /**
+   * @brief One bit per row, set when the value is NULL.
+   */
+  class NullBitmap
+  {
+    std::vector<std::uint64_t> words_;
+    std::size_t size_ = 0;
+    std::size_t nulls_ = 0;
+
+  public:
+    std::size_t size() const noexcept { return size_; }
+    std::size_t nullCount() const noexcept { return nulls_; }
+    bool anyNull() const noexcept { return nulls_ != 0; }
+
+    /**
+     * @brief Packed bit words; bit (i % 64) of word (i / 64) is row i.
+     */
+    std::span<const std::uint64_t> words() const noexcept { return words_; }
+
+    bool isNull(std::size_t row) const noexcept
+    {
+      return (words_[row / 64] >> (row % 64)) & 1u;
+    }
+
+    void reserve(std::size_t rows)
+    {
+      words_.reserve((rows + 63) / 64);
+    }
+
+    void push_back(bool null)
+    {
+      if (size_ % 64 == 0)
+      {
+        words_.push_back(0);
+      }
+
+      if (null)
+      {
+        words_.back() |= std::uint64_t{1} << (size_ % 64);
+        ++nulls_;
+      }
+      ++size_;
+    }
+  };
+
+  /**
+   * @brief Contiguous values of one numeric column.
+   *
+   * NULL rows hold a zero value and are flagged in @ref nulls. bool
+   * columns are stored as std::uint8_t to stay contiguous.
+   *
+   * @tparam V Arithmetic member type.
+   */
+  template <class V>
+  struct ColumnData
+  {
+    static_assert(std::is_arithmetic_v<V>,
+                  "vix::orm::ColumnData: unsupported column value type");
+
+    using value_type = std::conditional_t<std::is_same_v<V, bool>, std::uint8_t, V>;
+
+    std::vector<value_type> values;
+    NullBitmap nulls;
+
+    std::size_t size() const noexcept { return values.size(); }
+    std::span<const value_type> data() const noexcept { return values; }
+    value_type operator[](std::size_t row) const noexcept { return values[row]; }
+
+    void reserve(std::size_t rows)
+    {
+      values.reserve(rows);
+      nulls.reserve(rows);
+    }
+
+    void append(const RowView &row, std::size_t index)
+    {
+      const bool null = row.isNull(index);
+      nulls.push_back(null);
+
+      if (null)
+      {
+        values.push_back(value_type{});
+      }
+      else if constexpr (std::is_floating_point_v<V>)
+      {
+        values.push_back(static_cast<value_type>(row.getDouble(index)));
+      }
+      else
+      {
+        values.push_back(static_cast<value_type>(row.getInt64(index)));
+      }
+    }
+  };
+
+  /**
+   * @brief Text column stored as one arena plus row offsets.
+   *
+   * Row i spans arena[offsets[i], offsets[i + 1]). NULL rows are empty
+   * and flagged in @ref nulls. Rows share the arena instead of owning
+   * one std::string each.
+   */
+  template <>
+  struct ColumnData<std::string>
+  {
+    using value_type = std::string_view;
+
+    std::string arena;
+    std::vector<std::size_t> offsets{0};
+    NullBitmap nulls;
+
+    std::size_t size() const noexcept { return offsets.size() - 1; }
+
+    std::string_view operator[](std::size_t row) const noexcept
+    {
+      return std::string_view(arena).substr(offsets[row], offsets[row + 1] - offsets[row]);
+    }
+
+    void reserve(std::size_t rows)
+    {
+      offsets.reserve(rows + 1);
+      nulls.reserve(rows);
+    }
+
+    void append(const RowView &row, std::size_t index)
+    {
+      const bool null = row.isNull(index);
+      nulls.push_back(null);
+
+      if (!null)
+      {
+        arena.append(row.getText(index));
+      }
+      offsets.push_back(arena.size());
+    }
+  };
+
+  namespace detail
+  {
+    template <auto A, auto B>
+    constexpr bool same_member() noexcept
+    {
+      if constexpr (std::is_same_v<decltype(A), decltype(B)>)
+      {
+        return A == B;
+      }
+      else
+      {
+        return false;
+      }
+    }
+
+    /**
+     * @brief Position of member @p M in @p Ms, or sizeof...(Ms).
+     */
+    template <auto M, auto... Ms>
+    constexpr std::size_t member_index() noexcept
+    {
+      std::size_t index = 0;
+      std::size_t found = sizeof...(Ms);
+      ((found = (found == sizeof...(Ms) && same_member<M, Ms>()) ? index : found, ++index), ...);
+      return found;
+    }
+
+    template <auto Member>
+    using column_data_t = ColumnData<column_value_t<member_value_t<Member>>>;
+  } // namespace detail
+
+  /**
+   * @brief Struct-of-arrays result: one contiguous array per column.
+   *
+   * Numeric columns are plain vectors, text columns use an arena with
+   * offsets, and every column carries a NULL bitmap. Scans over a
+   * single column touch only that column's memory, and tight loops
+   * over data() are straightforward for compilers to vectorize.
+   *
+   * Example:
+   * @code
+   * auto cols = orders.findAllColumnar<&Order::total, &Order::status>();
+   * double sum = 0;
+   * for (double v : cols.column<&Order::total>().data())
+   *   sum += v;
+   * @endcode
+   *
+   * @tparam Members Pointers to data members of the same entity.
+   */
+  template <auto... Members>
+  class Columnar
+  {
+    static_assert(sizeof...(Members) > 0, "vix::orm::Columnar: no columns");
+
+    std::tuple<detail::column_data_t<Members>...> columns_;
+    std::size_t rows_ = 0;
+
+  public:
+    /**
+     * @brief Number of rows.
+     */
+    std::size_t size() const noexcept { return rows_; }
+    bool empty() const noexcept { return rows_ == 0; }
+
+    /**
+     * @brief Column by position in the template argument list.
+     */
+    template <std::size_t I>
+    const auto &get() const noexcept
+    {
+      return std::get<I>(columns_);
+    }
+
+    /**
+     * @brief Column by member pointer.
+     */
+    template <auto Member>
+    const auto &column() const noexcept
+    {
+      constexpr std::size_t index = detail::member_index<Member, Members...>();
+      static_assert(index < sizeof...(Members), "vix::orm::Columnar: column not selected");
+      return std::get<index>(columns_);
+    }
+
+    void reserve(std::size_t rows)
+    {
+      std::apply([rows](auto &...c)
+                 { (c.reserve(rows), ...); }, columns_);
+    }
+
+    /**
+     * @brief Append one row whose columns are in template argument order.
+     */
+    void append(const RowView &row)
+    {
+      appendImpl(row, std::index_sequence_for<decltype(Members)...>{});
+      ++rows_;
+    }
+
+  private:
+    template <std::size_t... I>
+    void appendImpl(const RowView &row, std::index_sequence<I...>)
+    {
+      (std::get<I>(columns_).append(row, I), ...);
+    }
+  };
+
+} // namespace vix::orm
+
+#endif // VIX_ORM_COLUMNAR_HPP
@@ -0,0 +1,107 @@
+/**
+ *
+ *  @file Dialect.hpp
+ *  @author Gaspard Kirira
+ *
+ *  Copyright 2025, Gaspard Kirira.
+ *  All rights reserved.
+ *  https://github.com/vixcpp/vix
+ *
+ *  Use of this source code is governed by a MIT license
+ *  that can be found in the License file.
+ *
+ *  Vix.cpp
+ */
+#ifndef VIX_ORM_DIALECT_HPP
+#define VIX_ORM_DIALECT_HPP
+
+#include <vix/orm/db_compat.hpp>
+
+#include <string_view>
+
+namespace vix::orm
+{
+  /**
+   * @brief SQL engine family behind a connection.
+   */
+  enum class Dialect
+  {
+    Unknown,
+    SQLite,
+    MySQL
+  };
+
+  /**
+   * @brief Engine family and server version.
+   *
+   * Used by repositories to pick engine-specific SQL (RETURNING clauses,
+   * catalog queries, ...) while keeping a portable fallback.
+   */
+  struct DialectInfo
+  {
+    Dialect kind = Dialect::Unknown;
+    int major = 0;
+    int minor = 0;
+    int patch = 0;
+    bool mariadb = false;
+
+    /**
+     * @brief Return whether the server version is at least the given one.
+     */
+    bool atLeast(int maj, int min, int pat = 0) const noexcept
+    {
+      if (major != maj)
+        return major > maj;
+      if (minor != min)
+        return minor > min;
+      return patch >= pat;
+    }
+
+    /**
+     * @brief Return whether INSERT ... RETURNING is supported.
+     *
+     * SQLite 3.35+ and MariaDB 10.5+.
+     */
+    bool supportsInsertReturning() const noexcept
+    {
+      return (kind == Dialect::SQLite && atLeast(3, 35)) ||
+             (kind == Dialect::MySQL && mariadb && atLeast(10, 5));
+    }
+
+    /**
+     * @brief Return whether UPDATE/DELETE ... RETURNING is supported.
+     *
+     * SQLite 3.35+ only.
+     */
+    bool supportsUpdateReturning() const noexcept
+    {
+      return kind == Dialect::SQLite && atLeast(3, 35);
+    }
+  };
+
+  /**
+   * @brief Parse a dotted server version string into @p info.
+   *
+   * Parsing stops at the first character that is neither a digit nor
+   * a dot, so "10.11.2-MariaDB" yields 10.11.2.
+   *
+   * @param version Version string reported by the server.
+   * @param info Target dialect info.
+   */
+  void parse_server_version(std::string_view version, DialectInfo &info) noexcept;
+
+  /**
+   * @brief Detect the engine family and version behind a connection.
+   *
+   * Probes with SELECT sqlite_version(), then SELECT VERSION(). Probe
+   * failures are swallowed; an unrecognized engine yields
+   * Dialect::Unknown, for which callers use portable SQL only.
+   *
+   * @param conn Database connection.
+   * @return Detected dialect.
+   */
+  DialectInfo detect_dialect(vix::db::Connection &conn);
+
+} // namespace vix::orm
+
+#endif // VIX_ORM_DIALECT_HPP
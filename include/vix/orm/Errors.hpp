@@ -0,0 +1,77 @@
+/**
+ *
+ *  @file Errors.hpp
+ *  @author Gaspard Kirira
+ *
+ *  Copyright 2025, Gaspard Kirira.
+ *  All rights reserved.
+ *  https://github.com/vixcpp/vix
+ *
+ *  Use of this source code is governed by a MIT license
+ *  that can be found in the License file.
+ *
+ *  Vix.cpp
+ */
+#ifndef VIX_ORM_ERRORS_HPP
+#define VIX_ORM_ERRORS_HPP
+
+#include <vix/orm/db_compat.hpp>
+
+#include <cstdint>
+#include <string>
+#include <utility>
+
+namespace vix::orm
+{
+  /**
+   * @brief Raised when a versioned update finds a newer row version.
+   *
+   * The row exists, but its version column no longer matches the
+   * version carried by the entity: another writer updated it first.
+   * Callers typically reload the entity and retry.
+   */
+  class OptimisticLockError : public vix::db::DBError
+  {
+    std::string table_;
+    std::int64_t id_;
+    std::int64_t expectedVersion_;
+
+  public:
+    OptimisticLockError(std::string table, std::int64_t id, std::int64_t expectedVersion)
+        : vix::db::DBError("ORM: optimistic lock conflict on " + table +
+                           " id=" + std::to_string(id) +
+                           " expected version=" + std::to_string(expectedVersion)),
+          table_(std::move(table)),
+          id_(id),
+          expectedVersion_(expectedVersion)
+    {
+    }
+
+    /**
+     * @brief Table of the conflicting row.
+     */
+    const std::string &table() const noexcept
+    {
+      return table_;
+    }
+
+    /**
+     * @brief Primary key of the conflicting row.
+     */
+    std::int64_t id() const noexcept
+    {
+      return id_;
+    }
+
+    /**
+     * @brief Version the update expected to find.
+     */
+    std::int64_t expectedVersion() const noexcept
+    {
+      return expectedVersion_;
+    }
+  };
+
+} // namespace vix::orm
+
+#endif // VIX_ORM_ERRORS_HPP
@@ -0,0 +1,215 @@
+/**
+ *
+ *  @file Export.hpp
+ *  @author Gaspard Kirira
+ *
+ *  Copyright 2025, Gaspard Kirira.
+ *  All rights reserved.
+ *  https://github.com/vixcpp/vix
+ *
+ *  Use of this source code is governed by a MIT license
+ *  that can be found in the License file.
+ *
+ *  Vix.cpp
+ */
+#ifndef VIX_ORM_EXPORT_HPP
+#define VIX_ORM_EXPORT_HPP
+
+#include <vix/orm/db_compat.hpp>
+#include <vix/orm/QueryBuilder.hpp>
+#include <vix/orm/Repository.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iosfwd>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace vix::orm
+{
+  /**
+   * @brief Output encoding of an export.
+   */
+  enum class ExportFormat
+  {
+    NDJSON,
+    CSV
+  };
+
+  /**
+   * @brief How a column is read and encoded.
+   *
+   * vix::db::ResultRow carries no type information, so exported columns
+   * declare it. Text is always safe; Integer, Real and Boolean produce
+   * JSON numbers and booleans in NDJSON.
+   */
+  enum class ExportType
+  {
+    Text,
+    Integer,
+    Real,
+    Boolean
+  };
+
+  /**
+   * @brief One exported column.
+   */
+  struct ExportColumn
+  {
+    std::string name;
+    ExportType type = ExportType::Text;
+  };
+
+  /**
+   * @brief Receives encoded output in buffer-sized chunks.
+   */
+  using ExportSink = std::function<void(std::string_view)>;
+
+  /**
+   * @brief Sink writing to a file descriptor (retries partial writes).
+   *
+   * @throws vix::db::DBError when the write fails.
+   */
+  ExportSink fd_sink(int fd);
+
+  /**
+   * @brief Sink writing to an output stream.
+   */
+  ExportSink stream_sink(std::ostream &out);
+
+  /**
+   * @brief Sink owning a newly created (truncated) file.
+   *
+   * @throws vix::db::DBError when the file cannot be opened.
+   */
+  ExportSink file_sink(const std::string &path);
+
+  /**
+   * @brief Progress of an export, suitable for checkpointing.
+   */
+  struct ExportProgress
+  {
+    /// Rows written so far.
+    std::uint64_t rows = 0;
+
+    /// Last key written; resume with ExportOptions::resumeAfter.
+    std::optional<std::int64_t> lastKey;
+  };
+
+  /**
+   * @brief Export configuration.
+   */
+  struct ExportOptions
+  {
+    ExportFormat format = ExportFormat::NDJSON;
+
+    /// Columns to export, in output order (required).
+    std::vector<ExportColumn> columns;
+
+    /// Integer key column used for keyset chunking.
+    std::string keyColumn = "id";
+
+    /// Rows fetched per keyset query.
+    std::size_t chunkRows = 10000;
+
+    /// Output buffer size; the sink receives chunks of about this size.
+    std::size_t bufferSize = 64 * 1024;
+
+    /// Write a CSV header line (not on resumed exports).
+    bool csvHeader = true;
+
+    char csvDelimiter = ',';
+
+    /// Only export keys greater than this (resumption).
+    std::optional<std::int64_t> resumeAfter;
+
+    /// Only export keys up to and including this.
+    std::optional<std::int64_t> until;
+
+    /// Optional extra predicate (without WHERE).
+    std::optional<QueryBuilder> filter;
+
+    /// Called after each chunk has been handed to the sink.
+    std::function<void(const ExportProgress &)> onChunk;
+  };
+
+  /**
+   * @brief Stream a table as NDJSON or CSV with bounded memory.
+   *
+   * Rows are read in keyset order with one short query per
+   * ExportOptions::chunkRows rows (WHERE key > ? ORDER BY key LIMIT n),
+   * encoded straight from the live result set into a fixed-size
+   * buffer, and handed to the sink whenever the buffer fills. Neither
+   * a long-running read transaction nor the full result set is held.
+   * After an interruption, pass the last checkpointed key as
+   * ExportOptions::resumeAfter and append to the same output.
+   *
+   * Example:
+   * @code
+   * vix::orm::ExportOptions opt;
+   * opt.columns = {{"id", vix::orm::ExportType::Integer}, {"email"}};
+   * opt.onChunk = [](const auto &p) { saveCheckpoint(*p.lastKey); };
+   * vix::orm::exportTable(pool, "users", vix::orm::file_sink("users.ndjson"), opt);
+   * @endcode
+   *
+   * @return Final progress.
+   */
+  ExportProgress exportTable(vix::db::ConnectionPool &pool,
+                             std::string_view table,
+                             const ExportSink &sink,
+                             const ExportOptions &options);
+
+  /**
+   * @brief Stream a repository's table; see the pool overload.
+   */
+  template <class T>
+  ExportProgress exportTable(BaseRepository<T> &repo,
+                             const ExportSink &sink,
+                             const ExportOptions &options)
+  {
+    return exportTable(repo.pool(), repo.table(), sink, options);
+  }
+
+  /**
+   * @brief Stream the result of an arbitrary query in one pass.
+   *
+   * The query's select list must match ExportOptions::columns in
+   * order. Keyset options (keyColumn, chunkRows, resumeAfter, until,
+   * filter) do not apply.
+   *
+   * @return Final progress (lastKey is empty).
+   */
+  ExportProgress exportQuery(vix::db::ConnectionPool &pool,
+                             const QueryBuilder &query,
+                             const ExportSink &sink,
+                             const ExportOptions &options);
+
+  /**
+   * @brief Export a table as @p partitions key ranges on parallel threads.
+   *
+   * The key range [MIN(key), MAX(key)] (narrowed by resumeAfter and
+   * until) is split into slices of about equal width, the last one
+   * taking the remainder, each exported on its own thread and pool
+   * connection into the sink returned by makeSink(index), typically a
+   * file_sink per partition. makeSink is called
+   * concurrently from the partition threads and must be thread-safe;
+   * each returned sink is used by its own thread only. Each CSV
+   * partition gets its own header. onChunk is not called.
+   *
+   * @return Combined progress (lastKey is the global upper key).
+   *
+   * @throws The first error raised by any partition, after all threads
+   *         have finished.
+   */
+  ExportProgress exportPartitioned(vix::db::ConnectionPool &pool,
+                                   std::string_view table,
+                                   std::size_t partitions,
+                                   const std::function<ExportSink(std::size_t)> &makeSink,
+                                   const ExportOptions &options);
+
+} // namespace vix::orm
+
+#endif // VIX_ORM_EXPORT_HPP
@@ -0,0 +1,419 @@
+/**
+ *
+ *  @file Fingerprint.hpp
+ *  @author Gaspard Kirira
+ *
+ *  Copyright 2025, Gaspard Kirira.
+ *  All rights reserved.
+ *  https://github.com/vixcpp/vix
+ *
+ *  Use of this source code is governed by a MIT license
+ *  that can be found in the License file.
+ *
+ *  Vix.cpp
+ */
+#ifndef VIX_ORM_FINGERPRINT_HPP
+#define VIX_ORM_FINGERPRINT_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace vix::orm
+{
+  namespace detail
+  {
+    /**
+     * @brief 64-bit FNV-1a offset basis.
+     */
+    inline constexpr std::uint64_t fnv1a_basis = 14695981039346656037ull;
+
+    /**
+     * @brief 64-bit FNV-1a prime.
+     */
+    inline constexpr std::uint64_t fnv1a_prime = 1099511628211ull;
+
+    /**
+     * @brief Feed bytes into a running 64-bit FNV-1a hash.
+     *
+     * @param h Current hash state.
+     * @param s Bytes to hash.
+     * @return Updated hash state.
+     */
+    constexpr std::uint64_t fnv1a_update(std::uint64_t h,
+                                         std::string_view s) noexcept
+    {
+      for (char c : s)
+      {
+        h ^= static_cast<std::uint8_t>(c);
+        h *= fnv1a_prime;
+      }
+      return h;
+    }
+  } // namespace detail
+
+  /**
+   * @brief Incremental fingerprint of a normalized SQL statement.
+   *
+   * The fingerprint is a stable 64-bit hash of the statement's token
+   * stream after normalization:
+   * - whitespace and comments are ignored
+   * - unquoted words are lowercased
+   * - string and numeric literals become '?'
+   * - comma-separated runs of values collapse to a single '?',
+   *   so IN (1, 2, 3) and IN (?, ?) share a fingerprint
+   *
+   * SQL can be fed in arbitrary fragments; tokens split across feed()
+   * calls are handled. value() does not consume state, so more SQL may
+   * be fed afterwards.
+   *
+   * Normalization deliberately maps different statements to the same
+   * value ('a' vs 'b', IN (?, ?) vs IN (?, ?, ?), LIMIT ?, ? vs
+   * LIMIT ?). Use it to group statements in statistics and logs only,
+   * never as a prepared-statement cache key.
+   *
+   * Everything is constexpr, so compile-time statements report the same
+   * fingerprint as runtime-built ones.
+   */
+  class SqlFingerprint
+  {
+    enum class State : std::uint8_t
+    {
+      Space,
+      Word,
+      Number,
+      Quoted,
+      QuotedMaybeEnd,
+      Dash,
+      Slash,
+      LineComment,
+      BlockComment,
+      BlockCommentStar
+    };
+
+    enum class Tail : std::uint8_t
+    {
+      Other,
+      Value,
+      ValueComma
+    };
+
+    static constexpr char delimiter = '\x1f';
+
+    std::uint64_t hash_ = detail::fnv1a_basis;
+    State state_ = State::Space;
+    Tail tail_ = Tail::Other;
+    char quote_ = 0;
+
+    static constexpr bool isSpace(char c) noexcept
+    {
+      return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' || c == '\v';
+    }
+
+    static constexpr bool isDigit(char c) noexcept
+    {
+      return c >= '0' && c <= '9';
+    }
+
+    static constexpr bool isWordStart(char c) noexcept
+    {
+      return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_' ||
+             static_cast<unsigned char>(c) >= 0x80;
+    }
+
+    static constexpr bool isWordChar(char c) noexcept
+    {
+      return isWordStart(c) || isDigit(c) || c == '$';
+    }
+
+    static constexpr char lower(char c) noexcept
+    {
+      return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+    }
+
+    constexpr void put(char c) noexcept
+    {
+      hash_ ^= static_cast<std::uint8_t>(c);
+      hash_ *= detail::fnv1a_prime;
+    }
+
+    constexpr void flushComma() noexcept
+    {
+      if (tail_ == Tail::ValueComma)
+      {
+        put(',');
+        put(delimiter);
+      }
+      tail_ = Tail::Other;
+    }
+
+    constexpr void emitValue() noexcept
+    {
+      if (tail_ == Tail::ValueComma)
+      {
+        tail_ = Tail::Value;
+        return;
+      }
+
+      flushComma();
+      put('?');
+      put(delimiter);
+      tail_ = Tail::Value;
+    }
+
+    constexpr void emitPunct(char c) noexcept
+    {
+      if (c == ',' && tail_ == Tail::Value)
+      {
+        tail_ = Tail::ValueComma;
+        return;
+      }
+
+      flushComma();
+      put(c);
+      put(delimiter);
+    }
+
+    constexpr void endToken() noexcept
+    {
+      switch (state_)
+      {
+      case State::Word:
+        put(delimiter);
+        break;
+      case State::Number:
+        emitValue();
+        break;
+      case State::QuotedMaybeEnd:
+        if (quote_ == '\'')
+        {
+          emitValue();
+        }
+        else
+        {
+          put(quote_);
+          put(delimiter);
+        }
+        break;
+      case State::Dash:
+        emitPunct('-');
+        break;
+      case State::Slash:
+        emitPunct('/');
+        break;
+      default:
+        break;
+      }
+
+      state_ = State::Space;
+    }
+
+    constexpr void process(char c) noexcept
+    {
+      switch (state_)
+      {
+      case State::Word:
+        if (isWordChar(c))
+        {
+          put(lower(c));
+          return;
+        }
+        endToken();
+        break;
+
+      case State::Number:
+        if (isWordChar(c) || c == '.')
+        {
+          return;
+        }
+        endToken();
+        break;
+
+      case State::Quoted:
+        if (c == quote_)
+        {
+          state_ = State::QuotedMaybeEnd;
+        }
+        else if (quote_ != '\'')
+        {
+          put(c);
+        }
+        return;
+
+      case State::QuotedMaybeEnd:
+        if (c == quote_)
+        {
+          state_ = State::Quoted;
+          if (quote_ != '\'')
+          {
+            put(c);
+          }
+          return;
+        }
+        endToken();
+        break;
+
+      case State::Dash:
+        if (c == '-')
+        {
+          state_ = State::LineComment;
+          return;
+        }
+        endToken();
+        break;
+
+      case State::Slash:
+        if (c == '*')
+        {
+          state_ = State::BlockComment;
+          return;
+        }
+        endToken();
+        break;
+
+      case State::LineComment:
+        if (c == '\n')
+        {
+          state_ = State::Space;
+        }
+        return;
+
+      case State::BlockComment:
+        if (c == '*')
+        {
+          state_ = State::BlockCommentStar;
+        }
+        return;
+
+      case State::BlockCommentStar:
+        if (c == '/')
+        {
+          state_ = State::Space;
+        }
+        else if (c != '*')
+        {
+          state_ = State::BlockComment;
+        }
+        return;
+
+      case State::Space:
+        break;
+      }
+
+      if (isSpace(c))
+      {
+        return;
+      }
+
+      if (isWordStart(c))
+      {
+        flushComma();
+        put(lower(c));
+        state_ = State::Word;
+      }
+      else if (isDigit(c))
+      {
+        state_ = State::Number;
+      }
+      else if (c == '\'' || c == '"' || c == '`')
+      {
+        if (c != '\'')
+        {
+          flushComma();
+          put(c);
+        }
+        quote_ = c;
+        state_ = State::Quoted;
+      }
+      else if (c == '-')
+      {
+        state_ = State::Dash;
+      }
+      else if (c == '/')
+      {
+        state_ = State::Slash;
+      }
+      else if (c == '?')
+      {
+        emitValue();
+      }
+      else
+      {
+        emitPunct(c);
+      }
+    }
+
+  public:
+    /**
+     * @brief Feed an SQL fragment.
+     *
+     * @param sql SQL fragment.
+     */
+    constexpr void feed(std::string_view sql) noexcept
+    {
+      const std::size_t n = sql.size();
+      std::size_t i = 0;
+
+      while (i < n)
+      {
+        // Words and blanks make up most SQL: consume their runs directly.
+        if (state_ == State::Word)
+        {
+          while (i < n && isWordChar(sql[i]))
+          {
+            put(lower(sql[i++]));
+          }
+        }
+        else if (state_ == State::Space)
+        {
+          while (i < n && isSpace(sql[i]))
+          {
+            ++i;
+          }
+        }
+
+        if (i < n)
+        {
+          process(sql[i++]);
+        }
+      }
+    }
+
+    /**
+     * @brief Return the fingerprint of everything fed so far.
+     *
+     * @return 64-bit fingerprint.
+     */
+    constexpr std::uint64_t value() const noexcept
+    {
+      SqlFingerprint copy = *this;
+      copy.endToken();
+      copy.flushComma();
+      return copy.hash_;
+    }
+
+    /**
+     * @brief Reset to the empty statement.
+     */
+    constexpr void reset() noexcept
+    {
+      *this = SqlFingerprint{};
+    }
+  };
+
+  /**
+   * @brief Fingerprint a complete SQL statement.
+   *
+   * @param sql SQL text.
+   * @return 64-bit fingerprint.
+   */
+  constexpr std::uint64_t sql_fingerprint(std::string_view sql) noexcept
+  {
+    SqlFingerprint fp;
+    fp.feed(sql);
+    return fp.value();
+  }
+
+} // namespace vix::orm
+
+#endif // VIX_ORM_FINGERPRINT_HPP
@@ -0,0 +1,189 @@
+/**
+ *
+ *  @file IdGenerator.hpp
+ *  @author Gaspard Kirira
+ *
+ *  Copyright 2025, Gaspard Kirira.
+ *  All rights reserved.
+ *  https://github.com/vixcpp/vix
+ *
+ *  Use of this source code is governed by a MIT license
+ *  that can be found in the License file.
+ *
+ *  Vix.cpp
+ */
+#ifndef VIX_ORM_ID_GENERATOR_HPP
+#define VIX_ORM_ID_GENERATOR_HPP
+
+#include <vix/orm/db_compat.hpp>
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+namespace vix::orm
+{
+  /**
+   * @brief Client-side primary key generator.
+   *
+   * Generators let entities receive their id before insertion, so
+   * parent/child graphs can be written in batched statements without a
+   * round trip per parent to learn lastInsertId().
+   *
+   * Implementations must be thread-safe.
+   */
+  class IdGenerator
+  {
+  public:
+    virtual ~IdGenerator() = default;
+
+    /**
+     * @brief Return a new unique identifier.
+     *
+     * @return Positive identifier.
+     */
+    virtual std::int64_t next() = 0;
+  };
+
+  /**
+   * @brief Time-ordered 64-bit ids (snowflake layout).
+   *
+   * Layout, from most to least significant bit:
+   * - 1 bit unused (ids stay positive)
+   * - 41 bits milliseconds since the generator epoch
+   * - 10 bits node id
+   * - 12 bits per-millisecond sequence
+   *
+   * Each process (or shard) writing to the same table must use a
+   * distinct node id. Up to 4096 ids per millisecond per node; beyond
+   * that the generator waits for the next millisecond. If the clock
+   * goes backwards, the last observed timestamp is kept. A clock before
+   * the epoch, or more than 2^41 ms after it, makes next() throw.
+   */
+  class SnowflakeIdGenerator final : public IdGenerator
+  {
+  public:
+    static constexpr int node_bits = 10;
+    static constexpr int sequence_bits = 12;
+    static constexpr std::uint32_t max_node_id = (1u << node_bits) - 1;
+
+    /**
+     * @brief Default epoch: 2024-01-01T00:00:00Z in milliseconds.
+     */
+    static constexpr std::int64_t default_epoch_ms = 1704067200000;
+
+    /**
+     * @brief Construct a generator for a node.
+     *
+     * @param nodeId Node identifier in [0, max_node_id].
+     * @param epochMs Custom epoch in Unix milliseconds.
+     *
+     * @throws vix::db::DBError if @p nodeId is out of range.
+     */
+    explicit SnowflakeIdGenerator(std::uint32_t nodeId,
+                                  std::int64_t epochMs = default_epoch_ms);
+
+    /**
+     * @throws vix::db::DBError if the clock is outside the 41-bit range
+     *         starting at the epoch.
+     */
+    std::int64_t next() override;
+
+    /**
+     * @brief Return the node identifier.
+     */
+    std::uint32_t nodeId() const noexcept
+    {
+      return nodeId_;
+    }
+
+  private:
+    std::mutex mutex_;
+    std::uint32_t nodeId_;
+    std::int64_t epochMs_;
+    std::int64_t lastMs_ = -1;
+    std::uint32_t sequence_ = 0;
+  };
+
+  /**
+   * @brief Hi/lo block allocation from a sequence table.
+   *
+   * Each block reservation increments a counter row in @p table inside
+   * a short transaction and yields @p blockSize ids that are then
+   * handed out from memory. Multiple processes can share a sequence
+   * safely; ids are unique but only ordered within a block.
+   *
+   * A new sequence starts at id 1. When adopting hi/lo for a table
+   * that already has rows, call ensureAbove() with its MAX(id) so new
+   * ids cannot collide with existing ones:
+   * @code
+   * auto ids = std::make_shared<vix::orm::HiLoIdGenerator>(pool, "users");
+   * ids->ensureAbove(users.max<&User::id>().value_or(0));
+   * users.setIdGenerator(ids);
+   * @endcode
+   *
+   * The sequence table is created on first use when missing:
+   * @code
+   * CREATE TABLE IF NOT EXISTS vix_orm_sequences (
+   *   name VARCHAR(191) NOT NULL PRIMARY KEY,
+   *   next_hi BIGINT NOT NULL)
+   * @endcode
+   */
+  class HiLoIdGenerator final : public IdGenerator
+  {
+  public:
+    /**
+     * @brief Construct a hi/lo generator.
+     *
+     * @param pool Connection pool used for block reservations.
+     * @param sequence Sequence name, typically the entity table name.
+     * @param blockSize Number of ids per reserved block.
+     * @param table Sequence table name.
+     *
+     * @throws vix::db::DBError if @p sequence is empty or @p blockSize is 0.
+     */
+    HiLoIdGenerator(vix::db::ConnectionPool &pool,
+                    std::string sequence,
+                    std::uint32_t blockSize = 1000,
+                    std::string table = "vix_orm_sequences");
+
+    std::int64_t next() override;
+
+    /**
+     * @brief Guarantee that later ids are greater than @p floor.
+     *
+     * The current block is dropped if it could still return an id at
+     * or below @p floor, and the next reservation advances the shared
+     * sequence past it. Floors only ever rise.
+     *
+     * @param floor Highest id already in use, e.g. MAX(id) of the table.
+     */
+    void ensureAbove(std::int64_t floor);
+
+    /**
+     * @brief Return the number of ids per block.
+     */
+    std::uint32_t blockSize() const noexcept
+    {
+      return blockSize_;
+    }
+
+  private:
+    std::int64_t reserveBlock();
+
+    vix::db::ConnectionPool &pool_;
+    std::string sequence_;
+    std::uint32_t blockSize_;
+    std::string table_;
+
+    std::mutex mutex_;
+    bool tableReady_ = false;
+    std::int64_t hi_ = 0;
+    std::uint32_t lo_ = 0;
+    bool hasBlock_ = false;
+    std::int64_t floor_ = 0;
+  };
+
+} // namespace vix::orm
+
+#endif // VIX_ORM_ID_GENERATOR_HPP
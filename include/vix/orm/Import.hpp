@@ -0,0 +1,349 @@
+/**
+ *
+ *  @file Import.hpp
+ *  @author Gaspard Kirira
+ *
+ *  Copyright 2025, Gaspard Kirira.
+ *  All rights reserved.
+ *  https://github.com/vixcpp/vix
+ *
+ *  Use of this source code is governed by a MIT license
+ *  that can be found in the License file.
+ *
+ *  Vix.cpp
+ */
+#ifndef VIX_ORM_IMPORT_HPP
+#define VIX_ORM_IMPORT_HPP
+
+#include <vix/orm/db_compat.hpp>
+#include <vix/orm/Mapper.hpp>
+#include <vix/orm/Repository.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace vix::orm
+{
+  /**
+   * @brief Input encoding of an import file.
+   */
+  enum class ImportFormat
+  {
+    CSV,
+    NDJSON
+  };
+
+  namespace detail
+  {
+    struct ImportParser;
+  } // namespace detail
+
+  /**
+   * @brief One parsed input record (CSV line or NDJSON object).
+   *
+   * Values are text views into the memory-mapped input, or into a
+   * per-record buffer when unescaping was needed. Views are valid only
+   * while the record is being mapped.
+   */
+  class ImportRecord
+  {
+  public:
+    /**
+     * @brief 1-based line of the record in the input file.
+     */
+    std::size_t line() const noexcept { return line_; }
+
+    /**
+     * @brief Number of fields.
+     */
+    std::size_t size() const noexcept { return values_.size(); }
+
+    std::string_view name(std::size_t index) const
+    {
+      if (sharedNames_)
+      {
+        return index < sharedNames_->size() ? std::string_view((*sharedNames_)[index])
+                                            : std::string_view();
+      }
+      return view(names_[index]);
+    }
+
+    bool isNull(std::size_t index) const
+    {
+      return values_[index].null;
+    }
+
+    /**
+     * @brief Raw text of a field ("" when NULL).
+     */
+    std::string_view value(std::size_t index) const
+    {
+      return view(values_[index]);
+    }
+
+    /**
+     * @brief Field by name, or std::nullopt when missing or NULL.
+     */
+    std::optional<std::string_view> get(std::string_view field) const
+    {
+      for (std::size_t i = 0; i < values_.size(); ++i)
+      {
+        if (name(i) == field)
+        {
+          if (values_[i].null)
+          {
+            return std::nullopt;
+          }
+          return view(values_[i]);
+        }
+      }
+      return std::nullopt;
+    }
+
+    std::string getString(std::string_view field, std::string_view fallback = {}) const
+    {
+      return std::string(get(field).value_or(fallback));
+    }
+
+    /**
+     * @throws vix::db::DBError when the field is not an integer.
+     */
+    std::int64_t getInt64(std::string_view field, std::int64_t fallback = 0) const;
+
+    /**
+     * @throws vix::db::DBError when the field is not a number.
+     */
+    double getDouble(std::string_view field, double fallback = 0.0) const;
+
+    /**
+     * @brief Accepts 1/0 and true/false.
+     *
+     * @throws vix::db::DBError for other values.
+     */
+    bool getBool(std::string_view field, bool fallback = false) const;
+
+  private:
+    friend struct detail::ImportParser;
+
+    struct Span
+    {
+      std::size_t offset = 0;
+      std::size_t length = 0;
+      bool owned = false;
+      bool null = false;
+    };
+
+    std::string_view view(const Span &s) const
+    {
+      const std::string_view base = s.owned ? std::string_view(arena_) : source_;
+      return base.substr(s.offset, s.length);
+    }
+
+    std::size_t line_ = 0;
+    std::string_view source_;
+    std::string arena_;
+    const std::vector<std::string> *sharedNames_ = nullptr;
+    std::vector<Span> names_;
+    std::vector<Span> values_;
+  };
+
+  /**
+   * @brief A record that could not be parsed or mapped.
+   */
+  struct ImportError
+  {
+    std::size_t line = 0;
+    std::string message;
+  };
+
+  /**
+   * @brief Import progress.
+   */
+  struct ImportProgress
+  {
+    /// Input bytes parsed so far.
+    std::uint64_t bytesRead = 0;
+
+    /// Input file size.
+    std::uint64_t totalBytes = 0;
+
+    /// Records handed to the writer (committed or rejected), in file order.
+    std::uint64_t records = 0;
+
+    /// Rows committed to the database.
+    std::uint64_t inserted = 0;
+
+    /// Records rejected during parsing or mapping.
+    std::uint64_t failed = 0;
+  };
+
+  /**
+   * @brief Outcome of an import.
+   */
+  struct ImportResult
+  {
+    ImportProgress progress;
+
+    /// Per-record errors (at most ImportOptions::maxErrors).
+    std::vector<ImportError> errors;
+  };
+
+  /**
+   * @brief Import configuration.
+   *
+   * @tparam T Entity type.
+   */
+  template <class T>
+  struct ImportOptions
+  {
+    ImportFormat format = ImportFormat::CSV;
+
+    char csvDelimiter = ',';
+
+    /// First CSV line holds column names; otherwise set @ref columns.
+    bool csvHeader = true;
+
+    /// Column names for header-less CSV.
+    std::vector<std::string> columns;
+
+    /// Treat empty unquoted CSV fields as NULL.
+    bool emptyIsNull = true;
+
+    /**
+     * @brief Map a record to an entity inserted via Mapper<T>::toInsertFields.
+     *
+     * When empty, record fields are bound directly as text to the
+     * columns of the same name, skipping T entirely.
+     */
+    std::function<T(const ImportRecord &)> map;
+
+    /// Mapping threads; 0 uses hardware concurrency minus one.
+    std::size_t workers = 0;
+
+    /// Records per work item handed to the mapping threads.
+    std::size_t batchRecords = 1000;
+
+    /// Rows per committed transaction (rounded up to whole batches).
+    std::size_t transactionRows = 50000;
+
+    /// Abort once more records than this have been rejected.
+    std::size_t maxErrors = 1000;
+
+    /// Skip this many records (after the header), e.g. to resume.
+    std::uint64_t skipRecords = 0;
+
+    /// Called after each committed transaction.
+    std::function<void(const ImportProgress &)> onProgress;
+  };
+
+  namespace detail
+  {
+    /**
+     * @brief Type-erased import settings shared with the pipeline.
+     */
+    struct ImportConfig
+    {
+      ImportFormat format = ImportFormat::CSV;
+      char csvDelimiter = ',';
+      bool csvHeader = true;
+      std::vector<std::string> columns;
+      bool emptyIsNull = true;
+      std::size_t workers = 0;
+      std::size_t batchRecords = 1000;
+      std::size_t transactionRows = 50000;
+      std::size_t maxErrors = 1000;
+      std::uint64_t skipRecords = 0;
+      std::function<void(const ImportProgress &)> onProgress;
+    };
+
+    /**
+     * @brief Maps a record to insert fields; empty for direct mapping.
+     */
+    using RecordMapper = std::function<FieldValues(const ImportRecord &)>;
+
+    /**
+     * @brief Run the parse / map / insert pipeline.
+     */
+    ImportResult run_import(vix::db::ConnectionPool &pool,
+                            const std::string &table,
+                            const std::string &path,
+                            const ImportConfig &config,
+                            const RecordMapper &mapper);
+  } // namespace detail
+
+  /**
+   * @brief Bulk-load a CSV or NDJSON file into a repository's table.
+   *
+   * The import runs as a three-stage pipeline:
+   * 1. a reader thread memory-maps the file and splits it into records,
+   *    scanning 8 bytes at a time for quotes and line breaks;
+   * 2. worker threads parse fields and map each record to insert values
+   *    (through T and Mapper<T>, or directly from column names);
+   * 3. the calling thread writes rows in file order with multi-row
+   *    INSERTs, committing every ImportOptions::transactionRows rows.
+   *
+   * Each stage hands over at most twice as many batches as there are
+   * workers, so when the database is the bottleneck workers wait for
+   * the writer instead of buffering the file.
+   *
+   * Records failing to parse or map are collected as ImportError and
+   * skipped. Database errors roll back the open transaction and are
+   * rethrown. Transactions commit at batch boundaries, so the
+   * skipRecords used plus ImportProgress::records at the last
+   * onProgress call is a valid skipRecords for resuming.
+   *
+   * Writes bypass the repository's counter caches and tracked count.
+   *
+   * There is no MySQL LOAD DATA LOCAL INFILE fast path: vix::db only
+   * runs prepared statements, and LOAD DATA cannot be prepared nor
+   * stream a client file through the statement API, so MySQL imports
+   * also use the multi-row INSERTs above.
+   *
+   * Example:
+   * @code
+   * vix::orm::ImportOptions<Product> opt;
+   * opt.map = [](const vix::orm::ImportRecord &r)
+   * { return Product{0, r.getString("sku"), r.getDouble("price")}; };
+   * auto result = vix::orm::importFile(products, "catalog.csv", opt);
+   * @endcode
+   *
+   * @return Progress and per-record errors.
+   */
+  template <class T>
+  ImportResult importFile(BaseRepository<T> &repo,
+                          const std::string &path,
+                          const ImportOptions<T> &options = ImportOptions<T>{})
+  {
+    detail::ImportConfig config;
+    config.format = options.format;
+    config.csvDelimiter = options.csvDelimiter;
+    config.csvHeader = options.csvHeader;
+    config.columns = options.columns;
+    config.emptyIsNull = options.emptyIsNull;
+    config.workers = options.workers;
+    config.batchRecords = options.batchRecords;
+    config.transactionRows = options.transactionRows;
+    config.maxErrors = options.maxErrors;
+    config.skipRecords = options.skipRecords;
+    config.onProgress = options.onProgress;
+
+    detail::RecordMapper mapper;
+    if (options.map)
+    {
+      mapper = [map = options.map](const ImportRecord &record)
+      {
+        return Mapper<T>::toInsertFields(map(record));
+      };
+    }
+
+    return detail::run_import(repo.pool(), repo.table(), path, config, mapper);
+  }
+
+} // namespace vix::orm
+
+#endif // VIX_ORM_IMPORT_HPP
@@ -0,0 +1,184 @@
+/**
+ *
+ *  @file JsonWriter.hpp
+ *  @author Gaspard Kirira
+ *
+ *  Copyright 2025, Gaspard Kirira.
+ *  All rights reserved.
+ *  https://github.com/vixcpp/vix
+ *
+ *  Use of this source code is governed by a MIT license
+ *  that can be found in the License file.
+ *
+ *  Vix.cpp
+ */
+#ifndef VIX_ORM_JSON_WRITER_HPP
+#define VIX_ORM_JSON_WRITER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iosfwd>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace vix::orm
+{
+  namespace detail
+  {
+    /**
+     * @brief Append @p s to @p out with JSON string escaping (no quotes).
+     */
+    void append_json_escaped(std::string &out, std::string_view s);
+  } // namespace detail
+
+  /**
+   * @brief Streaming JSON writer with a bounded output buffer.
+   *
+   * Output accumulates in an internal buffer that is handed to the
+   * sink whenever it reaches the chunk size, so arbitrarily large
+   * documents are produced in roughly chunk-sized pieces (for example
+   * as HTTP chunked transfer encoding). Commas between members and
+   * elements are inserted automatically.
+   *
+   * The writer is also a field visitor for Mapper<T>::visitRow (see
+   * VisitableMapper): json(name, value) writes one object member.
+   *
+   * Example:
+   * @code
+   * std::string body;
+   * vix::orm::JsonWriter json(body);
+   * json.beginObject();
+   * json("ok", true);
+   * json.key("data");
+   * users.writeJson(json);
+   * json.endObject();
+   * json.flush();
+   * @endcode
+   */
+  class JsonWriter
+  {
+  public:
+    /**
+     * @brief Receives each output chunk.
+     */
+    using Sink = std::function<void(std::string_view)>;
+
+    /**
+     * @brief Default flush threshold in bytes.
+     */
+    static constexpr std::size_t default_chunk_size = 16 * 1024;
+
+    /**
+     * @brief Write chunks to a callback.
+     */
+    explicit JsonWriter(Sink sink, std::size_t chunkSize = default_chunk_size);
+
+    /**
+     * @brief Append output to a string.
+     */
+    explicit JsonWriter(std::string &out, std::size_t chunkSize = default_chunk_size);
+
+    /**
+     * @brief Write output to a stream.
+     */
+    explicit JsonWriter(std::ostream &out, std::size_t chunkSize = default_chunk_size);
+
+    JsonWriter(const JsonWriter &) = delete;
+    JsonWriter &operator=(const JsonWriter &) = delete;
+
+    /**
+     * @brief Flush remaining output; errors from the sink are swallowed.
+     */
+    ~JsonWriter();
+
+    void beginObject();
+    void endObject();
+    void beginArray();
+    void endArray();
+
+    /**
+     * @brief Write an object member name.
+     */
+    void key(std::string_view name);
+
+    void null();
+    void value(bool v);
+    void value(std::int64_t v);
+    void value(std::uint64_t v);
+    void value(double v);
+    void value(std::string_view v);
+
+    /**
+     * @brief Write bytes as a base64 string.
+     */
+    void value(std::span<const std::byte> bytes);
+
+    /**
+     * @brief Write pre-serialized JSON verbatim.
+     */
+    void raw(std::string_view json);
+
+    /**
+     * @brief Hand buffered output to the sink.
+     */
+    void flush();
+
+    /**
+     * @brief Write one object member (field visitor protocol).
+     *
+     * @param name Member name.
+     * @param v Value: arithmetic, string-like, bytes, std::nullptr_t or
+     *          std::optional of those.
+     */
+    template <class V>
+    void operator()(std::string_view name, const V &v)
+    {
+      key(name);
+      write(v);
+    }
+
+  private:
+    template <class V>
+    void write(const V &v)
+    {
+      if constexpr (std::is_same_v<V, std::nullptr_t>)
+        null();
+      else if constexpr (std::is_same_v<V, bool>)
+        value(v);
+      else if constexpr (std::is_integral_v<V> && std::is_signed_v<V>)
+        value(static_cast<std::int64_t>(v));
+      else if constexpr (std::is_integral_v<V>)
+        value(static_cast<std::uint64_t>(v));
+      else if constexpr (std::is_floating_point_v<V>)
+        value(static_cast<double>(v));
+      else if constexpr (std::is_convertible_v<const V &, std::span<const std::byte>>)
+        value(std::span<const std::byte>(v));
+      else if constexpr (std::is_convertible_v<const V &, std::string_view>)
+        value(std::string_view(v));
+      else if constexpr (requires { v.has_value(); *v; })
+      {
+        if (v.has_value())
+          write(*v);
+        else
+          null();
+      }
+      else
+        static_assert(!sizeof(V), "vix::orm::JsonWriter: unsupported value type");
+    }
+
+    void separate();
+    void maybeFlush();
+
+    Sink sink_;
+    std::string buffer_;
+    std::size_t chunkSize_;
+    bool needComma_ = false;
+  };
+
+} // namespace vix::orm
+
+#endif // VIX_ORM_JSON_WRITER_HPP
@@ -16,12 +16,19 @@
 #define VIX_MAPPER_HPP
 
 #include <any>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <optional>
 #include <string>
+#include <string_view>
 #include <type_traits>
 #include <utility>
 #include <vector>
 
 #include <vix/db/core/Result.hpp>
+#include <vix/orm/db_compat.hpp>
 
 namespace vix::orm
 {
@@ -57,6 +64,55 @@ namespace vix::orm
     inline constexpr bool always_false_v = false;
   } // namespace detail
 
+  /**
+   * @brief Read a typed value from a result row column.
+   *
+   * Supported value types:
+   * - bool and integral types (read as 64-bit integer)
+   * - floating-point types
+   * - std::string
+   * - std::optional<V> of any of the above (NULL maps to std::nullopt)
+   *
+   * @tparam V Target value type.
+   * @param row Database result row.
+   * @param index Zero-based column index.
+   * @return Column value converted to @p V.
+   */
+  template <class V>
+  V read_column(const vix::db::ResultRow &row, std::size_t index)
+  {
+    if constexpr (detail::is_optional<V>::value)
+    {
+      if (row.isNull(index))
+      {
+        return std::nullopt;
+      }
+      return read_column<typename V::value_type>(row, index);
+    }
+    else if constexpr (std::is_same_v<V, bool>)
+    {
+      return row.getInt64(index) != 0;
+    }
+    else if constexpr (std::is_integral_v<V>)
+    {
+      return static_cast<V>(row.getInt64(index));
+    }
+    else if constexpr (std::is_floating_point_v<V>)
+    {
+      return static_cast<V>(row.getDouble(index));
+    }
+    else if constexpr (std::is_same_v<V, std::string>)
+    {
+      return row.getString(index);
+    }
+    else
+    {
+      static_assert(detail::always_false_v<V>,
+                    "vix::orm::read_column: unsupported column value type");
+      return V{};
+    }
+  }
+
   /**
    * @brief User-specialized mapper for ORM entities.
    *
@@ -193,6 +249,54 @@ namespace vix::orm
     }
   };
 
+  /**
+   * @brief Mappers declaring an optimistic-locking version column.
+   *
+   * Opt in by adding to the Mapper<T> specialization:
+   * @code
+   * static constexpr std::string_view version_column = "version";
+   * static std::int64_t version(const User &u) { return u.version; }
+   * @endcode
+   *
+   * Repositories then guard full-entity updates with
+   * AND version = ?, and raise OptimisticLockError when another writer
+   * got there first. Every repository UPDATE (full, partial, increment,
+   * compareAndSet, updateWhere) increments the column, and assigning it
+   * directly is rejected.
+   */
+  template <class T>
+  concept VersionedMapper = requires(const T &value) {
+    { Mapper<T>::version_column } -> std::convertible_to<std::string_view>;
+    { Mapper<T>::version(value) } -> std::convertible_to<std::int64_t>;
+  };
+
+  /**
+   * @brief Mappers of read-only projections declaring their column list.
+   *
+   * A projection is a DTO loaded from a subset of an entity's table:
+   * @code
+   * struct UserSummary { std::int64_t id; std::string name; };
+   *
+   * template <>
+   * struct vix::orm::Mapper<UserSummary>
+   * {
+   *   static constexpr std::array<std::string_view, 2> columns{"id", "name"};
+   *
+   *   static UserSummary fromRow(const vix::db::ResultRow &row)
+   *   {
+   *     return {row.getInt64(0), row.getString(1)};
+   *   }
+   * };
+   * @endcode
+   *
+   * fromRow reads columns by position, in the declared order.
+   */
+  template <class Dto>
+  concept ProjectionMapper = requires(const vix::db::ResultRow &row) {
+    { *std::begin(Mapper<Dto>::columns) } -> std::convertible_to<std::string_view>;
+    { Mapper<Dto>::fromRow(row) } -> std::convertible_to<Dto>;
+  };
+
 } // namespace vix::orm
 
 #endif // VIX_MAPPER_HPP
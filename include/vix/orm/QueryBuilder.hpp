@@ -16,8 +16,12 @@
 #define VIX_ORM_QUERY_BUILDER_HPP
 
 #include <vix/orm/db_compat.hpp>
+#include <vix/orm/Fingerprint.hpp>
 
+#include <algorithm>
+#include <cstddef>
 #include <cstdint>
+#include <span>
 #include <string>
 #include <string_view>
 #include <utility>
@@ -25,6 +29,41 @@
 
 namespace vix::orm
 {
+  /**
+   * @brief Optional statement extension for borrowed (zero-copy) binding.
+   *
+   * vix::db::Statement only accepts owned DbValue instances. Drivers or
+   * statement adapters able to bind caller-owned memory without copying
+   * (for example SQLite with SQLITE_STATIC) may additionally implement
+   * this interface. QueryBuilder::bind() detects it for parameters added
+   * with paramRef() and falls back to a transient copy otherwise.
+   *
+   * The memory passed to these methods is guaranteed by the caller to
+   * remain valid until the statement has been executed.
+   */
+  class BorrowedBindable
+  {
+  public:
+    virtual ~BorrowedBindable() = default;
+
+    /**
+     * @brief Bind a borrowed text value.
+     *
+     * @param index One-based bind index.
+     * @param value Text view valid until execution.
+     */
+    virtual void bindBorrowedText(std::size_t index, std::string_view value) = 0;
+
+    /**
+     * @brief Bind a borrowed blob value.
+     *
+     * @param index One-based bind index.
+     * @param value Byte view valid until execution.
+     */
+    virtual void bindBorrowedBlob(std::size_t index,
+                                  std::span<const std::uint8_t> value) = 0;
+  };
+
   /**
    * @brief Lightweight SQL query builder with bound parameters.
    *
@@ -39,11 +78,95 @@ namespace vix::orm
    *
    * This is not a full ORM query DSL. It is a small utility for building
    * prepared statements cleanly while staying close to SQL.
+   *
+   * The first append reserves initial_sql_capacity bytes of SQL and
+   * the first parameter initial_param_capacity slots, so typical ad-hoc
+   * queries are built with one allocation each instead of a series of
+   * reallocations as they grow. Builders that stay empty allocate
+   * nothing.
    */
   class QueryBuilder
   {
+  public:
+    /**
+     * @brief SQL bytes reserved by the first append.
+     */
+    static constexpr std::size_t initial_sql_capacity = 256;
+
+    /**
+     * @brief Parameter slots reserved by the first parameter.
+     */
+    static constexpr std::size_t initial_param_capacity = 6;
+
+  private:
+    /**
+     * @brief Parameter slot referring to caller-owned memory.
+     */
+    struct BorrowedParam
+    {
+      std::size_t index = 0;
+      std::string_view text;
+      std::span<const std::uint8_t> bytes;
+      bool blob = false;
+    };
+
     std::string sql_;
-    std::vector<vix::db::DbValue> params_;
+
+    // Borrowed slots hold NULL in params_ until params() or takeParams()
+    // copies them in; bind() reads them from borrowed_ instead.
+    mutable std::vector<vix::db::DbValue> params_;
+    mutable std::vector<BorrowedParam> borrowed_;
+
+    SqlFingerprint fingerprint_;
+
+    void appendSql(std::string_view s)
+    {
+      if (sql_.capacity() < initial_sql_capacity)
+      {
+        sql_.reserve(std::max(initial_sql_capacity, sql_.size() + s.size()));
+      }
+      sql_.append(s);
+      fingerprint_.feed(s);
+    }
+
+    void pushParam(vix::db::DbValue &&value)
+    {
+      if (params_.capacity() == 0)
+      {
+        params_.reserve(initial_param_capacity);
+      }
+      params_.push_back(std::move(value));
+    }
+
+    void pushBorrowed(BorrowedParam p)
+    {
+      p.index = params_.size();
+      borrowed_.push_back(p);
+      pushParam(vix::db::null());
+    }
+
+    static vix::db::DbValue materialize(const BorrowedParam &p)
+    {
+      if (p.blob)
+      {
+        return vix::db::DbValue{
+            vix::db::Blob{std::vector<std::uint8_t>(p.bytes.begin(), p.bytes.end())}};
+      }
+
+      return vix::db::str(std::string(p.text));
+    }
+
+    /**
+     * @brief Copy borrowed values into params_ so it is complete.
+     */
+    void ownBorrowed() const
+    {
+      for (const BorrowedParam &p : borrowed_)
+      {
+        params_[p.index] = materialize(p);
+      }
+      borrowed_.clear();
+    }
 
   public:
     /**
@@ -58,7 +181,7 @@ namespace vix::orm
      */
     explicit QueryBuilder(std::string_view sql)
     {
-      sql_.append(sql);
+      appendSql(sql);
     }
 
     /**
@@ -85,6 +208,8 @@ namespace vix::orm
     {
       sql_.clear();
       params_.clear();
+      borrowed_.clear();
+      fingerprint_.reset();
       return *this;
     }
 
@@ -106,7 +231,7 @@ namespace vix::orm
      */
     QueryBuilder &raw(std::string_view s)
     {
-      sql_.append(s);
+      appendSql(s);
       return *this;
     }
 
@@ -118,8 +243,8 @@ namespace vix::orm
      */
     QueryBuilder &rawSpace(std::string_view s)
     {
-      sql_.append(s);
-      sql_.push_back(' ');
+      appendSql(s);
+      appendSql(" ");
       return *this;
     }
 
@@ -130,7 +255,7 @@ namespace vix::orm
      */
     QueryBuilder &space()
     {
-      sql_.push_back(' ');
+      appendSql(" ");
       return *this;
     }
 
@@ -141,7 +266,7 @@ namespace vix::orm
      */
     QueryBuilder &newline()
     {
-      sql_.push_back('\n');
+      appendSql("\n");
       return *this;
     }
 
@@ -153,7 +278,7 @@ namespace vix::orm
      */
     QueryBuilder &param(const vix::db::DbValue &value)
     {
-      params_.push_back(value);
+      pushParam(vix::db::DbValue(value));
       return *this;
     }
 
@@ -165,7 +290,7 @@ namespace vix::orm
      */
     QueryBuilder &param(vix::db::DbValue &&value)
     {
-      params_.push_back(std::move(value));
+      pushParam(std::move(value));
       return *this;
     }
 
@@ -278,18 +403,108 @@ namespace vix::orm
       return param(vix::db::null());
     }
 
+    /**
+     * @brief Append a borrowed string parameter.
+     *
+     * The builder stores only the view, so no copy is made while
+     * building. Statements implementing BorrowedBindable bind the
+     * caller's memory directly; any other vix::db::Statement receives a
+     * transient copy at bind() time, the same single copy param() would
+     * have made up front. params() and takeParams() also copy borrowed
+     * values into owned ones.
+     *
+     * The caller guarantees that @p value stays valid until the bound
+     * statement has been executed, or until params()/takeParams() is
+     * called.
+     *
+     * @param value String view.
+     * @return Reference to this builder.
+     */
+    QueryBuilder &paramRef(std::string_view value)
+    {
+      BorrowedParam p;
+      p.text = value;
+      pushBorrowed(p);
+      return *this;
+    }
+
+    /**
+     * @brief Append a borrowed blob parameter.
+     *
+     * Same lifetime contract and copy fallback as
+     * paramRef(std::string_view).
+     *
+     * @param value Byte view.
+     * @return Reference to this builder.
+     */
+    QueryBuilder &paramRef(std::span<const std::uint8_t> value)
+    {
+      BorrowedParam p;
+      p.bytes = value;
+      p.blob = true;
+      pushBorrowed(p);
+      return *this;
+    }
+
+    /**
+     * @brief Return whether some parameters still refer to caller memory.
+     *
+     * @return true if a paramRef() value has not been copied yet.
+     */
+    bool hasBorrowedParams() const noexcept
+    {
+      return !borrowed_.empty();
+    }
+
+    /**
+     * @brief Return the number of parameters, borrowed ones included.
+     *
+     * Unlike params(), this never copies borrowed values.
+     *
+     * @return Parameter count.
+     */
+    std::size_t paramCount() const noexcept
+    {
+      return params_.size();
+    }
+
     /**
      * @brief Bind all collected parameters to a prepared statement.
      *
-     * Binding starts at index 1.
+     * Binding starts at @p first, 1 by default. A larger start index
+     * lets the builder provide a fragment (e.g. a WHERE predicate)
+     * placed after other bound values.
      *
      * @param st Prepared statement.
+     * @param first One-based index of the first parameter.
      */
-    void bind(vix::db::Statement &st) const
+    void bind(vix::db::Statement &st, std::size_t first = 1) const
     {
+      auto *direct = borrowed_.empty() ? nullptr : dynamic_cast<BorrowedBindable *>(&st);
+      std::size_t next = 0;
+
       for (std::size_t i = 0; i < params_.size(); ++i)
       {
-        st.bind(i + 1, params_[i]);
+        if (next < borrowed_.size() && borrowed_[next].index == i)
+        {
+          const BorrowedParam &p = borrowed_[next++];
+
+          if (direct == nullptr)
+          {
+            st.bind(i + first, materialize(p));
+          }
+          else if (p.blob)
+          {
+            direct->bindBorrowedBlob(i + first, p.bytes);
+          }
+          else
+          {
+            direct->bindBorrowedText(i + first, p.text);
+          }
+          continue;
+        }
+
+        st.bind(i + first, params_[i]);
       }
     }
 
@@ -303,13 +518,36 @@ namespace vix::orm
       return sql_;
     }
 
+    /**
+     * @brief Return the normalized fingerprint of the SQL built so far.
+     *
+     * The fingerprint is updated as SQL is appended, so reading it never
+     * rehashes the statement. Statements differing only in whitespace,
+     * comments, literal values or IN-list length share the same
+     * fingerprint: use it for statistics and logs, not as a
+     * prepared-statement cache key.
+     *
+     * @return 64-bit fingerprint.
+     */
+    std::uint64_t fingerprint() const noexcept
+    {
+      return fingerprint_.value();
+    }
+
     /**
      * @brief Access the collected parameters.
      *
+     * Borrowed parameters are copied into owned values first, so the
+     * list is complete and no longer refers to caller memory. That copy
+     * mutates the builder, so a builder holding borrowed parameters must
+     * not be read through params() from several threads; bind() and
+     * paramCount() are safe to share.
+     *
      * @return Parameter list.
      */
-    const std::vector<vix::db::DbValue> &params() const noexcept
+    const std::vector<vix::db::DbValue> &params() const
     {
+      ownBorrowed();
       return params_;
     }
 
@@ -320,16 +558,20 @@ namespace vix::orm
      */
     std::string takeSql() noexcept
     {
+      fingerprint_.reset();
       return std::move(sql_);
     }
 
     /**
      * @brief Move out the parameter list.
      *
+     * Borrowed parameters are copied into owned values first.
+     *
      * @return Parameter list.
      */
-    std::vector<vix::db::DbValue> takeParams() noexcept
+    std::vector<vix::db::DbValue> takeParams()
     {
+      ownBorrowed();
       return std::move(params_);
     }
   };
@@ -16,18 +16,217 @@
 #define VIX_REPOSITORY_HPP
 
 #include <vix/orm/db_compat.hpp>
+#include <vix/orm/Columnar.hpp>
+#include <vix/orm/Dialect.hpp>
+#include <vix/orm/Errors.hpp>
+#include <vix/orm/IdGenerator.hpp>
+#include <vix/orm/JsonWriter.hpp>
 #include <vix/orm/Mapper.hpp>
+#include <vix/orm/QueryBuilder.hpp>
+#include <vix/orm/RowView.hpp>
+#include <vix/orm/TypedQuery.hpp>
 
+#include <algorithm>
+#include <any>
+#include <charconv>
+#include <chrono>
+#include <concepts>
 #include <cstddef>
 #include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <optional>
 #include <stdexcept>
 #include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
 namespace vix::orm
 {
+  /**
+   * @brief SQL aggregate function computed by the database.
+   */
+  enum class AggregateFn
+  {
+    Count,
+    Sum,
+    Min,
+    Max,
+    Avg
+  };
+
+  /**
+   * @brief Grouped aggregate result: (group key, value) pairs sorted by key.
+   */
+  template <class K, class V>
+  using FlatMap = std::vector<std::pair<K, V>>;
+
+  /**
+   * @brief One page of an ordered query.
+   */
+  struct PageRequest
+  {
+    /// Maximum rows returned.
+    std::size_t limit = 50;
+
+    /// Rows skipped before the page.
+    std::size_t offset = 0;
+
+    /// Sort descending instead of ascending.
+    bool descending = false;
+  };
+
+  /**
+   * @brief Denormalized child-count column kept in sync by a child repository.
+   *
+   * With a counter cache installed on the child repository, creating a
+   * child whose @ref foreignKey references a parent row also runs
+   * UPDATE parentTable SET counterColumn = counterColumn + 1 in the same
+   * transaction; removing children subtracts accordingly. Batched writes
+   * issue one aggregated UPDATE per parent.
+   *
+   * Changing a child's foreign key through an update does not move the
+   * count between parents.
+   */
+  struct CounterCache
+  {
+    /// Parent table, e.g. "users".
+    std::string parentTable;
+
+    /// Child column referencing the parent, e.g. "user_id".
+    std::string foreignKey;
+
+    /// Parent column holding the count, e.g. "orders_count".
+    std::string counterColumn;
+
+    /// Parent primary key column.
+    std::string parentKey = "id";
+  };
+
+  namespace detail
+  {
+    /**
+     * @brief Mutable state shared by copies of a repository.
+     *
+     * Repositories are cheap handles that are copied and shared across
+     * threads; lazily computed information lives here, behind a mutex.
+     */
+    struct RepositoryState
+    {
+      /**
+       * @brief Generated statement cached by column set.
+       */
+      struct CachedSql
+      {
+        std::vector<std::string> columns;
+        std::shared_ptr<const std::string> sql;
+      };
+
+      /**
+       * @brief Upper bound on cached column sets per repository.
+       */
+      static constexpr std::size_t max_cached_sql = 256;
+
+      std::mutex mutex;
+      std::optional<DialectInfo> dialect;
+      std::shared_ptr<IdGenerator> ids;
+      std::unordered_map<std::uint64_t, CachedSql> updateSql;
+      std::shared_ptr<const std::vector<CounterCache>> counterCaches;
+
+      bool trackCount = false;
+      std::optional<std::int64_t> rowCount;
+      std::chrono::steady_clock::duration reconcileEvery{};
+      std::chrono::steady_clock::time_point countedAt{};
+    };
+
+    /**
+     * @brief Return the integer value of a named mapper field.
+     *
+     * @param fields Mapper field list.
+     * @param name Field name.
+     * @return Value, or std::nullopt when absent, null or not integral.
+     */
+    inline std::optional<std::int64_t> integer_field(const FieldValues &fields,
+                                                     std::string_view name)
+    {
+      for (const auto &field : fields)
+      {
+        if (field.first != name)
+        {
+          continue;
+        }
+
+        const std::any &v = field.second;
+        if (const auto *p = std::any_cast<std::int64_t>(&v))
+          return *p;
+        if (const auto *p = std::any_cast<std::uint64_t>(&v))
+          return static_cast<std::int64_t>(*p);
+        if (const auto *p = std::any_cast<int>(&v))
+          return *p;
+        if (const auto *p = std::any_cast<long>(&v))
+          return static_cast<std::int64_t>(*p);
+        if (const auto *p = std::any_cast<long long>(&v))
+          return static_cast<std::int64_t>(*p);
+        if (const auto *p = std::any_cast<std::optional<std::int64_t>>(&v))
+          return *p;
+        return std::nullopt;
+      }
+
+      return std::nullopt;
+    }
+
+    /**
+     * @brief Return the integer value of a mapper-provided "id" field.
+     *
+     * @param fields Mapper field list.
+     * @return Id value, or std::nullopt when absent or not integral.
+     */
+    inline std::optional<std::int64_t> explicit_id(const FieldValues &fields)
+    {
+      return integer_field(fields, "id");
+    }
+
+    /**
+     * @brief Pending counter deltas, one ordered map per counter cache.
+     *
+     * Parents are updated in key order so concurrent transactions lock
+     * parent rows in the same order.
+     */
+    using CounterDeltas = std::vector<std::map<std::int64_t, std::int64_t>>;
+
+    /**
+     * @brief Result type of SUM over a column of type V.
+     */
+    template <class V>
+    using sum_t = std::conditional_t<std::is_floating_point_v<V>, double, std::int64_t>;
+
+    /**
+     * @brief SQL name of an aggregate function.
+     */
+    inline const char *aggregate_sql(AggregateFn fn) noexcept
+    {
+      switch (fn)
+      {
+      case AggregateFn::Count:
+        return "COUNT";
+      case AggregateFn::Sum:
+        return "SUM";
+      case AggregateFn::Min:
+        return "MIN";
+      case AggregateFn::Max:
+        return "MAX";
+      case AggregateFn::Avg:
+        return "AVG";
+      }
+      return "COUNT";
+    }
+  } // namespace detail
+
   /**
    * @brief Generic repository for ORM entities.
    *
@@ -50,6 +249,8 @@ namespace vix::orm
   {
     vix::db::ConnectionPool &pool_;
     std::string table_;
+    std::shared_ptr<detail::RepositoryState> state_ =
+        std::make_shared<detail::RepositoryState>();
 
     static void ensureNotEmpty(const FieldValues &fields,
                                const char *context)
@@ -112,104 +313,156 @@ namespace vix::orm
       return setClause;
     }
 
-    static void bindFields(vix::db::Statement &st,
-                           const FieldValues &fields,
-                           std::size_t startIndex = 1)
+    std::string insertSql(const FieldValues &fields) const
     {
-      std::size_t index = startIndex;
-      for (const auto &field : fields)
-      {
-        st.bind(index++, any_to_dbvalue_or_throw(field.second));
-      }
+      return "INSERT INTO " + table_ + " (" + buildInsertColumns(fields) +
+             ") VALUES (" + buildInsertPlaceholders(fields.size()) + ")";
+    }
+
+    std::string updateSql(const FieldValues &fields) const
+    {
+      return "UPDATE " + table_ + " SET " + buildUpdateSetClause(fields) + " WHERE id=?";
     }
 
-  public:
     /**
-     * @brief Construct a repository bound to a table.
+     * @brief Append ",version=version+1" when the mapper declares a version.
      *
-     * @param pool  Connection pool used for queries.
-     * @param table Database table name.
+     * Every UPDATE issued by the repository bumps the version, so an
+     * entity loaded before a partial or set-based update fails its next
+     * full update with OptimisticLockError instead of overwriting it.
      */
-    BaseRepository(vix::db::ConnectionPool &pool, std::string table)
-        : pool_(pool), table_(std::move(table))
+    static void appendVersionBump(std::string &sql)
     {
-      if (table_.empty())
+      if constexpr (VersionedMapper<T>)
       {
-        throw std::runtime_error("BaseRepository: table name cannot be empty");
+        const std::string_view column = Mapper<T>::version_column;
+        sql.append(",").append(column).append("=").append(column).append("+1");
+      }
+      else
+      {
+        (void)sql;
       }
     }
 
     /**
-     * @brief Return the database table name used by this repository.
-     *
-     * @return Table name.
+     * @brief Reject writes assigning the version column directly.
      */
-    const std::string &table() const noexcept
+    static void rejectVersionColumn(std::string_view column, const char *context)
     {
-      return table_;
+      if constexpr (VersionedMapper<T>)
+      {
+        if (column == std::string_view(Mapper<T>::version_column))
+        {
+          throw vix::db::DBError(std::string("BaseRepository: version column '") +
+                                 std::string(column) + "' is maintained by the repository in " +
+                                 context);
+        }
+      }
+      else
+      {
+        (void)column;
+        (void)context;
+      }
     }
 
     /**
-     * @brief Access the underlying connection pool.
-     *
-     * @return Connection pool reference.
+     * @brief Version column used by updateIf() when none is given.
      */
-    vix::db::ConnectionPool &pool() noexcept
+    static constexpr std::string_view defaultVersionColumn()
     {
-      return pool_;
+      if constexpr (VersionedMapper<T>)
+      {
+        return Mapper<T>::version_column;
+      }
+      else
+      {
+        return "version";
+      }
     }
 
     /**
-     * @brief Access the underlying connection pool (const).
-     *
-     * @return Connection pool reference.
+     * @brief Full-entity update fields, minus the version column.
      */
-    const vix::db::ConnectionPool &pool() const noexcept
+    static FieldValues entityUpdateFields(const T &value, const char *context)
     {
-      return pool_;
+      auto fields = Mapper<T>::toUpdateFields(value);
+
+      if constexpr (VersionedMapper<T>)
+      {
+        const std::string_view column = Mapper<T>::version_column;
+        std::erase_if(fields, [&](const FieldValue &f)
+                      { return f.first == column; });
+      }
+
+      ensureNotEmpty(fields, context);
+      return fields;
     }
 
     /**
-     * @brief Insert a new entity.
-     *
-     * Uses Mapper<T>::toInsertFields to generate the INSERT statement.
-     *
-     * @param value Entity instance.
-     * @return Generated primary key.
+     * @brief Full-entity UPDATE, version-guarded when the mapper opts in.
      */
-    std::uint64_t create(const T &value)
+    std::string entityUpdateSql(const FieldValues &fields) const
     {
-      const auto fields = Mapper<T>::toInsertFields(value);
-      ensureNotEmpty(fields, "create");
-
-      const std::string columns = buildInsertColumns(fields);
-      const std::string placeholders = buildInsertPlaceholders(fields.size());
-
-      const std::string sql =
-          "INSERT INTO " + table_ + " (" + columns + ") VALUES (" + placeholders + ")";
+      if constexpr (VersionedMapper<T>)
+      {
+        const std::string_view column = Mapper<T>::version_column;
 
-      vix::db::PooledConn conn(pool_);
-      auto st = conn.get().prepare(sql);
+        std::string sql = "UPDATE " + table_ + " SET " + buildUpdateSetClause(fields);
+        appendVersionBump(sql);
+        sql.append(" WHERE id=? AND ").append(column).append("=?");
+        return sql;
+      }
+      else
+      {
+        return updateSql(fields);
+      }
+    }
 
-      bindFields(*st, fields);
-      st->exec();
+    static void bindEntityUpdate(vix::db::Statement &st,
+                                 const FieldValues &fields,
+                                 std::int64_t id,
+                                 const T &value)
+    {
+      bindFields(st, fields);
+      st.bind(fields.size() + 1, id);
 
-      return conn.get().lastInsertId();
+      if constexpr (VersionedMapper<T>)
+      {
+        st.bind(fields.size() + 2, static_cast<std::int64_t>(Mapper<T>::version(value)));
+      }
+      else
+      {
+        (void)value;
+      }
     }
 
     /**
-     * @brief Find an entity by primary key.
-     *
-     * @param id Primary key value.
-     * @return Entity if found, otherwise std::nullopt.
+     * @brief Turn a zero-row versioned update into a conflict if the row exists.
      */
-    std::optional<T> findById(std::int64_t id)
+    void checkVersionConflict(vix::db::Connection &conn, std::int64_t id, const T &value)
     {
-      const std::string sql =
-          "SELECT * FROM " + table_ + " WHERE id = ? LIMIT 1";
+      if constexpr (VersionedMapper<T>)
+      {
+        auto st = conn.prepare("SELECT id FROM " + table_ + " WHERE id = ? LIMIT 1");
+        st->bind(1, id);
 
-      vix::db::PooledConn conn(pool_);
-      auto st = conn.get().prepare(sql);
+        auto rs = st->query();
+        if (rs && rs->next())
+        {
+          throw OptimisticLockError(table_, id, static_cast<std::int64_t>(Mapper<T>::version(value)));
+        }
+      }
+      else
+      {
+        (void)conn;
+        (void)id;
+        (void)value;
+      }
+    }
+
+    std::optional<T> selectById(vix::db::Connection &conn, std::int64_t id)
+    {
+      auto st = conn.prepare("SELECT * FROM " + table_ + " WHERE id = ? LIMIT 1");
       st->bind(1, id);
 
       auto rs = st->query();
@@ -222,126 +475,2143 @@ namespace vix::orm
     }
 
     /**
-     * @brief Return all rows from the table.
+     * @brief Append " WHERE <predicate>" with an optional row limit.
      *
-     * @return Vector of materialized entities.
+     * MySQL supports UPDATE/DELETE ... LIMIT directly. Elsewhere the
+     * limit goes through a primary-key subquery, which SQLite accepts
+     * without SQLITE_ENABLE_UPDATE_DELETE_LIMIT.
      */
-    std::vector<T> findAll()
+    void appendWhere(std::string &sql,
+                     const QueryBuilder &where,
+                     std::optional<std::size_t> limit,
+                     vix::db::Connection &conn,
+                     const char *context)
     {
-      const std::string sql = "SELECT * FROM " + table_;
+      if (where.sql().empty())
+      {
+        throw vix::db::DBError(std::string("BaseRepository: empty predicate in ") + context);
+      }
 
-      vix::db::PooledConn conn(pool_);
-      auto st = conn.get().prepare(sql);
-      auto rs = st->query();
+      if (!limit)
+      {
+        sql.append(" WHERE ").append(where.sql());
+        return;
+      }
 
-      std::vector<T> out;
-      while (rs && rs->next())
+      if (dialect(conn).kind == Dialect::MySQL)
       {
-        out.push_back(Mapper<T>::fromRow(rs->row()));
+        sql.append(" WHERE ").append(where.sql());
+        sql.append(" LIMIT ").append(std::to_string(*limit));
+        return;
       }
 
-      return out;
+      sql.append(" WHERE id IN (SELECT id FROM ").append(table_);
+      sql.append(" WHERE ").append(where.sql());
+      sql.append(" LIMIT ").append(std::to_string(*limit)).append(")");
     }
 
     /**
-     * @brief Check whether an entity exists for a given primary key.
-     *
-     * @param id Primary key value.
-     * @return true if a row exists, false otherwise.
+     * @brief Run SELECT <select> FROM table [WHERE ...]<tail> and visit rows.
      */
-    bool existsById(std::int64_t id)
+    template <class Fn>
+    void selectRows(std::string_view select,
+                        const QueryBuilder &where,
+                        std::string_view tail,
+                        Fn &&onRow)
     {
-      const std::string sql =
-          "SELECT id FROM " + table_ + " WHERE id = ? LIMIT 1";
+      std::string sql = "SELECT ";
+      sql.append(select).append(" FROM ").append(table_);
+      if (!where.sql().empty())
+      {
+        sql.append(" WHERE ").append(where.sql());
+      }
+      sql.append(tail);
 
       vix::db::PooledConn conn(pool_);
       auto st = conn.get().prepare(sql);
-      st->bind(1, id);
+      where.bind(*st);
 
       auto rs = st->query();
-      return rs && rs->next();
+      while (rs && rs->next())
+      {
+        onRow(rs->row());
+      }
     }
 
     /**
-     * @brief Count all rows in the table.
-     *
-     * @return Total number of rows.
+     * @brief Single aggregate over a typed column, read as V.
      */
-    std::uint64_t count()
+    template <class V, auto Member>
+    std::optional<V> aggregateOf(AggregateFn fn, const QueryBuilder &where)
     {
-      const std::string sql = "SELECT COUNT(*) FROM " + table_;
-
-      vix::db::PooledConn conn(pool_);
-      auto st = conn.get().prepare(sql);
-      auto rs = st->query();
+      static_assert(std::is_same_v<detail::member_owner_t<Member>, T>,
+                    "BaseRepository: aggregate column belongs to another entity");
 
-      if (!rs || !rs->next())
-      {
-        return 0;
-      }
+      std::string select = detail::aggregate_sql(fn);
+      select.append("(").append(Column<Member>::name).append(")");
 
-      return static_cast<std::uint64_t>(rs->row().getInt64(0));
+      std::optional<V> out;
+      selectRows(select, where, "", [&](const auto &row)
+                     { out = read_column<std::optional<V>>(row, 0); });
+      return out;
     }
 
     /**
-     * @brief Update an entity by primary key.
-     *
-     * Uses Mapper<T>::toUpdateFields to generate the SET clause.
+     * @brief Aggregate over a typed column grouped by another, read as V.
      *
-     * @param id    Primary key value.
-     * @param value Entity instance.
-     * @return Number of affected rows.
+     * Groups whose key or aggregate is NULL are skipped unless the key
+     * member is itself a std::optional.
      */
-    std::uint64_t updateById(std::int64_t id, const T &value)
+    template <class V, auto Key, auto Value>
+    FlatMap<detail::member_value_t<Key>, V> aggregateBy(AggregateFn fn, const QueryBuilder &where)
     {
-      const auto fields = Mapper<T>::toUpdateFields(value);
-      ensureNotEmpty(fields, "updateById");
+      using K = detail::member_value_t<Key>;
 
-      const std::string setClause = buildUpdateSetClause(fields);
-      const std::string sql =
-          "UPDATE " + table_ + " SET " + setClause + " WHERE id=?";
+      static_assert(std::is_same_v<detail::member_owner_t<Key>, T> &&
+                        std::is_same_v<detail::member_owner_t<Value>, T>,
+                    "BaseRepository: aggregate column belongs to another entity");
 
-      vix::db::PooledConn conn(pool_);
-      auto st = conn.get().prepare(sql);
+      const std::string_view key = Column<Key>::name;
 
-      bindFields(*st, fields);
-      st->bind(fields.size() + 1, id);
+      std::string select(key);
+      select.append(", ").append(detail::aggregate_sql(fn));
+      select.append("(").append(Column<Value>::name).append(")");
 
-      return st->exec();
+      std::string tail = " GROUP BY ";
+      tail.append(key).append(" ORDER BY ").append(key);
+
+      FlatMap<K, V> out;
+      selectRows(select, where, tail, [&](const auto &row)
+                     {
+                       auto value = read_column<std::optional<V>>(row, 1);
+                       if (!value)
+                       {
+                         return;
+                       }
+
+                       if constexpr (detail::is_optional<K>::value)
+                       {
+                         out.emplace_back(read_column<K>(row, 0), std::move(*value));
+                       }
+                       else if (!row.isNull(0))
+                       {
+                         out.emplace_back(read_column<K>(row, 0), std::move(*value));
+                       } });
+      return out;
+    }
+
+    std::shared_ptr<const std::vector<CounterCache>> counterCaches() const
+    {
+      std::lock_guard<std::mutex> lock(state_->mutex);
+      return state_->counterCaches;
     }
 
     /**
-     * @brief Delete an entity by primary key.
-     *
-     * @param id Primary key value.
-     * @return Number of affected rows.
+     * @brief Count an inserted row against each parent it references.
      */
-    std::uint64_t removeById(std::int64_t id)
+    static void countInsert(const std::vector<CounterCache> &caches,
+                            const FieldValues &fields,
+                            detail::CounterDeltas &deltas)
     {
-      const std::string sql =
-          "DELETE FROM " + table_ + " WHERE id = ?";
+      deltas.resize(caches.size());
+      for (std::size_t i = 0; i < caches.size(); ++i)
+      {
+        if (auto parent = detail::integer_field(fields, caches[i].foreignKey))
+        {
+          deltas[i][*parent] += 1;
+        }
+      }
+    }
 
-      vix::db::PooledConn conn(pool_);
-      auto st = conn.get().prepare(sql);
-      st->bind(1, id);
+    /**
+     * @brief Issue one UPDATE per parent with a non-zero delta.
+     */
+    static void applyCounters(vix::db::Connection &conn,
+                              const std::vector<CounterCache> &caches,
+                              const detail::CounterDeltas &deltas)
+    {
+      for (std::size_t i = 0; i < caches.size() && i < deltas.size(); ++i)
+      {
+        const CounterCache &c = caches[i];
+        const std::string sql = "UPDATE " + c.parentTable + " SET " + c.counterColumn +
+                                " = " + c.counterColumn + " + ? WHERE " + c.parentKey + " = ?";
 
-      return st->exec();
+        for (const auto &[parent, delta] : deltas[i])
+        {
+          if (delta == 0)
+          {
+            continue;
+          }
+
+          auto st = conn.prepare(sql);
+          st->bind(1, delta);
+          st->bind(2, parent);
+          st->exec();
+        }
+      }
     }
 
     /**
-     * @brief Delete all rows from the table.
-     *
-     * @return Number of affected rows.
+     * @brief Run @p fn on a connection, inside a transaction when counter
+     * caches must be updated atomically with the write.
      */
-    std::uint64_t removeAll()
+    template <class Fn>
+    auto writeWithCounters(Fn &&fn)
     {
-      const std::string sql = "DELETE FROM " + table_;
+      const auto caches = counterCaches();
+      if (!caches || caches->empty())
+      {
+        vix::db::PooledConn conn(pool_);
+        detail::CounterDeltas ignored;
+        return fn(conn.get(), static_cast<const std::vector<CounterCache> *>(nullptr), ignored);
+      }
+
+      vix::db::Transaction tx(pool_);
+      detail::CounterDeltas deltas;
+      auto result = fn(tx.conn(), caches.get(), deltas);
+      applyCounters(tx.conn(), *caches, deltas);
+      tx.commit();
+      return result;
+    }
+
+    /**
+     * @brief DELETE matching rows and decrement their parents' counters.
+     *
+     * Selects the ids of the rows first, then deletes them by id in the
+     * same transaction. Only rows this call deleted are counted: from
+     * DELETE ... RETURNING where supported, from the SELECT on MySQL
+     * where FOR UPDATE locks the rows until commit, and otherwise by
+     * deleting row by row so a row removed concurrently is skipped.
+     */
+    std::uint64_t removeCounted(const QueryBuilder *where,
+                                std::optional<std::size_t> limit,
+                                const std::vector<CounterCache> &caches)
+    {
+      vix::db::Transaction tx(pool_);
+      vix::db::Connection &conn = tx.conn();
+
+      const DialectInfo info = dialect(conn);
+      const bool returning = info.supportsUpdateReturning();
+      const bool locked = !returning && info.kind == Dialect::MySQL;
+
+      std::string keys;
+      for (const auto &c : caches)
+      {
+        keys.append(keys.empty() ? "" : ", ").append(c.foreignKey);
+      }
+
+      std::string sql = "SELECT id";
+      if (!returning)
+      {
+        sql.append(", ").append(keys);
+      }
+      sql.append(" FROM ").append(table_);
+      if (where)
+      {
+        sql.append(" WHERE ").append(where->sql());
+      }
+      if (limit)
+      {
+        sql.append(" LIMIT ").append(std::to_string(*limit));
+      }
+      if (locked)
+      {
+        sql.append(" FOR UPDATE");
+      }
+
+      detail::CounterDeltas deltas(caches.size());
+      const auto countRemoved = [&](const vix::db::ResultRow &row, std::size_t first)
+      {
+        for (std::size_t i = 0; i < caches.size(); ++i)
+        {
+          if (!row.isNull(first + i))
+          {
+            deltas[i][row.getInt64(first + i)] -= 1;
+          }
+        }
+      };
+
+      std::vector<std::int64_t> ids;
+      std::vector<std::vector<std::optional<std::int64_t>>> parents;
+      {
+        auto st = conn.prepare(sql);
+        if (where)
+        {
+          where->bind(*st);
+        }
+
+        auto rs = st->query();
+        while (rs && rs->next())
+        {
+          const auto &row = rs->row();
+          ids.push_back(row.getInt64(0));
+          if (locked)
+          {
+            countRemoved(row, 1);
+          }
+          else if (!returning)
+          {
+            auto &keysOfRow = parents.emplace_back(caches.size());
+            for (std::size_t i = 0; i < caches.size(); ++i)
+            {
+              if (!row.isNull(i + 1))
+              {
+                keysOfRow[i] = row.getInt64(i + 1);
+              }
+            }
+          }
+        }
+      }
+
+      std::uint64_t affected = 0;
+      if (returning || locked)
+      {
+        for (std::size_t begin = 0; begin < ids.size(); begin += max_bind_params)
+        {
+          const std::size_t end = std::min(ids.size(), begin + max_bind_params);
+
+          std::string del = "DELETE FROM " + table_ + " WHERE id IN (" +
+                            buildInsertPlaceholders(end - begin) + ")";
+          if (returning)
+          {
+            del.append(" RETURNING ").append(keys);
+          }
+
+          auto st = conn.prepare(del);
+          for (std::size_t i = begin; i < end; ++i)
+          {
+            st->bind(i - begin + 1, ids[i]);
+          }
+
+          if (!returning)
+          {
+            affected += st->exec();
+            continue;
+          }
+
+          auto rs = st->query();
+          while (rs && rs->next())
+          {
+            countRemoved(rs->row(), 0);
+            ++affected;
+          }
+        }
+      }
+      else
+      {
+        const std::string del = "DELETE FROM " + table_ + " WHERE id = ?";
+        for (std::size_t r = 0; r < ids.size(); ++r)
+        {
+          auto st = conn.prepare(del);
+          st->bind(1, ids[r]);
+          if (st->exec() == 0)
+          {
+            continue;
+          }
+
+          ++affected;
+          for (std::size_t i = 0; i < caches.size(); ++i)
+          {
+            if (parents[r][i])
+            {
+              deltas[i][*parents[r][i]] -= 1;
+            }
+          }
+        }
+      }
+
+      applyCounters(conn, caches, deltas);
+      tx.commit();
+
+      adjustCount(-static_cast<std::int64_t>(affected));
+      return affected;
+    }
+
+    /**
+     * @brief SELECT <Mapper<Dto>::columns> FROM table.
+     */
+    template <class Dto>
+    std::string projectionSelect(const char *context) const
+    {
+      std::string sql = "SELECT ";
+      bool first = true;
+      for (std::string_view column : Mapper<Dto>::columns)
+      {
+        detail::require_identifier(column, context);
+        if (!first)
+        {
+          sql += ", ";
+        }
+        sql.append(column);
+        first = false;
+      }
+
+      if (first)
+      {
+        throw vix::db::DBError(std::string("BaseRepository: empty projection in ") + context);
+      }
+
+      sql.append(" FROM ").append(table_);
+      return sql;
+    }
+
+    /**
+     * @brief Apply a row-count delta to the tracked count, if any.
+     */
+    void adjustCount(std::int64_t delta)
+    {
+      std::lock_guard<std::mutex> lock(state_->mutex);
+      if (state_->trackCount && state_->rowCount)
+      {
+        state_->rowCount = std::max<std::int64_t>(0, *state_->rowCount + delta);
+      }
+    }
+
+    /**
+     * @brief Row count from planner statistics, if the database has any.
+     *
+     * SQLite: largest first figure of the table's sqlite_stat1 rows
+     * (maintained by ANALYZE); malformed figures are skipped.
+     * MySQL: information_schema.TABLES.TABLE_ROWS.
+     */
+    std::optional<std::uint64_t> statsRowCount(vix::db::Connection &conn)
+    {
+      const Dialect kind = dialect(conn).kind;
+
+      try
+      {
+        if (kind == Dialect::SQLite)
+        {
+          // One row per index, plus an idx IS NULL row when the table has
+          // no full index. Full indexes and the NULL row hold the table
+          // count; partial indexes hold less, so keep the largest figure.
+          auto st = conn.prepare("SELECT stat FROM sqlite_stat1 WHERE tbl = ?");
+          st->bind(1, table_);
+
+          auto rs = st->query();
+          std::optional<std::uint64_t> rows;
+          while (rs && rs->next())
+          {
+            if (rs->row().isNull(0))
+            {
+              continue;
+            }
+
+            const std::string stat = rs->row().getString(0);
+            std::uint64_t n = 0;
+            const auto res = std::from_chars(stat.data(), stat.data() + stat.size(), n);
+            if (res.ec != std::errc{})
+            {
+              continue;
+            }
+
+            rows = rows ? std::max(*rows, n) : n;
+          }
+
+          return rows;
+        }
+
+        if (kind == Dialect::MySQL)
+        {
+          const auto dot = table_.find('.');
+
+          std::string sql = "SELECT TABLE_ROWS FROM information_schema.TABLES WHERE TABLE_SCHEMA = ";
+          sql += (dot == std::string::npos) ? "DATABASE()" : "?";
+          sql += " AND TABLE_NAME = ?";
+
+          auto st = conn.prepare(sql);
+          if (dot == std::string::npos)
+          {
+            st->bind(1, table_);
+          }
+          else
+          {
+            st->bind(1, table_.substr(0, dot));
+            st->bind(2, table_.substr(dot + 1));
+          }
+
+          auto rs = st->query();
+          if (!rs || !rs->next() || rs->row().isNull(0))
+          {
+            return std::nullopt;
+          }
+
+          return static_cast<std::uint64_t>(rs->row().getInt64(0));
+        }
+      }
+      catch (const vix::db::DBError &)
+      {
+        // No statistics table (SQLite before the first ANALYZE) or no
+        // access to information_schema: fall back to the caller.
+      }
+
+      return std::nullopt;
+    }
+
+    static std::optional<std::int64_t>
+    assignId(FieldValues &fields, const std::shared_ptr<IdGenerator> &generator)
+    {
+      const auto it = std::find_if(fields.begin(), fields.end(), [](const FieldValue &f)
+                                   { return f.first == "id"; });
+
+      if (auto id = detail::explicit_id(fields))
+      {
+        // A std::optional id has no DbValue conversion: bind the integer.
+        it->second = *id;
+        return id;
+      }
+
+      if (!generator)
+      {
+        return std::nullopt;
+      }
+
+      // A mapper may emit "id" as nullopt or another placeholder: replace
+      // it rather than inserting a second id column.
+      const std::int64_t id = generator->next();
+      if (it != fields.end())
+      {
+        it->second = id;
+      }
+      else
+      {
+        fields.insert(fields.begin(), FieldValue{"id", id});
+      }
+      return id;
+    }
+
+    /**
+     * @brief Run the INSERT for @p fields and return the row's id.
+     *
+     * @param id Id chosen by assignId(), or nullopt for a database-side id.
+     */
+    std::int64_t insertRow(vix::db::Connection &conn,
+                           const FieldValues &fields,
+                           std::optional<std::int64_t> id) const
+    {
+      auto st = conn.prepare(insertSql(fields));
+      bindFields(*st, fields);
+      st->exec();
+
+      return id ? *id : static_cast<std::int64_t>(conn.lastInsertId());
+    }
+
+    static bool sameColumns(const FieldValues &a, const FieldValues &b)
+    {
+      if (a.size() != b.size())
+      {
+        return false;
+      }
+
+      for (std::size_t i = 0; i < a.size(); ++i)
+      {
+        if (a[i].first != b[i].first)
+        {
+          return false;
+        }
+      }
+
+      return true;
+    }
+
+    /**
+     * @brief Return "UPDATE table SET a=?,b=? WHERE id=?" for a column set.
+     *
+     * Versioned mappers also get the version increment.
+     *
+     * Statements are cached by column set, so repeated partial updates
+     * of the same columns reuse one SQL string.
+     *
+     * @param count Number of columns.
+     * @param name Callable returning the i-th column name.
+     */
+    template <class NameAt>
+    std::shared_ptr<const std::string> cachedUpdateSql(std::size_t count, NameAt name)
+    {
+      std::uint64_t key = detail::fnv1a_basis;
+      for (std::size_t i = 0; i < count; ++i)
+      {
+        key = detail::fnv1a_update(key, name(i));
+        key = detail::fnv1a_update(key, ",");
+      }
+
+      const auto matches = [&](const detail::RepositoryState::CachedSql &c)
+      {
+        if (c.columns.size() != count)
+        {
+          return false;
+        }
+        for (std::size_t i = 0; i < count; ++i)
+        {
+          if (c.columns[i] != name(i))
+          {
+            return false;
+          }
+        }
+        return true;
+      };
+
+      {
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        const auto it = state_->updateSql.find(key);
+        if (it != state_->updateSql.end() && matches(it->second))
+        {
+          return it->second.sql;
+        }
+      }
+
+      detail::RepositoryState::CachedSql entry;
+      entry.columns.reserve(count);
+
+      std::string sql = "UPDATE " + table_ + " SET ";
+      for (std::size_t i = 0; i < count; ++i)
+      {
+        entry.columns.emplace_back(name(i));
+        sql += entry.columns.back();
+        sql += (i + 1 < count) ? "=?," : "=?";
+      }
+      appendVersionBump(sql);
+      sql += " WHERE id=?";
+
+      entry.sql = std::make_shared<const std::string>(std::move(sql));
+      auto out = entry.sql;
+
+      std::lock_guard<std::mutex> lock(state_->mutex);
+      if (state_->updateSql.size() < detail::RepositoryState::max_cached_sql)
+      {
+        state_->updateSql.emplace(key, std::move(entry));
+      }
+
+      return out;
+    }
+
+    static void bindFields(vix::db::Statement &st,
+                           const FieldValues &fields,
+                           std::size_t startIndex = 1)
+    {
+      std::size_t index = startIndex;
+      for (const auto &field : fields)
+      {
+        st.bind(index++, any_to_dbvalue_or_throw(field.second));
+      }
+    }
+
+  public:
+    /**
+     * @brief Maximum bind parameters per generated batch statement.
+     *
+     * Matches SQLite's historical SQLITE_MAX_VARIABLE_NUMBER default.
+     */
+    static constexpr std::size_t max_bind_params = 999;
+
+    /**
+     * @brief Construct a repository bound to a table.
+     *
+     * @param pool  Connection pool used for queries.
+     * @param table Database table name.
+     */
+    BaseRepository(vix::db::ConnectionPool &pool, std::string table)
+        : pool_(pool), table_(std::move(table))
+    {
+      if (table_.empty())
+      {
+        throw std::runtime_error("BaseRepository: table name cannot be empty");
+      }
+    }
+
+    /**
+     * @brief Return the database table name used by this repository.
+     *
+     * @return Table name.
+     */
+    const std::string &table() const noexcept
+    {
+      return table_;
+    }
+
+    /**
+     * @brief Access the underlying connection pool.
+     *
+     * @return Connection pool reference.
+     */
+    vix::db::ConnectionPool &pool() noexcept
+    {
+      return pool_;
+    }
+
+    /**
+     * @brief Access the underlying connection pool (const).
+     *
+     * @return Connection pool reference.
+     */
+    const vix::db::ConnectionPool &pool() const noexcept
+    {
+      return pool_;
+    }
+
+    /**
+     * @brief Insert a new entity.
+     *
+     * Uses Mapper<T>::toInsertFields to generate the INSERT statement.
+     *
+     * @param value Entity instance.
+     * @return Generated primary key.
+     */
+    std::uint64_t create(const T &value)
+    {
+      auto fields = Mapper<T>::toInsertFields(value);
+      ensureNotEmpty(fields, "create");
+
+      const auto id = assignId(fields, idGenerator());
+
+      const std::uint64_t created = writeWithCounters(
+          [&](vix::db::Connection &conn, const std::vector<CounterCache> *caches,
+              detail::CounterDeltas &deltas)
+          {
+            const std::int64_t inserted = insertRow(conn, fields, id);
+
+            if (caches)
+            {
+              countInsert(*caches, fields, deltas);
+            }
+
+            return static_cast<std::uint64_t>(inserted);
+          });
+
+      adjustCount(1);
+      return created;
+    }
+
+    /**
+     * @brief Install a client-side id generator.
+     *
+     * When set, create(), createMany() and createReturning() generate
+     * the primary key for entities whose mapper does not provide an "id"
+     * field, instead of relying on lastInsertId(). Pass nullptr to restore database-side
+     * ids. Shared by copies of this repository.
+     *
+     * @param generator Id generator, or nullptr.
+     */
+    void setIdGenerator(std::shared_ptr<IdGenerator> generator)
+    {
+      std::lock_guard<std::mutex> lock(state_->mutex);
+      state_->ids = std::move(generator);
+    }
+
+    /**
+     * @brief Return the installed id generator, if any.
+     *
+     * @return Id generator, or nullptr.
+     */
+    std::shared_ptr<IdGenerator> idGenerator() const
+    {
+      std::lock_guard<std::mutex> lock(state_->mutex);
+      return state_->ids;
+    }
+
+    /**
+     * @brief Maintain a parent counter column from this (child) repository.
+     *
+     * Subsequent create(), createMany(), createReturning() and remove*
+     * calls update the parent counter in the same transaction. The
+     * foreign key is read from Mapper<T>::toInsertFields on create and
+     * from the table on remove. Shared by copies of this repository.
+     *
+     * Example:
+     * @code
+     * orders.addCounterCache({"users", "user_id", "orders_count"});
+     * @endcode
+     *
+     * @param cache Counter cache declaration.
+     */
+    void addCounterCache(CounterCache cache)
+    {
+      detail::require_identifier(cache.parentTable, "addCounterCache");
+      detail::require_identifier(cache.foreignKey, "addCounterCache");
+      detail::require_identifier(cache.counterColumn, "addCounterCache");
+      detail::require_identifier(cache.parentKey, "addCounterCache");
+
+      std::lock_guard<std::mutex> lock(state_->mutex);
+      auto next = state_->counterCaches
+                      ? std::make_shared<std::vector<CounterCache>>(*state_->counterCaches)
+                      : std::make_shared<std::vector<CounterCache>>();
+      next->push_back(std::move(cache));
+      state_->counterCaches = std::move(next);
+    }
+
+    /**
+     * @brief Remove all counter caches from this repository.
+     */
+    void clearCounterCaches()
+    {
+      std::lock_guard<std::mutex> lock(state_->mutex);
+      state_->counterCaches.reset();
+    }
+
+    /**
+     * @brief Reserve a new primary key before insertion.
+     *
+     * Lets callers assign ids to a whole object graph (parents and the
+     * children referencing them) before writing it. The mapper must
+     * then include the "id" field in toInsertFields.
+     *
+     * @return New identifier.
+     *
+     * @throws vix::db::DBError if no id generator is installed.
+     */
+    std::int64_t nextId()
+    {
+      auto generator = idGenerator();
+      if (!generator)
+      {
+        throw vix::db::DBError("BaseRepository: no id generator installed for " + table_);
+      }
+      return generator->next();
+    }
+
+    /**
+     * @brief Insert several entities with multi-row INSERT statements.
+     *
+     * Rows are written in chunks of at most max_bind_params parameters
+     * per statement, all inside one transaction. Every entity must map
+     * to the same column list.
+     *
+     * @param values Entities to insert.
+     * @return Ids of the inserted rows in input order when known
+     *         (mapper-provided or generated), otherwise an empty vector.
+     */
+    std::vector<std::int64_t> createMany(const std::vector<T> &values)
+    {
+      if (values.empty())
+      {
+        return {};
+      }
+
+      const auto generator = idGenerator();
+
+      std::vector<FieldValues> rows;
+      rows.reserve(values.size());
+
+      std::vector<std::int64_t> ids;
+      ids.reserve(values.size());
+      bool idsKnown = true;
+
+      for (const auto &value : values)
+      {
+        auto fields = Mapper<T>::toInsertFields(value);
+        ensureNotEmpty(fields, "createMany");
+
+        const auto id = assignId(fields, generator);
+        idsKnown = idsKnown && id.has_value();
+        if (id)
+        {
+          ids.push_back(*id);
+        }
+
+        if (!rows.empty() && !sameColumns(rows.front(), fields))
+        {
+          throw vix::db::DBError("BaseRepository: createMany requires identical column lists");
+        }
+
+        rows.push_back(std::move(fields));
+      }
+
+      const std::size_t columns = rows.front().size();
+      const std::size_t perStatement = std::max<std::size_t>(1, max_bind_params / columns);
+      const std::string prefix = "INSERT INTO " + table_ + " (" +
+                                 buildInsertColumns(rows.front()) + ") VALUES ";
+      const std::string tuple = "(" + buildInsertPlaceholders(columns) + ")";
+
+      const auto caches = counterCaches();
+      detail::CounterDeltas deltas;
+      if (caches)
+      {
+        for (const auto &fields : rows)
+        {
+          countInsert(*caches, fields, deltas);
+        }
+      }
+
+      vix::db::Transaction tx(pool_);
+
+      for (std::size_t begin = 0; begin < rows.size(); begin += perStatement)
+      {
+        const std::size_t end = std::min(rows.size(), begin + perStatement);
+
+        std::string sql = prefix;
+        sql.reserve(prefix.size() + (end - begin) * (tuple.size() + 1));
+        for (std::size_t i = begin; i < end; ++i)
+        {
+          if (i != begin)
+          {
+            sql += ",";
+          }
+          sql += tuple;
+        }
+
+        auto st = tx.conn().prepare(sql);
+        std::size_t index = 1;
+        for (std::size_t i = begin; i < end; ++i)
+        {
+          bindFields(*st, rows[i], index);
+          index += columns;
+        }
+        st->exec();
+      }
+
+      if (caches)
+      {
+        applyCounters(tx.conn(), *caches, deltas);
+      }
+
+      tx.commit();
+      adjustCount(static_cast<std::int64_t>(rows.size()));
+
+      if (!idsKnown)
+      {
+        ids.clear();
+      }
+
+      return ids;
+    }
+
+    /**
+     * @brief Return the SQL dialect of the underlying pool.
+     *
+     * Detected once on first use and shared by copies of this
+     * repository.
+     *
+     * @param conn Connection used for detection if needed.
+     * @return Dialect information.
+     */
+    DialectInfo dialect(vix::db::Connection &conn)
+    {
+      std::lock_guard<std::mutex> lock(state_->mutex);
+      if (!state_->dialect)
+      {
+        state_->dialect = detect_dialect(conn);
+      }
+      return *state_->dialect;
+    }
+
+    /**
+     * @brief Declare the SQL dialect explicitly and skip detection.
+     *
+     * @param info Dialect information.
+     */
+    void setDialect(const DialectInfo &info)
+    {
+      std::lock_guard<std::mutex> lock(state_->mutex);
+      state_->dialect = info;
+    }
+
+    /**
+     * @brief Insert a new entity and return the stored row.
+     *
+     * The returned value includes database-generated columns (primary
+     * key, defaults, computed columns). On engines supporting it the
+     * statement is a single INSERT ... RETURNING *; elsewhere the row is
+     * re-read on the same connection by the id create() would return:
+     * the mapper's or generator's id when set, lastInsertId() otherwise.
+     *
+     * @param value Entity instance.
+     * @return Entity as stored in the database.
+     */
+    T createReturning(const T &value)
+    {
+      auto fields = Mapper<T>::toInsertFields(value);
+      ensureNotEmpty(fields, "createReturning");
+
+      const auto id = assignId(fields, idGenerator());
+
+      T created = writeWithCounters(
+          [&](vix::db::Connection &conn, const std::vector<CounterCache> *caches,
+              detail::CounterDeltas &deltas)
+          {
+            if (caches)
+            {
+              countInsert(*caches, fields, deltas);
+            }
+
+            if (dialect(conn).supportsInsertReturning())
+            {
+              auto st = conn.prepare(insertSql(fields) + " RETURNING *");
+              bindFields(*st, fields);
+
+              auto rs = st->query();
+              if (!rs || !rs->next())
+              {
+                throw vix::db::DBError("BaseRepository: INSERT ... RETURNING produced no row");
+              }
+
+              return Mapper<T>::fromRow(rs->row());
+            }
+
+            auto row = selectById(conn, insertRow(conn, fields, id));
+            if (!row)
+            {
+              throw vix::db::DBError("BaseRepository: inserted row not found in createReturning");
+            }
+
+            return std::move(*row);
+          });
+
+      adjustCount(1);
+      return created;
+    }
+
+    /**
+     * @brief Update an entity by primary key and return the stored row.
+     *
+     * Uses UPDATE ... RETURNING * where supported, otherwise re-reads
+     * the row on the same connection after the update. Versioned
+     * entities are checked like in updateById().
+     *
+     * @param id    Primary key value.
+     * @param value Entity instance.
+     * @return Updated entity, or std::nullopt if no row matched.
+     *
+     * @throws OptimisticLockError if the row exists with another version.
+     */
+    std::optional<T> updateReturning(std::int64_t id, const T &value)
+    {
+      const auto fields = entityUpdateFields(value, "updateReturning");
+
+      vix::db::PooledConn conn(pool_);
+
+      if (dialect(conn.get()).supportsUpdateReturning())
+      {
+        auto st = conn.get().prepare(entityUpdateSql(fields) + " RETURNING *");
+        bindEntityUpdate(*st, fields, id, value);
+
+        auto rs = st->query();
+        if (!rs || !rs->next())
+        {
+          rs.reset();
+          st.reset();
+          checkVersionConflict(conn.get(), id, value);
+          return std::nullopt;
+        }
+
+        return Mapper<T>::fromRow(rs->row());
+      }
+
+      auto st = conn.get().prepare(entityUpdateSql(fields));
+      bindEntityUpdate(*st, fields, id, value);
+
+      if (st->exec() == 0)
+      {
+        checkVersionConflict(conn.get(), id, value);
+        return std::nullopt;
+      }
+
+      return selectById(conn.get(), id);
+    }
+
+    /**
+     * @brief Find an entity by primary key.
+     *
+     * @param id Primary key value.
+     * @return Entity if found, otherwise std::nullopt.
+     */
+    std::optional<T> findById(std::int64_t id)
+    {
+      vix::db::PooledConn conn(pool_);
+      return selectById(conn.get(), id);
+    }
+
+    /**
+     * @brief Find entities by a list of primary keys.
+     *
+     * Issues one SELECT ... WHERE id IN (...) per @ref max_bind_params
+     * ids on a single connection. Missing ids are skipped.
+     *
+     * @param ids Primary key values.
+     * @return Found entities, in database order.
+     */
+    std::vector<T> findByIds(const std::vector<std::int64_t> &ids)
+    {
+      std::vector<T> out;
+      if (ids.empty())
+      {
+        return out;
+      }
+      out.reserve(ids.size());
+
+      vix::db::PooledConn conn(pool_);
+
+      for (std::size_t begin = 0; begin < ids.size(); begin += max_bind_params)
+      {
+        const std::size_t end = std::min(ids.size(), begin + max_bind_params);
+
+        std::string sql = "SELECT * FROM " + table_ + " WHERE id IN (";
+        sql += buildInsertPlaceholders(end - begin);
+        sql += ")";
+
+        auto st = conn.get().prepare(sql);
+        for (std::size_t i = begin; i < end; ++i)
+        {
+          st->bind(i - begin + 1, ids[i]);
+        }
+
+        auto rs = st->query();
+        while (rs && rs->next())
+        {
+          out.push_back(Mapper<T>::fromRow(rs->row()));
+        }
+      }
+
+      return out;
+    }
+
+    /**
+     * @brief Return all rows from the table.
+     *
+     * @return Vector of materialized entities.
+     */
+    std::vector<T> findAll()
+    {
+      const std::string sql = "SELECT * FROM " + table_;
+
+      vix::db::PooledConn conn(pool_);
+      auto st = conn.get().prepare(sql);
+      auto rs = st->query();
+
+      std::vector<T> out;
+      while (rs && rs->next())
+      {
+        out.push_back(Mapper<T>::fromRow(rs->row()));
+      }
+
+      return out;
+    }
+
+    /**
+     * @brief Return one page of rows ordered by a mapped column.
+     *
+     * Runs SELECT * ... ORDER BY <column>, id LIMIT ... OFFSET ...; the
+     * primary key breaks ties so pages are stable.
+     *
+     * Example:
+     * @code
+     * auto recent = orders.findPage<&Order::createdAt>({20, 40, true});
+     * @endcode
+     *
+     * @tparam Member Pointer to a data member of T with a Column<> mapping.
+     * @param page Limit, offset and direction.
+     * @param where Optional WHERE predicate fragment.
+     * @return Rows of the page in order.
+     */
+    template <auto Member>
+    std::vector<T> findPage(const PageRequest &page, const QueryBuilder &where = QueryBuilder{})
+    {
+      static_assert(std::is_same_v<detail::member_owner_t<Member>, T>,
+                    "BaseRepository::findPage: column belongs to another entity");
+
+      std::vector<T> out;
+      if (page.limit == 0)
+      {
+        return out;
+      }
+      out.reserve(page.limit);
+
+      const char *direction = page.descending ? " DESC" : " ASC";
+
+      std::string tail = " ORDER BY ";
+      tail.append(Column<Member>::name).append(direction);
+      tail.append(", id").append(direction);
+      tail.append(" LIMIT ").append(std::to_string(page.limit));
+      tail.append(" OFFSET ").append(std::to_string(page.offset));
+
+      selectRows("*", where, tail, [&](const vix::db::ResultRow &row)
+                 { out.push_back(Mapper<T>::fromRow(row)); });
+
+      return out;
+    }
+
+    /**
+     * @brief Find a projection of an entity by primary key.
+     *
+     * Issues SELECT with only the columns declared by Mapper<Dto>
+     * (see ProjectionMapper), so wide rows are not transferred or
+     * materialized when a caller needs a few fields.
+     *
+     * @tparam Dto Projection type.
+     * @param id Primary key value.
+     * @return Projection if found, std::nullopt otherwise.
+     */
+    template <ProjectionMapper Dto>
+    std::optional<Dto> findByIdAs(std::int64_t id)
+    {
+      const std::string sql = projectionSelect<Dto>("findByIdAs") + " WHERE id = ? LIMIT 1";
+
+      vix::db::PooledConn conn(pool_);
+      auto st = conn.get().prepare(sql);
+      st->bind(1, id);
+
+      auto rs = st->query();
+      if (!rs || !rs->next())
+      {
+        return std::nullopt;
+      }
+
+      return Mapper<Dto>::fromRow(rs->row());
+    }
+
+    /**
+     * @brief Load a projection of every row.
+     *
+     * Example:
+     * @code
+     * auto rows = users.findAllAs<UserSummary>();
+     * @endcode
+     *
+     * @tparam Dto Projection type.
+     * @return Vector of projections.
+     */
+    template <ProjectionMapper Dto>
+    std::vector<Dto> findAllAs()
+    {
+      const std::string sql = projectionSelect<Dto>("findAllAs");
+
+      vix::db::PooledConn conn(pool_);
+      auto st = conn.get().prepare(sql);
+      auto rs = st->query();
+
+      std::vector<Dto> out;
+      while (rs && rs->next())
+      {
+        out.push_back(Mapper<Dto>::fromRow(rs->row()));
+      }
+
+      return out;
+    }
+
+    /**
+     * @brief Visit matching rows through RowView instances.
+     *
+     * Runs SELECT * [WHERE ...] and calls @p fn once per row without
+     * materializing T. Text and blob views passed to @p fn are valid
+     * only during the call. Combined with Mapper<T>::visitRow (see
+     * VisitableMapper), this lets serialization loops skip building
+     * entities.
+     *
+     * Example:
+     * @code
+     * users.scan([&](const vix::orm::RowView &row)
+     *            { vix::orm::Mapper<User>::visitRow(row, writer); });
+     * @endcode
+     *
+     * @param where Optional WHERE predicate fragment.
+     * @param fn    Callback invoked as fn(const RowView &).
+     * @return Number of rows visited.
+     */
+    template <class Fn>
+      requires std::invocable<Fn &, const RowView &>
+    std::size_t scan(const QueryBuilder &where, Fn &&fn)
+    {
+      std::vector<std::string> scratch;
+      std::size_t rows = 0;
+
+      selectRows("*", where, "", [&](const vix::db::ResultRow &row)
+                 {
+                   fn(RowView(row, scratch));
+                   ++rows; });
+
+      return rows;
+    }
+
+    /**
+     * @brief Visit every row through RowView instances.
+     *
+     * @param fn Callback invoked as fn(const RowView &).
+     * @return Number of rows visited.
+     */
+    template <class Fn>
+      requires std::invocable<Fn &, const RowView &>
+    std::size_t scan(Fn &&fn)
+    {
+      return scan(QueryBuilder{}, std::forward<Fn>(fn));
+    }
+
+    /**
+     * @brief Stream matching rows as a JSON array of objects.
+     *
+     * Rows go from the result set straight into the writer through
+     * Mapper<T>::visitRow, using the mapper's field names; no T and no
+     * intermediate JSON tree. The writer flushes in chunks, so large
+     * results stream with bounded memory.
+     *
+     * Example (envelope around the array):
+     * @code
+     * std::string body;
+     * vix::orm::JsonWriter json(body);
+     * json.beginObject();
+     * json("ok", true);
+     * json.key("data");
+     * const auto count = users.writeJson(json);
+     * json("count", static_cast<std::int64_t>(count));
+     * json.endObject();
+     * json.flush();
+     * @endcode
+     *
+     * @param json  Writer positioned where a value is expected.
+     * @param where Optional WHERE predicate fragment.
+     * @return Number of rows written.
+     */
+    std::size_t writeJson(JsonWriter &json, const QueryBuilder &where = QueryBuilder{})
+      requires VisitableMapper<T>
+    {
+      json.beginArray();
+      const std::size_t rows = scan(where, [&](const RowView &row)
+                                    {
+                                      json.beginObject();
+                                      Mapper<T>::visitRow(row, json);
+                                      json.endObject(); });
+      json.endArray();
+
+      return rows;
+    }
+
+    /**
+     * @brief Stream matching rows as a JSON array into @p out.
+     *
+     * @param out   std::string, std::ostream or JsonWriter::Sink callback
+     *              receiving chunks.
+     * @param where Optional WHERE predicate fragment.
+     * @return Number of rows written.
+     */
+    template <class Out>
+      requires VisitableMapper<T> && std::constructible_from<JsonWriter, Out &>
+    std::size_t writeJson(Out &out, const QueryBuilder &where = QueryBuilder{})
+    {
+      JsonWriter json(out);
+      const std::size_t rows = writeJson(json, where);
+      json.flush();
+
+      return rows;
+    }
+
+    /**
+     * @brief Load selected columns into per-column contiguous arrays.
+     *
+     * Runs SELECT col1, col2, ... [WHERE ...] and appends each row
+     * directly into the column arrays, without building T or per-row
+     * strings. Suited to reporting scans over many rows.
+     *
+     * @tparam Members Pointers to data members of T.
+     * @param where Optional WHERE predicate fragment.
+     * @return Columnar result.
+     */
+    template <auto... Members>
+    Columnar<Members...> findAllColumnar(const QueryBuilder &where = QueryBuilder{})
+    {
+      static_assert(sizeof...(Members) > 0, "BaseRepository::findAllColumnar: no columns");
+      static_assert((std::is_same_v<detail::member_owner_t<Members>, T> && ...),
+                    "BaseRepository::findAllColumnar: column belongs to another entity");
+
+      std::string select;
+      ((select.append(select.empty() ? "" : ", ").append(Column<Members>::name)), ...);
+
+      Columnar<Members...> out;
+      std::vector<std::string> scratch;
+
+      selectRows(select, where, "", [&](const vix::db::ResultRow &row)
+                 { out.append(RowView(row, scratch)); });
+
+      return out;
+    }
+
+    /**
+     * @brief Check whether an entity exists for a given primary key.
+     *
+     * @param id Primary key value.
+     * @return true if a row exists, false otherwise.
+     */
+    bool existsById(std::int64_t id)
+    {
+      const std::string sql =
+          "SELECT id FROM " + table_ + " WHERE id = ? LIMIT 1";
+
+      vix::db::PooledConn conn(pool_);
+      auto st = conn.get().prepare(sql);
+      st->bind(1, id);
+
+      auto rs = st->query();
+      return rs && rs->next();
+    }
+
+    /**
+     * @brief Count all rows in the table.
+     *
+     * @return Total number of rows.
+     */
+    std::uint64_t count()
+    {
+      const std::string sql = "SELECT COUNT(*) FROM " + table_;
+
+      vix::db::PooledConn conn(pool_);
+      auto st = conn.get().prepare(sql);
+      auto rs = st->query();
+
+      if (!rs || !rs->next())
+      {
+        return 0;
+      }
+
+      return static_cast<std::uint64_t>(rs->row().getInt64(0));
+    }
+
+    /**
+     * @brief Cheap row-count estimate from planner statistics.
+     *
+     * Reads sqlite_stat1 (refreshed by ANALYZE) on SQLite and
+     * information_schema.TABLES.TABLE_ROWS on MySQL, both without
+     * touching the table. The value can lag behind reality; use it
+     * for dashboards and pagination hints, not invariants.
+     *
+     * When no statistics exist, falls back to the tracked exact count
+     * (see trackCount()) and finally to count().
+     *
+     * @return Approximate number of rows.
+     */
+    std::uint64_t estimateCount()
+    {
+      {
+        vix::db::PooledConn conn(pool_);
+        if (auto n = statsRowCount(conn.get()))
+        {
+          return *n;
+        }
+      }
+
+      {
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        if (state_->trackCount && state_->rowCount)
+        {
+          return static_cast<std::uint64_t>(*state_->rowCount);
+        }
+      }
+
+      return count();
+    }
+
+    /**
+     * @brief Maintain an exact row count in memory.
+     *
+     * The count is loaded with COUNT(*) on first use, then adjusted by
+     * this repository's creates and removes (shared by all copies of
+     * the repository). Writes made elsewhere (raw SQL, other processes)
+     * are picked up by reconciliation, which re-runs COUNT(*) once
+     * @p reconcileEvery has elapsed.
+     *
+     * @param reconcileEvery Maximum age of the count before reconciling.
+     */
+    void trackCount(std::chrono::steady_clock::duration reconcileEvery = std::chrono::minutes(5))
+    {
+      std::lock_guard<std::mutex> lock(state_->mutex);
+      state_->trackCount = true;
+      state_->reconcileEvery = reconcileEvery;
+    }
+
+    /**
+     * @brief Stop maintaining the in-memory row count.
+     */
+    void untrackCount()
+    {
+      std::lock_guard<std::mutex> lock(state_->mutex);
+      state_->trackCount = false;
+      state_->rowCount.reset();
+    }
+
+    /**
+     * @brief Return the tracked exact row count.
+     *
+     * Without trackCount() this is count(). Otherwise the in-memory
+     * value is returned, reconciling first when it is missing or older
+     * than the configured interval.
+     *
+     * @return Number of rows.
+     */
+    std::uint64_t cachedCount()
+    {
+      {
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        if (!state_->trackCount)
+        {
+          return count();
+        }
+
+        const auto age = std::chrono::steady_clock::now() - state_->countedAt;
+        if (state_->rowCount && age < state_->reconcileEvery)
+        {
+          return static_cast<std::uint64_t>(*state_->rowCount);
+        }
+      }
+
+      return reconcileCount();
+    }
+
+    /**
+     * @brief Re-run COUNT(*) and reset the tracked count.
+     *
+     * Writes racing with the COUNT(*) may be counted twice or missed
+     * until the next reconciliation.
+     *
+     * @return Exact number of rows.
+     */
+    std::uint64_t reconcileCount()
+    {
+      const std::uint64_t n = count();
+
+      std::lock_guard<std::mutex> lock(state_->mutex);
+      if (state_->trackCount)
+      {
+        state_->rowCount = static_cast<std::int64_t>(n);
+        state_->countedAt = std::chrono::steady_clock::now();
+      }
+
+      return n;
+    }
+
+    /**
+     * @brief Count rows matching a predicate, in the database.
+     *
+     * The predicate is a QueryBuilder holding a WHERE fragment without
+     * the WHERE keyword; an empty builder counts every row.
+     *
+     * @param where WHERE predicate fragment.
+     * @return Number of matching rows.
+     */
+    std::uint64_t countWhere(const QueryBuilder &where)
+    {
+      std::uint64_t out = 0;
+      selectRows("COUNT(*)", where, "", [&](const auto &row)
+                     { out = static_cast<std::uint64_t>(row.getInt64(0)); });
+      return out;
+    }
+
+    /**
+     * @brief Run one aggregate over a named column.
+     *
+     * Untyped escape hatch for columns without a Column<> mapping.
+     *
+     * @param fn     Aggregate function.
+     * @param column Column name.
+     * @param where  Optional WHERE predicate fragment.
+     * @return Aggregate value, or std::nullopt if SQL returned NULL.
+     */
+    std::optional<double> aggregate(AggregateFn fn,
+                                    std::string_view column,
+                                    const QueryBuilder &where = QueryBuilder{})
+    {
+      detail::require_identifier(column, "aggregate");
+
+      std::string select = detail::aggregate_sql(fn);
+      select.append("(").append(column).append(")");
+
+      std::optional<double> out;
+      selectRows(select, where, "", [&](const auto &row)
+                     { out = read_column<std::optional<double>>(row, 0); });
+      return out;
+    }
+
+    /**
+     * @brief SUM of a mapped numeric column over matching rows.
+     *
+     * Integral columns sum to std::int64_t, floating ones to double.
+     *
+     * Example:
+     * @code
+     * vix::orm::QueryBuilder paid("status = ?");
+     * paid.param("paid");
+     * auto revenue = orders.sum<&Order::total>(paid);
+     * @endcode
+     *
+     * @tparam Member Pointer to a numeric data member of T.
+     * @param where Optional WHERE predicate fragment.
+     * @return Sum, 0 when no row matches.
+     */
+    template <auto Member>
+    detail::sum_t<detail::column_value_t<detail::member_value_t<Member>>>
+    sum(const QueryBuilder &where = QueryBuilder{})
+    {
+      using R = detail::sum_t<detail::column_value_t<detail::member_value_t<Member>>>;
+      static_assert(std::is_arithmetic_v<detail::column_value_t<detail::member_value_t<Member>>>,
+                    "BaseRepository::sum: column is not numeric");
+
+      return aggregateOf<R, Member>(AggregateFn::Sum, where).value_or(R{});
+    }
+
+    /**
+     * @brief MIN of a mapped column over matching rows.
+     *
+     * @tparam Member Pointer to a data member of T.
+     * @param where Optional WHERE predicate fragment.
+     * @return Minimum, or std::nullopt when no non-null value matches.
+     */
+    template <auto Member>
+    std::optional<detail::column_value_t<detail::member_value_t<Member>>>
+    min(const QueryBuilder &where = QueryBuilder{})
+    {
+      return aggregateOf<detail::column_value_t<detail::member_value_t<Member>>, Member>(
+          AggregateFn::Min, where);
+    }
+
+    /**
+     * @brief MAX of a mapped column over matching rows.
+     *
+     * @tparam Member Pointer to a data member of T.
+     * @param where Optional WHERE predicate fragment.
+     * @return Maximum, or std::nullopt when no non-null value matches.
+     */
+    template <auto Member>
+    std::optional<detail::column_value_t<detail::member_value_t<Member>>>
+    max(const QueryBuilder &where = QueryBuilder{})
+    {
+      return aggregateOf<detail::column_value_t<detail::member_value_t<Member>>, Member>(
+          AggregateFn::Max, where);
+    }
+
+    /**
+     * @brief AVG of a mapped numeric column over matching rows.
+     *
+     * @tparam Member Pointer to a numeric data member of T.
+     * @param where Optional WHERE predicate fragment.
+     * @return Average, or std::nullopt when no non-null value matches.
+     */
+    template <auto Member>
+    std::optional<double> avg(const QueryBuilder &where = QueryBuilder{})
+    {
+      static_assert(std::is_arithmetic_v<detail::column_value_t<detail::member_value_t<Member>>>,
+                    "BaseRepository::avg: column is not numeric");
+
+      return aggregateOf<double, Member>(AggregateFn::Avg, where);
+    }
+
+    /**
+     * @brief COUNT(*) per distinct value of a mapped column.
+     *
+     * Example:
+     * @code
+     * for (const auto &[status, n] : orders.countBy<&Order::status>())
+     *   ...
+     * @endcode
+     *
+     * @tparam Key Pointer to the grouping data member of T.
+     * @param where Optional WHERE predicate fragment.
+     * @return (key, count) pairs sorted by key.
+     */
+    template <auto Key>
+    FlatMap<detail::member_value_t<Key>, std::uint64_t>
+    countBy(const QueryBuilder &where = QueryBuilder{})
+    {
+      static_assert(std::is_same_v<detail::member_owner_t<Key>, T>,
+                    "BaseRepository::countBy: column belongs to another entity");
+
+      using K = detail::member_value_t<Key>;
+      const std::string_view key = Column<Key>::name;
+
+      std::string select(key);
+      select.append(", COUNT(*)");
+
+      std::string tail = " GROUP BY ";
+      tail.append(key).append(" ORDER BY ").append(key);
+
+      FlatMap<K, std::uint64_t> out;
+      selectRows(select, where, tail, [&](const auto &row)
+                     {
+                       if constexpr (!detail::is_optional<K>::value)
+                       {
+                         if (row.isNull(0))
+                         {
+                           return;
+                         }
+                       }
+                       out.emplace_back(read_column<K>(row, 0),
+                                        static_cast<std::uint64_t>(row.getInt64(1))); });
+      return out;
+    }
+
+    /**
+     * @brief SUM of @p Value per distinct value of @p Key.
+     *
+     * @tparam Key   Pointer to the grouping data member of T.
+     * @tparam Value Pointer to a numeric data member of T.
+     * @param where Optional WHERE predicate fragment.
+     * @return (key, sum) pairs sorted by key.
+     */
+    template <auto Key, auto Value>
+    FlatMap<detail::member_value_t<Key>,
+            detail::sum_t<detail::column_value_t<detail::member_value_t<Value>>>>
+    sumBy(const QueryBuilder &where = QueryBuilder{})
+    {
+      static_assert(std::is_arithmetic_v<detail::column_value_t<detail::member_value_t<Value>>>,
+                    "BaseRepository::sumBy: column is not numeric");
+
+      return aggregateBy<detail::sum_t<detail::column_value_t<detail::member_value_t<Value>>>,
+                         Key, Value>(AggregateFn::Sum, where);
+    }
+
+    /**
+     * @brief MIN of @p Value per distinct value of @p Key.
+     *
+     * @return (key, minimum) pairs sorted by key.
+     */
+    template <auto Key, auto Value>
+    FlatMap<detail::member_value_t<Key>, detail::column_value_t<detail::member_value_t<Value>>>
+    minBy(const QueryBuilder &where = QueryBuilder{})
+    {
+      return aggregateBy<detail::column_value_t<detail::member_value_t<Value>>, Key, Value>(
+          AggregateFn::Min, where);
+    }
+
+    /**
+     * @brief MAX of @p Value per distinct value of @p Key.
+     *
+     * @return (key, maximum) pairs sorted by key.
+     */
+    template <auto Key, auto Value>
+    FlatMap<detail::member_value_t<Key>, detail::column_value_t<detail::member_value_t<Value>>>
+    maxBy(const QueryBuilder &where = QueryBuilder{})
+    {
+      return aggregateBy<detail::column_value_t<detail::member_value_t<Value>>, Key, Value>(
+          AggregateFn::Max, where);
+    }
+
+    /**
+     * @brief AVG of @p Value per distinct value of @p Key.
+     *
+     * @return (key, average) pairs sorted by key.
+     */
+    template <auto Key, auto Value>
+    FlatMap<detail::member_value_t<Key>, double>
+    avgBy(const QueryBuilder &where = QueryBuilder{})
+    {
+      static_assert(std::is_arithmetic_v<detail::column_value_t<detail::member_value_t<Value>>>,
+                    "BaseRepository::avgBy: column is not numeric");
+
+      return aggregateBy<double, Key, Value>(AggregateFn::Avg, where);
+    }
+
+    /**
+     * @brief Update an entity by primary key.
+     *
+     * Uses Mapper<T>::toUpdateFields to generate the SET clause.
+     *
+     * When Mapper<T> declares a version column (see VersionedMapper),
+     * the update only applies if the stored version still equals the
+     * entity's version, and increments it.
+     *
+     * @param id    Primary key value.
+     * @param value Entity instance.
+     * @return Number of affected rows.
+     *
+     * @throws OptimisticLockError if the row exists with another version.
+     */
+    std::uint64_t updateById(std::int64_t id, const T &value)
+    {
+      const auto fields = entityUpdateFields(value, "updateById");
+
+      vix::db::PooledConn conn(pool_);
+      auto st = conn.get().prepare(entityUpdateSql(fields));
+
+      bindEntityUpdate(*st, fields, id, value);
+
+      const std::uint64_t affected = st->exec();
+      if (affected == 0)
+      {
+        checkVersionConflict(conn.get(), id, value);
+      }
+
+      return affected;
+    }
+
+    /**
+     * @brief Update only the given columns of a row.
+     *
+     * Issues UPDATE ... SET with exactly these columns, avoiding a
+     * full-row rewrite. Column names must be plain identifiers. For a
+     * versioned mapper the version column is incremented and may not be
+     * assigned directly.
+     *
+     * Example:
+     * @code
+     * repo.updateFields(id, {{"status", std::string("active")}});
+     * @endcode
+     *
+     * @param id     Primary key value.
+     * @param fields Column/value pairs to write.
+     * @return Number of affected rows.
+     */
+    std::uint64_t updateFields(std::int64_t id, const FieldValues &fields)
+    {
+      ensureNotEmpty(fields, "updateFields");
+      for (const auto &field : fields)
+      {
+        detail::require_identifier(field.first, "updateFields");
+        rejectVersionColumn(field.first, "updateFields");
+      }
+
+      const auto sql = cachedUpdateSql(fields.size(), [&](std::size_t i)
+                                       { return std::string_view(fields[i].first); });
+
+      vix::db::PooledConn conn(pool_);
+      auto st = conn.get().prepare(*sql);
+
+      bindFields(*st, fields);
+      st->bind(fields.size() + 1, id);
+
+      return st->exec();
+    }
+
+    /**
+     * @brief Update typed columns of a row.
+     *
+     * Column names come from Column<&T::member> specializations and
+     * values are checked against the member types at compile time. For
+     * a versioned mapper the version column is incremented.
+     *
+     * Example:
+     * @code
+     * repo.update(id, vix::orm::set<&User::status>("active"));
+     * @endcode
+     *
+     * @param id      Primary key value.
+     * @param assigns One or more set<&T::member>(value) assignments.
+     * @return Number of affected rows.
+     */
+    template <auto... Members>
+    std::uint64_t update(std::int64_t id, const Assignment<Members> &...assigns)
+    {
+      static_assert(sizeof...(Members) > 0, "BaseRepository::update: no columns to update");
+      static_assert((std::is_same_v<detail::member_owner_t<Members>, T> && ...),
+                    "BaseRepository::update: column belongs to another entity");
+
+      static constexpr std::string_view names[] = {Column<Members>::name...};
+      for (const auto name : names)
+      {
+        rejectVersionColumn(name, "update");
+      }
+
+      const auto sql = cachedUpdateSql(sizeof...(Members), [](std::size_t i)
+                                       { return names[i]; });
+
+      vix::db::PooledConn conn(pool_);
+      auto st = conn.get().prepare(*sql);
+
+      std::size_t index = 1;
+      (st->bind(index++, to_dbvalue(assigns.value)), ...);
+      st->bind(index, id);
+
+      return st->exec();
+    }
+
+    /**
+     * @brief Atomically add @p delta to a numeric column.
+     *
+     * Runs a single UPDATE ... SET col = col + ? WHERE id = ?, so the
+     * arithmetic happens in the database without a read round trip or
+     * a lock held across statements. For a versioned mapper the version
+     * column is incremented too.
+     *
+     * @param id     Primary key value.
+     * @param column Numeric column name.
+     * @param delta  Value to add (may be negative).
+     * @return Number of affected rows (0 if the row does not exist).
+     */
+    template <class N = std::int64_t>
+      requires(std::is_arithmetic_v<N> && !std::is_same_v<N, bool>)
+    std::uint64_t increment(std::int64_t id, std::string_view column, N delta = 1)
+    {
+      detail::require_identifier(column, "increment");
+      rejectVersionColumn(column, "increment");
+
+      std::string sql = "UPDATE " + table_ + " SET ";
+      sql.append(column).append(" = ").append(column).append(" + ?");
+      appendVersionBump(sql);
+      sql.append(" WHERE id = ?");
+
+      vix::db::PooledConn conn(pool_);
+      auto st = conn.get().prepare(sql);
+      st->bind(1, to_dbvalue(delta));
+      st->bind(2, id);
+
+      return st->exec();
+    }
+
+    /**
+     * @brief Typed variant of increment() for a mapped member.
+     *
+     * @tparam Member Pointer to a numeric data member of T.
+     */
+    template <auto Member, class N = detail::member_value_t<Member>>
+      requires(std::is_arithmetic_v<N> && !std::is_same_v<N, bool>)
+    std::uint64_t increment(std::int64_t id, N delta = 1)
+    {
+      static_assert(std::is_same_v<detail::member_owner_t<Member>, T>,
+                    "BaseRepository::increment: column belongs to another entity");
+      static_assert(std::is_arithmetic_v<detail::member_value_t<Member>>,
+                    "BaseRepository::increment: column is not numeric");
+
+      return increment(id, Column<Member>::name, delta);
+    }
+
+    /**
+     * @brief Update columns only if the row still has the expected version.
+     *
+     * Runs UPDATE ... SET fields, version = version + 1
+     * WHERE id = ? AND version = ? as one statement.
+     *
+     * @param id              Primary key value.
+     * @param fields          Column/value pairs to write.
+     * @param expectedVersion Version the caller read.
+     * @param versionColumn   Name of the version column; defaults to
+     *                        Mapper<T>::version_column for a versioned
+     *                        mapper, which must not be overridden.
+     * @return 1 if applied, 0 if the row is missing or the version changed.
+     */
+    std::uint64_t updateIf(std::int64_t id,
+                           const FieldValues &fields,
+                           std::int64_t expectedVersion,
+                           std::string_view versionColumn = defaultVersionColumn())
+    {
+      ensureNotEmpty(fields, "updateIf");
+      detail::require_identifier(versionColumn, "updateIf");
+      if (versionColumn != defaultVersionColumn() && VersionedMapper<T>)
+      {
+        throw vix::db::DBError(std::string("BaseRepository: updateIf version column '") +
+                               std::string(versionColumn) + "' differs from the mapper's '" +
+                               std::string(defaultVersionColumn()) + "'");
+      }
+
+      for (const auto &field : fields)
+      {
+        detail::require_identifier(field.first, "updateIf");
+        rejectVersionColumn(field.first, "updateIf");
+        if (field.first == versionColumn)
+        {
+          throw vix::db::DBError(std::string("BaseRepository: updateIf cannot assign its version column '") +
+                                 std::string(versionColumn) + "'");
+        }
+      }
+
+      std::string sql = "UPDATE " + table_ + " SET " + buildUpdateSetClause(fields) + ",";
+      sql.append(versionColumn).append("=").append(versionColumn).append("+1 WHERE id=? AND ");
+      sql.append(versionColumn).append("=?");
+
+      vix::db::PooledConn conn(pool_);
+      auto st = conn.get().prepare(sql);
+
+      bindFields(*st, fields);
+      st->bind(fields.size() + 1, id);
+      st->bind(fields.size() + 2, expectedVersion);
+
+      return st->exec();
+    }
+
+    /**
+     * @brief Set a column to @p desired only if it currently equals @p expected.
+     *
+     * Runs UPDATE ... SET col = ? WHERE id = ? AND col = ? as one
+     * statement. A null @p expected (nullptr or empty std::optional)
+     * compares with IS NULL. For a versioned mapper the version column
+     * is incremented on success; use updateIf() to swap on the version
+     * itself.
+     *
+     * @param id       Primary key value.
+     * @param column   Column name.
+     * @param expected Value the column must hold.
+     * @param desired  Value to write.
+     * @return 1 if swapped, 0 otherwise.
+     */
+    template <DbBindable E, DbBindable D>
+    std::uint64_t compareAndSet(std::int64_t id,
+                                std::string_view column,
+                                E &&expected,
+                                D &&desired)
+    {
+      detail::require_identifier(column, "compareAndSet");
+      rejectVersionColumn(column, "compareAndSet");
+
+      bool expectNull = false;
+      if constexpr (std::is_same_v<std::remove_cvref_t<E>, std::nullptr_t>)
+      {
+        expectNull = true;
+      }
+      else if constexpr (detail::is_optional<std::remove_cvref_t<E>>::value)
+      {
+        expectNull = !expected.has_value();
+      }
+
+      std::string sql = "UPDATE " + table_ + " SET ";
+      sql.append(column).append("=?");
+      appendVersionBump(sql);
+      sql.append(" WHERE id=? AND ").append(column);
+      sql.append(expectNull ? " IS NULL" : "=?");
+
+      vix::db::PooledConn conn(pool_);
+      auto st = conn.get().prepare(sql);
+      st->bind(1, to_dbvalue(std::forward<D>(desired)));
+      st->bind(2, id);
+      if (!expectNull)
+      {
+        st->bind(3, to_dbvalue(std::forward<E>(expected)));
+      }
+
+      return st->exec();
+    }
+
+    /**
+     * @brief Typed variant of compareAndSet() for a mapped member.
+     *
+     * @tparam Member Pointer to a data member of T.
+     */
+    template <auto Member>
+    std::uint64_t compareAndSet(std::int64_t id,
+                                const detail::member_value_t<Member> &expected,
+                                const detail::member_value_t<Member> &desired)
+    {
+      static_assert(std::is_same_v<detail::member_owner_t<Member>, T>,
+                    "BaseRepository::compareAndSet: column belongs to another entity");
+
+      return compareAndSet(id, Column<Member>::name, expected, desired);
+    }
+
+    /**
+     * @brief Set-based UPDATE of every row matching a predicate.
+     *
+     * The predicate is a QueryBuilder holding a WHERE fragment without
+     * the WHERE keyword, with its own parameters. One statement runs
+     * for all matching rows instead of a load + updateById loop.
+     *
+     * With @p limit, at most that many rows change per call; callers
+     * can repeat until the result is 0 to process large sets in short
+     * statements. For a versioned mapper every matched row has its
+     * version incremented.
+     *
+     * Example:
+     * @code
+     * vix::orm::QueryBuilder pred;
+     * pred.raw("status = ? AND last_seen < ?").param("active").param(cutoff);
+     * repo.updateWhere(pred, {{"status", std::string("idle")}}, 1000);
+     * @endcode
+     *
+     * @param where  WHERE predicate fragment.
+     * @param fields Column/value pairs to write.
+     * @param limit  Optional maximum number of rows for this statement.
+     * @return Number of affected rows.
+     */
+    std::uint64_t updateWhere(const QueryBuilder &where,
+                              const FieldValues &fields,
+                              std::optional<std::size_t> limit = std::nullopt)
+    {
+      ensureNotEmpty(fields, "updateWhere");
+      for (const auto &field : fields)
+      {
+        detail::require_identifier(field.first, "updateWhere");
+        rejectVersionColumn(field.first, "updateWhere");
+      }
+
+      vix::db::PooledConn conn(pool_);
+
+      std::string sql = "UPDATE " + table_ + " SET " + buildUpdateSetClause(fields);
+      appendVersionBump(sql);
+      appendWhere(sql, where, limit, conn.get(), "updateWhere");
 
-      vix::db::PooledConn conn(pool_);
       auto st = conn.get().prepare(sql);
+      bindFields(*st, fields);
+      where.bind(*st, fields.size() + 1);
 
       return st->exec();
     }
+
+    /**
+     * @brief Set-based DELETE of every row matching a predicate.
+     *
+     * Same predicate and limit semantics as updateWhere().
+     *
+     * @param where WHERE predicate fragment.
+     * @param limit Optional maximum number of rows for this statement.
+     * @return Number of affected rows.
+     */
+    std::uint64_t removeWhere(const QueryBuilder &where,
+                              std::optional<std::size_t> limit = std::nullopt)
+    {
+      if (where.sql().empty())
+      {
+        throw vix::db::DBError("BaseRepository: empty predicate in removeWhere");
+      }
+
+      if (const auto caches = counterCaches(); caches && !caches->empty())
+      {
+        return removeCounted(&where, limit, *caches);
+      }
+
+      vix::db::PooledConn conn(pool_);
+
+      std::string sql = "DELETE FROM " + table_;
+      appendWhere(sql, where, limit, conn.get(), "removeWhere");
+
+      auto st = conn.get().prepare(sql);
+      where.bind(*st);
+
+      const std::uint64_t affected = st->exec();
+      adjustCount(-static_cast<std::int64_t>(affected));
+
+      return affected;
+    }
+
+    /**
+     * @brief Delete an entity by primary key.
+     *
+     * @param id Primary key value.
+     * @return Number of affected rows.
+     */
+    std::uint64_t removeById(std::int64_t id)
+    {
+      if (const auto caches = counterCaches(); caches && !caches->empty())
+      {
+        QueryBuilder where("id = ?");
+        where.param(id);
+        return removeCounted(&where, std::nullopt, *caches);
+      }
+
+      const std::string sql =
+          "DELETE FROM " + table_ + " WHERE id = ?";
+
+      vix::db::PooledConn conn(pool_);
+      auto st = conn.get().prepare(sql);
+      st->bind(1, id);
+
+      const std::uint64_t affected = st->exec();
+      adjustCount(-static_cast<std::int64_t>(affected));
+
+      return affected;
+    }
+
+    /**
+     * @brief Delete all rows from the table.
+     *
+     * @return Number of affected rows.
+     */
+    std::uint64_t removeAll()
+    {
+      if (const auto caches = counterCaches(); caches && !caches->empty())
+      {
+        return removeCounted(nullptr, std::nullopt, *caches);
+      }
+
+      const std::string sql = "DELETE FROM " + table_;
+
+      vix::db::PooledConn conn(pool_);
+      auto st = conn.get().prepare(sql);
+
+      const std::uint64_t affected = st->exec();
+      adjustCount(-static_cast<std::int64_t>(affected));
+
+      return affected;
+    }
   };
 
 } // namespace vix::orm
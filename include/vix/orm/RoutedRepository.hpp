@@ -0,0 +1,833 @@
+/**
+ *
+ *  @file RoutedRepository.hpp
+ *  @author Gaspard Kirira
+ *
+ *  Copyright 2025, Gaspard Kirira.
+ *  All rights reserved.
+ *  https://github.com/vixcpp/vix
+ *
+ *  Use of this source code is governed by a MIT license
+ *  that can be found in the License file.
+ *
+ *  Vix.cpp
+ */
+#ifndef VIX_ORM_ROUTED_REPOSITORY_HPP
+#define VIX_ORM_ROUTED_REPOSITORY_HPP
+
+#include <vix/orm/db_compat.hpp>
+#include <vix/orm/QueryBuilder.hpp>
+#include <vix/orm/Repository.hpp>
+#include <vix/orm/UnitOfWork.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace vix::orm
+{
+  /**
+   * @brief How reads are spread across replica pools.
+   */
+  enum class ReplicaBalancing
+  {
+    /// Rotate through replicas.
+    RoundRobin,
+
+    /// Pick the replica with the fewest reads in flight.
+    LeastOutstanding
+  };
+
+  /**
+   * @brief Hedged-read policy for idempotent replica reads.
+   *
+   * When a replica has not answered after the observed latency
+   * percentile, the same read is sent to a second replica and the
+   * first answer wins.
+   */
+  struct HedgingPolicy
+  {
+    /// Latency percentile of replica reads that triggers the hedge.
+    double percentile = 0.95;
+
+    /// Lower bound of the hedge delay.
+    std::chrono::microseconds minDelay{500};
+
+    /// Upper bound of the hedge delay.
+    std::chrono::microseconds maxDelay{250000};
+
+    /// Replica reads observed before hedging starts.
+    std::size_t warmupSamples = 100;
+
+    /// Maximum fraction of hedgeable reads that may be hedged.
+    double budget = 0.05;
+
+    /// Hedges that may be issued back to back once the budget is saved up.
+    std::size_t burst = 10;
+
+    /**
+     * @brief Worker threads running hedged attempts.
+     *
+     * Each hedged read occupies one or two workers, so this also bounds
+     * the number of hedged reads in flight; reads finding no idle
+     * worker run unhedged on the calling thread.
+     */
+    std::size_t workers = 8;
+  };
+
+  /**
+   * @brief Hedging counters of a RoutedRepository.
+   */
+  struct HedgeStats
+  {
+    /// Hedgeable reads served by replicas.
+    std::uint64_t reads = 0;
+
+    /// Second requests issued.
+    std::uint64_t hedged = 0;
+
+    /// Second requests that answered first.
+    std::uint64_t hedgeWins = 0;
+
+    /// Current hedge delay; zero while warming up.
+    std::chrono::microseconds delay{0};
+  };
+
+  /**
+   * @brief Configuration of a RoutedRepository.
+   */
+  struct RoutingOptions
+  {
+    ReplicaBalancing balancing = ReplicaBalancing::RoundRobin;
+
+    /// How long a ConsistencyToken reads from the primary after a write.
+    std::chrono::milliseconds readYourWritesWindow{2000};
+
+    /// Retry a read on the primary when the replica throws.
+    bool fallbackToPrimary = true;
+
+    /// Hedge idempotent reads when set and at least two replicas exist.
+    std::optional<HedgingPolicy> hedging;
+  };
+
+  namespace detail
+  {
+    /**
+     * @brief Fixed pool of worker threads without a backlog.
+     *
+     * trySubmit() only accepts a task when a worker is idle, so tasks
+     * never wait in a queue and the number of running tasks is bounded
+     * by the number of workers. The destructor waits for running tasks.
+     */
+    class HedgeExecutor
+    {
+    public:
+      /**
+       * @brief Start up to @p threads workers.
+       *
+       * Fewer workers are started if the system refuses more threads.
+       */
+      explicit HedgeExecutor(std::size_t threads);
+
+      ~HedgeExecutor();
+
+      HedgeExecutor(const HedgeExecutor &) = delete;
+      HedgeExecutor &operator=(const HedgeExecutor &) = delete;
+
+      /**
+       * @brief Run @p task on an idle worker.
+       *
+       * @param task Callable that must not throw.
+       * @return false if no worker is idle; the task is not run.
+       */
+      bool trySubmit(std::function<void()> task);
+
+    private:
+      void work();
+
+      std::mutex mutex_;
+      std::condition_variable cv_;
+      std::deque<std::function<void()>> tasks_;
+      std::vector<std::thread> workers_;
+      std::size_t idle_ = 0;
+      bool stopping_ = false;
+    };
+  } // namespace detail
+
+  /**
+   * @brief Read-your-writes token for one client session.
+   *
+   * Writes made through a RoutedRepository with a token pin it to the
+   * primary for RoutingOptions::readYourWritesWindow, so the session's
+   * following reads see its own writes despite replication lag. Copies
+   * share the same pin, like CancellationToken.
+   */
+  class ConsistencyToken
+  {
+    using clock = std::chrono::steady_clock;
+
+    std::shared_ptr<std::atomic<clock::rep>> until_ =
+        std::make_shared<std::atomic<clock::rep>>(clock::time_point::min().time_since_epoch().count());
+
+  public:
+    /**
+     * @brief Read from the primary for @p window from now.
+     *
+     * Never shortens an existing pin.
+     */
+    void pin(clock::duration window) const noexcept
+    {
+      const clock::rep target = (clock::now() + window).time_since_epoch().count();
+      clock::rep current = until_->load(std::memory_order_relaxed);
+      while (current < target &&
+             !until_->compare_exchange_weak(current, target, std::memory_order_relaxed))
+      {
+      }
+    }
+
+    /**
+     * @brief Return whether reads must still go to the primary.
+     */
+    bool pinned() const noexcept
+    {
+      return clock::now().time_since_epoch().count() < until_->load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Drop the pin.
+     */
+    void reset() const noexcept
+    {
+      until_->store(clock::time_point::min().time_since_epoch().count(), std::memory_order_relaxed);
+    }
+  };
+
+  /**
+   * @brief Repository splitting reads across replicas and writes to a primary.
+   *
+   * Writes and units of work always use the primary pool. Reads go to
+   * a replica chosen by RoutingOptions::balancing, or to the primary
+   * when there is no replica or the caller's ConsistencyToken is
+   * pinned. Reads failing on a replica are retried on the primary
+   * unless RoutingOptions::fallbackToPrimary is off.
+   *
+   * For SQLite, the replicas are typically one pool of read-only
+   * connections to the same WAL database file: readers then never
+   * block the writer, and since WAL readers see committed data
+   * immediately, the read-your-writes window can be zero.
+   *
+   * Configure id generators, counter caches and count tracking on
+   * primary(); they only affect writes.
+   *
+   * Example:
+   * @code
+   * vix::orm::RoutedRepository<User> users(primaryPool, {&replicaA, &replicaB}, "users");
+   *
+   * vix::orm::ConsistencyToken session;
+   * users.updateById(id, user, &session);
+   * auto fresh = users.findById(id, &session); // served by the primary
+   * auto page = users.findAll();               // served by a replica
+   * @endcode
+   *
+   * @tparam T Entity type.
+   */
+  template <class T>
+  class RoutedRepository
+  {
+    struct State
+    {
+      static constexpr std::size_t latency_window = 1024;
+      static constexpr std::size_t refresh_every = 32;
+      static constexpr std::int64_t token_unit = 1000;
+
+      explicit State(std::size_t replicas) : outstanding(replicas) {}
+
+      std::atomic<std::size_t> next{0};
+      std::vector<std::atomic<std::size_t>> outstanding;
+
+      std::mutex latencyMutex;
+      std::vector<std::int64_t> latencies;
+      std::size_t latencyNext = 0;
+      std::size_t sinceRefresh = 0;
+
+      /// Hedge delay in microseconds; 0 while warming up.
+      std::atomic<std::int64_t> delayUs{0};
+
+      /// Hedge budget in thousandths of a hedge.
+      std::atomic<std::int64_t> budget{0};
+
+      std::atomic<std::uint64_t> reads{0};
+      std::atomic<std::uint64_t> hedged{0};
+      std::atomic<std::uint64_t> hedgeWins{0};
+
+      /**
+       * @brief Record a replica read latency and refresh the delay.
+       */
+      void record(std::chrono::steady_clock::duration d, const HedgingPolicy &policy)
+      {
+        const std::int64_t us = std::chrono::duration_cast<std::chrono::microseconds>(d).count();
+
+        std::lock_guard<std::mutex> lock(latencyMutex);
+        if (latencies.size() < latency_window)
+        {
+          latencies.push_back(us);
+        }
+        else
+        {
+          latencies[latencyNext] = us;
+          latencyNext = (latencyNext + 1) % latency_window;
+        }
+
+        const std::size_t warmup = std::clamp<std::size_t>(policy.warmupSamples, 1, latency_window);
+        if (latencies.size() < warmup ||
+            (++sinceRefresh < refresh_every && delayUs.load(std::memory_order_relaxed) != 0))
+        {
+          return;
+        }
+        sinceRefresh = 0;
+
+        std::vector<std::int64_t> sorted(latencies);
+        const double rank = std::clamp(policy.percentile, 0.0, 1.0) * static_cast<double>(sorted.size() - 1);
+        const auto nth = sorted.begin() + static_cast<std::ptrdiff_t>(rank);
+        std::nth_element(sorted.begin(), nth, sorted.end());
+
+        const std::int64_t delay =
+            std::clamp<std::int64_t>(*nth, std::max<std::int64_t>(1, policy.minDelay.count()),
+                                     std::max<std::int64_t>(1, policy.maxDelay.count()));
+        delayUs.store(delay, std::memory_order_relaxed);
+      }
+
+      /**
+       * @brief Credit the budget for one hedgeable read.
+       */
+      void earn(const HedgingPolicy &policy) noexcept
+      {
+        const auto add = static_cast<std::int64_t>(std::llround(policy.budget * token_unit));
+        const auto cap = static_cast<std::int64_t>(policy.burst) * token_unit;
+
+        std::int64_t current = budget.load(std::memory_order_relaxed);
+        while (current < cap &&
+               !budget.compare_exchange_weak(current, std::min(cap, current + add),
+                                             std::memory_order_relaxed))
+        {
+        }
+      }
+
+      bool canHedge() const noexcept
+      {
+        return budget.load(std::memory_order_relaxed) >= token_unit;
+      }
+
+      /**
+       * @brief Spend one hedge from the budget once it has been issued.
+       *
+       * Called after the hedge was submitted, so a refused submit costs
+       * nothing. Reads hedging together may overdraw the budget by a
+       * few hedges; later reads earn it back before the next one.
+       */
+      void spendHedge() noexcept
+      {
+        budget.fetch_sub(token_unit, std::memory_order_relaxed);
+      }
+    };
+
+    /**
+     * @brief Counts a read in flight on one replica.
+     */
+    class Lease
+    {
+      std::atomic<std::size_t> *counter_;
+
+    public:
+      explicit Lease(std::atomic<std::size_t> &counter) noexcept : counter_(&counter)
+      {
+        counter_->fetch_add(1, std::memory_order_relaxed);
+      }
+
+      ~Lease()
+      {
+        counter_->fetch_sub(1, std::memory_order_relaxed);
+      }
+
+      Lease(const Lease &) = delete;
+      Lease &operator=(const Lease &) = delete;
+    };
+
+    BaseRepository<T> primary_;
+    std::vector<BaseRepository<T>> replicas_;
+    RoutingOptions options_;
+    std::shared_ptr<State> state_;
+
+    /// Declared last: destroyed first, waiting for losing attempts
+    /// while the replica repositories are still alive.
+    std::unique_ptr<detail::HedgeExecutor> executor_;
+
+    std::size_t pickReplica()
+    {
+      const std::size_t n = replicas_.size();
+      const std::size_t start = state_->next.fetch_add(1, std::memory_order_relaxed) % n;
+
+      if (options_.balancing == ReplicaBalancing::RoundRobin)
+      {
+        return start;
+      }
+
+      // Scan from a rotating start so ties spread evenly.
+      std::size_t best = start;
+      std::size_t bestLoad = state_->outstanding[start].load(std::memory_order_relaxed);
+      for (std::size_t k = 1; k < n && bestLoad != 0; ++k)
+      {
+        const std::size_t i = (start + k) % n;
+        const std::size_t load = state_->outstanding[i].load(std::memory_order_relaxed);
+        if (load < bestLoad)
+        {
+          best = i;
+          bestLoad = load;
+        }
+      }
+      return best;
+    }
+
+    /**
+     * @brief Plain read() recording the replica latency.
+     */
+    template <class Fn>
+    auto timedRead(Fn &fn, const ConsistencyToken *token)
+    {
+      const HedgingPolicy &policy = *options_.hedging;
+      return read([&](BaseRepository<T> &r)
+                  {
+                    const auto start = std::chrono::steady_clock::now();
+                    auto value = fn(r);
+                    state_->record(std::chrono::steady_clock::now() - start, policy);
+                    return value; },
+                  token);
+    }
+
+    /**
+     * @brief Race @p fn on one replica, then on a second after the hedge delay.
+     *
+     * Attempts run on the executor with their own copy of @p fn. A
+     * losing attempt keeps running after this returns and its result
+     * is discarded; the executor's destructor waits for it. Without an
+     * idle worker the read runs unhedged on the calling thread.
+     *
+     * @return The winning value, or nullopt when every attempt failed
+     *         and the primary should be tried.
+     */
+    template <class R, class Fn>
+    std::optional<R> raceReplicas(Fn &fn, std::chrono::microseconds delay)
+    {
+      struct Race
+      {
+        std::mutex mutex;
+        std::condition_variable cv;
+        std::optional<R> value;
+        std::exception_ptr error;
+        std::size_t pending = 0;
+        bool hedgeWon = false;
+      };
+
+      const HedgingPolicy &policy = *options_.hedging;
+      auto race = std::make_shared<Race>();
+
+      const auto launch = [&](std::size_t index, bool hedge)
+      {
+        return executor_->trySubmit(
+            [race, state = state_, policy, fn, repo = &replicas_[index], index, hedge]() mutable
+            {
+              std::optional<R> value;
+              std::exception_ptr error;
+              {
+                Lease lease(state->outstanding[index]);
+                const auto start = std::chrono::steady_clock::now();
+                try
+                {
+                  value.emplace(fn(*repo));
+                  state->record(std::chrono::steady_clock::now() - start, policy);
+                }
+                catch (...)
+                {
+                  error = std::current_exception();
+                }
+              }
+
+              std::lock_guard<std::mutex> lock(race->mutex);
+              --race->pending;
+              if (value && !race->value)
+              {
+                race->value = std::move(value);
+                race->hedgeWon = hedge;
+              }
+              else if (error && !race->error)
+              {
+                race->error = error;
+              }
+              race->cv.notify_all();
+            });
+      };
+
+      const std::size_t first = pickReplica();
+
+      std::unique_lock<std::mutex> lock(race->mutex);
+      ++race->pending;
+      if (!launch(first, false))
+      {
+        lock.unlock();
+        return timedRead(fn, nullptr);
+      }
+
+      const auto settled = [&]
+      { return race->value.has_value() || race->pending == 0; };
+
+      if (!race->cv.wait_for(lock, delay, settled) && state_->canHedge())
+      {
+        std::size_t second = pickReplica();
+        if (second == first)
+        {
+          second = (first + 1) % replicas_.size();
+        }
+
+        // Without an idle worker, keep waiting on the first attempt.
+        ++race->pending;
+        if (launch(second, true))
+        {
+          state_->spendHedge();
+          state_->hedged.fetch_add(1, std::memory_order_relaxed);
+        }
+        else
+        {
+          --race->pending;
+        }
+      }
+
+      race->cv.wait(lock, settled);
+
+      if (race->value)
+      {
+        if (race->hedgeWon)
+        {
+          state_->hedgeWins.fetch_add(1, std::memory_order_relaxed);
+        }
+        return std::move(race->value);
+      }
+
+      if (!options_.fallbackToPrimary)
+      {
+        std::rethrow_exception(race->error);
+      }
+      return std::nullopt;
+    }
+
+    void pinAfterWrite(const ConsistencyToken *token) const noexcept
+    {
+      if (token)
+      {
+        token->pin(options_.readYourWritesWindow);
+      }
+    }
+
+  public:
+    /**
+     * @brief Construct a routed repository.
+     *
+     * @param primary Pool receiving writes.
+     * @param replicas Pools serving reads; may be empty.
+     * @param table Database table name.
+     * @param options Routing options.
+     */
+    RoutedRepository(vix::db::ConnectionPool &primary,
+                     const std::vector<vix::db::ConnectionPool *> &replicas,
+                     std::string table,
+                     RoutingOptions options = RoutingOptions{})
+        : primary_(primary, table),
+          options_(options),
+          state_(std::make_shared<State>(replicas.size()))
+    {
+      replicas_.reserve(replicas.size());
+      for (vix::db::ConnectionPool *pool : replicas)
+      {
+        if (pool == nullptr)
+        {
+          throw std::runtime_error("RoutedRepository: null replica pool");
+        }
+        replicas_.emplace_back(*pool, table);
+      }
+
+      if (options_.hedging && replicas_.size() >= 2)
+      {
+        executor_ = std::make_unique<detail::HedgeExecutor>(options_.hedging->workers);
+      }
+    }
+
+    /**
+     * @brief Return the database table name.
+     */
+    const std::string &table() const noexcept
+    {
+      return primary_.table();
+    }
+
+    /**
+     * @brief Repository bound to the primary pool.
+     */
+    BaseRepository<T> &primary() noexcept
+    {
+      return primary_;
+    }
+
+    /**
+     * @brief Number of replica pools.
+     */
+    std::size_t replicaCount() const noexcept
+    {
+      return replicas_.size();
+    }
+
+    /**
+     * @brief Reads currently in flight on replica @p index.
+     */
+    std::size_t outstanding(std::size_t index) const
+    {
+      return state_->outstanding.at(index).load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Run a read on a replica (or the primary when pinned).
+     *
+     * @param fn Callable taking a BaseRepository<T>&; must be idempotent.
+     * @param token Optional read-your-writes token.
+     * @return Result of @p fn.
+     */
+    template <class Fn>
+    auto read(Fn &&fn, const ConsistencyToken *token = nullptr)
+    {
+      if (replicas_.empty() || (token && token->pinned()))
+      {
+        return fn(primary_);
+      }
+
+      const std::size_t index = pickReplica();
+      try
+      {
+        Lease lease(state_->outstanding[index]);
+        return fn(replicas_[index]);
+      }
+      catch (const std::exception &)
+      {
+        if (!options_.fallbackToPrimary)
+        {
+          throw;
+        }
+      }
+      return fn(primary_);
+    }
+
+    /**
+     * @brief Run an idempotent read, hedged across replicas when enabled.
+     *
+     * Without RoutingOptions::hedging, with fewer than two replicas or
+     * with a pinned token this is read(). Otherwise, while the hedge
+     * budget allows, @p fn runs on one replica and, if it has not
+     * answered within the observed latency percentile, on a second
+     * one; the first answer wins. Both attempts run on a bounded set
+     * of HedgingPolicy::workers threads owned by the repository.
+     *
+     * Losing attempts are not cancelled: the database API offers no
+     * way to abort a running statement, so the loser runs to completion
+     * on its worker, holding a pooled connection, and its result is
+     * dropped. Destroying the repository waits for such attempts; the
+     * replica pools must outlive the repository.
+     *
+     * @param fn Callable taking a BaseRepository<T>& and returning a
+     *        value. It is copied into each attempt and may outlive
+     *        this call, so capture by value.
+     * @param token Optional read-your-writes token.
+     * @return Result of @p fn.
+     */
+    template <class Fn>
+    auto readHedged(Fn fn, const ConsistencyToken *token = nullptr)
+    {
+      using R = std::invoke_result_t<Fn &, BaseRepository<T> &>;
+      static_assert(!std::is_void_v<R>, "readHedged requires a result");
+
+      if (!options_.hedging || replicas_.size() < 2 || (token && token->pinned()))
+      {
+        return read(fn, token);
+      }
+
+      const HedgingPolicy &policy = *options_.hedging;
+      state_->reads.fetch_add(1, std::memory_order_relaxed);
+      state_->earn(policy);
+
+      const std::chrono::microseconds delay(state_->delayUs.load(std::memory_order_relaxed));
+      if (delay.count() == 0 || !state_->canHedge())
+      {
+        // Warming up or out of budget: time a plain read on this thread.
+        return timedRead(fn, token);
+      }
+
+      std::optional<R> value = raceReplicas<R>(fn, delay);
+      if (value)
+      {
+        return std::move(*value);
+      }
+      return fn(primary_);
+    }
+
+    /**
+     * @brief Hedging counters.
+     */
+    HedgeStats hedgeStats() const noexcept
+    {
+      HedgeStats stats;
+      stats.reads = state_->reads.load(std::memory_order_relaxed);
+      stats.hedged = state_->hedged.load(std::memory_order_relaxed);
+      stats.hedgeWins = state_->hedgeWins.load(std::memory_order_relaxed);
+      stats.delay = std::chrono::microseconds(state_->delayUs.load(std::memory_order_relaxed));
+      return stats;
+    }
+
+    /**
+     * @brief Run a write on the primary and pin @p token.
+     *
+     * @param fn Callable taking a BaseRepository<T>&.
+     * @param token Optional read-your-writes token.
+     * @return Result of @p fn.
+     */
+    template <class Fn>
+    auto write(Fn &&fn, const ConsistencyToken *token = nullptr)
+    {
+      struct Pin
+      {
+        const RoutedRepository *self;
+        const ConsistencyToken *token;
+        ~Pin() { self->pinAfterWrite(token); }
+      } pin{this, token};
+
+      return fn(primary_);
+    }
+
+    /**
+     * @brief Begin a unit of work on the primary and pin @p token.
+     *
+     * The pin starts now; call ConsistencyToken::pin again after a
+     * long-running commit.
+     */
+    UnitOfWork unitOfWork(const ConsistencyToken *token = nullptr)
+    {
+      pinAfterWrite(token);
+      return UnitOfWork(primary_.pool());
+    }
+
+    /// Hedged when RoutingOptions::hedging is set.
+    std::optional<T> findById(std::int64_t id, const ConsistencyToken *token = nullptr)
+    {
+      return readHedged([id](BaseRepository<T> &r)
+                        { return r.findById(id); },
+                        token);
+    }
+
+    /// Hedged when RoutingOptions::hedging is set.
+    std::vector<T> findByIds(std::vector<std::int64_t> ids, const ConsistencyToken *token = nullptr)
+    {
+      return readHedged([ids = std::move(ids)](BaseRepository<T> &r)
+                        { return r.findByIds(ids); },
+                        token);
+    }
+
+    std::vector<T> findAll(const ConsistencyToken *token = nullptr)
+    {
+      return read([](BaseRepository<T> &r)
+                  { return r.findAll(); },
+                  token);
+    }
+
+    /// Hedged when RoutingOptions::hedging is set.
+    template <ProjectionMapper Dto>
+    std::optional<Dto> findByIdAs(std::int64_t id, const ConsistencyToken *token = nullptr)
+    {
+      return readHedged([id](BaseRepository<T> &r)
+                        { return r.template findByIdAs<Dto>(id); },
+                        token);
+    }
+
+    template <ProjectionMapper Dto>
+    std::vector<Dto> findAllAs(const ConsistencyToken *token = nullptr)
+    {
+      return read([](BaseRepository<T> &r)
+                  { return r.template findAllAs<Dto>(); },
+                  token);
+    }
+
+    /// Hedged when RoutingOptions::hedging is set.
+    bool existsById(std::int64_t id, const ConsistencyToken *token = nullptr)
+    {
+      return readHedged([id](BaseRepository<T> &r)
+                        { return r.existsById(id); },
+                        token);
+    }
+
+    std::uint64_t count(const ConsistencyToken *token = nullptr)
+    {
+      return read([](BaseRepository<T> &r)
+                  { return r.count(); },
+                  token);
+    }
+
+    std::uint64_t countWhere(const QueryBuilder &where, const ConsistencyToken *token = nullptr)
+    {
+      return read([&](BaseRepository<T> &r)
+                  { return r.countWhere(where); },
+                  token);
+    }
+
+    std::uint64_t create(const T &value, const ConsistencyToken *token = nullptr)
+    {
+      return write([&](BaseRepository<T> &r)
+                   { return r.create(value); },
+                   token);
+    }
+
+    std::vector<std::int64_t> createMany(const std::vector<T> &values,
+                                         const ConsistencyToken *token = nullptr)
+    {
+      return write([&](BaseRepository<T> &r)
+                   { return r.createMany(values); },
+                   token);
+    }
+
+    std::uint64_t updateById(std::int64_t id, const T &value, const ConsistencyToken *token = nullptr)
+    {
+      return write([&](BaseRepository<T> &r)
+                   { return r.updateById(id, value); },
+                   token);
+    }
+
+    std::uint64_t removeById(std::int64_t id, const ConsistencyToken *token = nullptr)
+    {
+      return write([&](BaseRepository<T> &r)
+                   { return r.removeById(id); },
+                   token);
+    }
+  };
+
+} // namespace vix::orm
+
+#endif // VIX_ORM_ROUTED_REPOSITORY_HPP
@@ -0,0 +1,176 @@
+/**
+ *
+ *  @file RowView.hpp
+ *  @author Gaspard Kirira
+ *
+ *  Copyright 2025, Gaspard Kirira.
+ *  All rights reserved.
+ *  https://github.com/vixcpp/vix
+ *
+ *  Use of this source code is governed by a MIT license
+ *  that can be found in the License file.
+ *
+ *  Vix.cpp
+ */
+#ifndef VIX_ORM_ROW_VIEW_HPP
+#define VIX_ORM_ROW_VIEW_HPP
+
+#include <vix/orm/db_compat.hpp>
+#include <vix/orm/Mapper.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace vix::orm
+{
+  /**
+   * @brief Read-only view of the current result row.
+   *
+   * Text and blob accessors return views into a per-column slot owned
+   * by the scanning loop, so visitors can handle fields without
+   * materializing T. vix::db::ResultRow only returns owned strings, so
+   * each text or blob read still costs one ResultRow::getString copy.
+   * Views stay valid until the result set advances or the same column
+   * is read again.
+   */
+  class RowView
+  {
+    const vix::db::ResultRow *row_;
+    std::vector<std::string> *scratch_;
+
+    std::string_view read(std::size_t index) const
+    {
+      if (scratch_->size() <= index)
+      {
+        scratch_->resize(index + 1);
+      }
+
+      std::string &slot = (*scratch_)[index];
+      slot = row_->getString(index);
+      return slot;
+    }
+
+  public:
+    /**
+     * @brief Wrap a result row.
+     *
+     * @param row Current row.
+     * @param scratch Per-column slots owned by the scanning loop.
+     */
+    RowView(const vix::db::ResultRow &row, std::vector<std::string> &scratch) noexcept
+        : row_(&row),
+          scratch_(&scratch)
+    {
+    }
+
+    /**
+     * @brief Underlying row.
+     */
+    const vix::db::ResultRow &row() const noexcept
+    {
+      return *row_;
+    }
+
+    bool isNull(std::size_t index) const
+    {
+      return row_->isNull(index);
+    }
+
+    std::int64_t getInt64(std::size_t index) const
+    {
+      return row_->getInt64(index);
+    }
+
+    std::int64_t getInt64Or(std::size_t index, std::int64_t fallbackValue) const
+    {
+      return row_->isNull(index) ? fallbackValue : row_->getInt64(index);
+    }
+
+    double getDouble(std::size_t index) const
+    {
+      return row_->getDouble(index);
+    }
+
+    double getDoubleOr(std::size_t index, double fallbackValue) const
+    {
+      return row_->isNull(index) ? fallbackValue : row_->getDouble(index);
+    }
+
+    /**
+     * @brief Borrow a text column.
+     *
+     * @param index Zero-based column index.
+     * @return View valid until the result set advances.
+     */
+    std::string_view getText(std::size_t index) const
+    {
+      return read(index);
+    }
+
+    /**
+     * @brief Borrow a text column, or @p fallbackValue when NULL.
+     */
+    std::string_view getTextOr(std::size_t index, std::string_view fallbackValue) const
+    {
+      return row_->isNull(index) ? fallbackValue : getText(index);
+    }
+
+    /**
+     * @brief Borrow a blob column.
+     *
+     * @param index Zero-based column index.
+     * @return View valid until the result set advances.
+     */
+    std::span<const std::byte> getBlob(std::size_t index) const
+    {
+      const std::string_view bytes = read(index);
+      return std::as_bytes(std::span<const char>(bytes.data(), bytes.size()));
+    }
+  };
+
+  namespace detail
+  {
+    /**
+     * @brief Field visitor accepting anything, used to probe visitRow.
+     */
+    struct FieldSink
+    {
+      template <class V>
+      void operator()(std::string_view, const V &) const noexcept
+      {
+      }
+    };
+  } // namespace detail
+
+  /**
+   * @brief Mappers able to visit a row's fields without materializing T.
+   *
+   * Opt in by adding to the Mapper<T> specialization:
+   * @code
+   * template <class Fn>
+   * static void visitRow(const vix::orm::RowView &row, Fn &&field)
+   * {
+   *   field("id", row.getInt64(0));
+   *   field("name", row.getText(1));
+   *   if (row.isNull(2)) field("email", nullptr);
+   *   else field("email", row.getText(2));
+   * }
+   * @endcode
+   *
+   * The visitor is called with (field name, value) where value is one
+   * of std::int64_t, double, bool, std::string_view,
+   * std::span<const std::byte> or std::nullptr_t. Fields are visited
+   * in a fixed order; views are valid only during the call.
+   */
+  template <class T>
+  concept VisitableMapper = requires(const RowView &row, detail::FieldSink &sink) {
+    Mapper<T>::visitRow(row, sink);
+  };
+
+} // namespace vix::orm
+
+#endif // VIX_ORM_ROW_VIEW_HPP
@@ -0,0 +1,766 @@
+/**
+ *
+ *  @file ShardedRepository.hpp
+ *  @author Gaspard Kirira
+ *
+ *  Copyright 2025, Gaspard Kirira.
+ *  All rights reserved.
+ *  https://github.com/vixcpp/vix
+ *
+ *  Use of this source code is governed by a MIT license
+ *  that can be found in the License file.
+ *
+ *  Vix.cpp
+ */
+#ifndef VIX_ORM_SHARDED_REPOSITORY_HPP
+#define VIX_ORM_SHARDED_REPOSITORY_HPP
+
+#include <vix/orm/db_compat.hpp>
+#include <vix/orm/Fingerprint.hpp>
+#include <vix/orm/IdGenerator.hpp>
+#include <vix/orm/QueryBuilder.hpp>
+#include <vix/orm/Repository.hpp>
+
+#include <algorithm>
+#include <any>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <queue>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace vix::orm
+{
+  /**
+   * @brief How shard keys map to shards.
+   */
+  enum class ShardStrategy
+  {
+    /// Hash of the key modulo the shard count.
+    Hash,
+
+    /// Ascending integer ranges, see ShardingOptions::rangeBounds.
+    Range
+  };
+
+  /**
+   * @brief Configuration of a ShardedRepository.
+   */
+  struct ShardingOptions
+  {
+    /// Column holding the shard key: "id" or e.g. a tenant column.
+    std::string keyColumn = "id";
+
+    ShardStrategy strategy = ShardStrategy::Hash;
+
+    /**
+     * @brief Exclusive upper bounds of shards 0 .. K-2, ascending.
+     *
+     * Shard i holds keys in [rangeBounds[i-1], rangeBounds[i]); the
+     * last shard holds everything from rangeBounds[K-2] on.
+     */
+    std::vector<std::int64_t> rangeBounds;
+  };
+
+  namespace detail
+  {
+    /**
+     * @brief 64-bit finalizer spreading sequential keys across shards.
+     */
+    constexpr std::uint64_t shard_mix(std::uint64_t x) noexcept
+    {
+      x ^= x >> 30;
+      x *= 0xbf58476d1ce4e5b9ull;
+      x ^= x >> 27;
+      x *= 0x94d049bb133111ebull;
+      x ^= x >> 31;
+      return x;
+    }
+
+    /**
+     * @brief Text value of a named mapper field, if it holds a string.
+     */
+    inline std::optional<std::string_view> text_field(const FieldValues &fields,
+                                                      std::string_view name)
+    {
+      for (const auto &field : fields)
+      {
+        if (field.first != name)
+        {
+          continue;
+        }
+
+        const std::any &v = field.second;
+        if (const auto *p = std::any_cast<std::string>(&v))
+          return std::string_view(*p);
+        if (const auto *p = std::any_cast<std::string_view>(&v))
+          return *p;
+        if (const auto *p = std::any_cast<const char *>(&v))
+          return std::string_view(*p);
+        return std::nullopt;
+      }
+
+      return std::nullopt;
+    }
+  } // namespace detail
+
+  /**
+   * @brief Maps shard keys to shard indexes.
+   *
+   * Holds no connection; ShardedRepository routes through one, and it
+   * can be used alone to place rows when provisioning shards.
+   */
+  class ShardRouter
+  {
+  public:
+    /**
+     * @brief Construct a router over @p shards shards.
+     *
+     * @throws vix::db::DBError on zero shards, an invalid key column or
+     *         range bounds that are not shards - 1 ascending values.
+     */
+    ShardRouter(ShardingOptions options, std::size_t shards)
+        : options_(std::move(options)), shards_(shards)
+    {
+      if (shards_ == 0)
+      {
+        throw vix::db::DBError("ShardedRepository: at least one shard is required");
+      }
+
+      detail::require_identifier(options_.keyColumn, "ShardedRepository");
+
+      if (options_.strategy == ShardStrategy::Range &&
+          (options_.rangeBounds.size() + 1 != shards_ ||
+           std::adjacent_find(options_.rangeBounds.begin(), options_.rangeBounds.end(),
+                              [](std::int64_t a, std::int64_t b)
+                              { return a >= b; }) != options_.rangeBounds.end()))
+      {
+        throw vix::db::DBError("ShardedRepository: range sharding needs shards - 1 ascending bounds");
+      }
+    }
+
+    /**
+     * @brief Sharding configuration.
+     */
+    const ShardingOptions &options() const noexcept
+    {
+      return options_;
+    }
+
+    /**
+     * @brief Number of shards.
+     */
+    std::size_t shardCount() const noexcept
+    {
+      return shards_;
+    }
+
+    /**
+     * @brief Shard holding an integer key.
+     */
+    std::size_t shardFor(std::int64_t key) const noexcept
+    {
+      if (options_.strategy == ShardStrategy::Range)
+      {
+        const auto it = std::upper_bound(options_.rangeBounds.begin(), options_.rangeBounds.end(), key);
+        return static_cast<std::size_t>(it - options_.rangeBounds.begin());
+      }
+      return static_cast<std::size_t>(detail::shard_mix(static_cast<std::uint64_t>(key)) % shards_);
+    }
+
+    /**
+     * @brief Shard holding a text key (hash strategy only).
+     *
+     * @throws vix::db::DBError with range sharding.
+     */
+    std::size_t shardFor(std::string_view key) const
+    {
+      if (options_.strategy == ShardStrategy::Range)
+      {
+        throw vix::db::DBError("ShardedRepository: range sharding needs integer keys");
+      }
+      return static_cast<std::size_t>(
+          detail::shard_mix(detail::fnv1a_update(detail::fnv1a_basis, key)) % shards_);
+    }
+
+    /**
+     * @brief Shard of the row described by mapper fields.
+     *
+     * @throws vix::db::DBError if @p fields lacks the shard key.
+     */
+    std::size_t shardOf(const FieldValues &fields, const char *context) const
+    {
+      if (const auto key = detail::integer_field(fields, options_.keyColumn))
+      {
+        return shardFor(*key);
+      }
+      if (const auto key = detail::text_field(fields, options_.keyColumn))
+      {
+        return shardFor(*key);
+      }
+
+      throw vix::db::DBError(std::string("ShardedRepository: ") + context +
+                             " requires the shard key '" + options_.keyColumn +
+                             "' in Mapper<T>::toInsertFields");
+    }
+
+  private:
+    ShardingOptions options_;
+    std::size_t shards_;
+  };
+
+  namespace detail
+  {
+    /**
+     * @brief K-way merge of ordered pages, skipping @p offset rows.
+     *
+     * @p before(a, b) is the strict order of the per-shard pages. Rows
+     * neither before the other go to the lower part index. Rows are
+     * moved out of @p parts.
+     *
+     * @return At most @p limit rows in merged order.
+     */
+    template <class R, class Before>
+    std::vector<R> merge_pages(std::vector<std::vector<R>> &parts,
+                               std::size_t offset,
+                               std::size_t limit,
+                               Before before)
+    {
+      // Heap entries are (part, position); the top is the next row.
+      using Cursor = std::pair<std::size_t, std::size_t>;
+      const auto after = [&](const Cursor &a, const Cursor &b)
+      {
+        const R &ra = parts[a.first][a.second];
+        const R &rb = parts[b.first][b.second];
+        if (before(rb, ra))
+        {
+          return true;
+        }
+        if (before(ra, rb))
+        {
+          return false;
+        }
+        return b.first < a.first;
+      };
+
+      std::priority_queue<Cursor, std::vector<Cursor>, decltype(after)> heap(after);
+      for (std::size_t s = 0; s < parts.size(); ++s)
+      {
+        if (!parts[s].empty())
+        {
+          heap.push({s, 0});
+        }
+      }
+
+      std::vector<R> out;
+      out.reserve(limit);
+      std::size_t skipped = 0;
+      while (!heap.empty() && out.size() < limit)
+      {
+        const Cursor top = heap.top();
+        heap.pop();
+
+        if (skipped < offset)
+        {
+          ++skipped;
+        }
+        else
+        {
+          out.push_back(std::move(parts[top.first][top.second]));
+        }
+
+        if (top.second + 1 < parts[top.first].size())
+        {
+          heap.push({top.first, top.second + 1});
+        }
+      }
+
+      return out;
+    }
+  } // namespace detail
+
+  /**
+   * @brief Repository partitioning one table across K connection pools.
+   *
+   * Each pool is a shard: a separate SQLite file or MySQL schema with
+   * the same table. Rows are routed by a shard key column, either the
+   * primary key or a tenant column, hashed or split into integer
+   * ranges. Hash routing is modulo the shard count, so changing K
+   * requires moving rows.
+   *
+   * Point operations touch one shard: create() routes on the key found
+   * in Mapper<T>::toInsertFields, and findById / updateById / removeById
+   * route on the id when it is the shard key. Otherwise they, like
+   * findAll, count and findPage, scatter to all shards in parallel and
+   * gather the results; findPage merges the per-shard ordered pages
+   * with a k-way merge (non-text columns only). updateById refuses to
+   * move a row whose shard key changed.
+   *
+   * Per-shard auto-increment ids collide across shards. When sharding
+   * by id, let the mapper supply ids, e.g. from a SnowflakeIdGenerator
+   * installed with setIdGenerator() and drawn with nextId().
+   *
+   * Example:
+   * @code
+   * vix::orm::ShardingOptions opt;
+   * opt.keyColumn = "tenant_id";
+   *
+   * vix::orm::ShardedRepository<Invoice> invoices({&shard0, &shard1, &shard2}, "invoices", opt);
+   * invoices.create(invoice);
+   * auto tenantRows = invoices.forKey(tenantId).countWhere(byTenant);
+   * auto latest = invoices.findPage<&Invoice::issuedAt>({50, 0, true});
+   * @endcode
+   *
+   * @tparam T Entity type.
+   */
+  template <class T>
+  class ShardedRepository
+  {
+    ShardRouter router_;
+    std::vector<BaseRepository<T>> shards_;
+    std::shared_ptr<IdGenerator> ids_;
+
+    bool keyedById() const noexcept
+    {
+      return router_.options().keyColumn == "id";
+    }
+
+    std::size_t shardOf(const FieldValues &fields, const char *context) const
+    {
+      return router_.shardOf(fields, context);
+    }
+
+    /**
+     * @brief Run @p fn on every shard in parallel, results in shard order.
+     *
+     * Shard 0 runs on the calling thread. The first error is rethrown
+     * once all shards have finished.
+     */
+    template <class Fn>
+    auto scatter(Fn &&fn)
+    {
+      using R = std::invoke_result_t<Fn &, BaseRepository<T> &>;
+
+      const std::size_t n = shards_.size();
+      std::vector<std::optional<R>> results(n);
+      std::vector<std::exception_ptr> errors(n);
+
+      const auto run = [&](std::size_t i)
+      {
+        try
+        {
+          results[i].emplace(fn(shards_[i]));
+        }
+        catch (...)
+        {
+          errors[i] = std::current_exception();
+        }
+      };
+
+      std::vector<std::thread> threads;
+      threads.reserve(n);
+      for (std::size_t i = 1; i < n; ++i)
+      {
+        try
+        {
+          threads.emplace_back(run, i);
+        }
+        catch (const std::system_error &)
+        {
+          run(i);
+        }
+      }
+
+      run(0);
+
+      for (auto &t : threads)
+      {
+        t.join();
+      }
+
+      for (const auto &e : errors)
+      {
+        if (e)
+        {
+          std::rethrow_exception(e);
+        }
+      }
+
+      std::vector<R> out;
+      out.reserve(n);
+      for (auto &r : results)
+      {
+        out.push_back(std::move(*r));
+      }
+      return out;
+    }
+
+  public:
+    /**
+     * @brief Construct a sharded repository.
+     *
+     * @param pools One pool per shard, in shard order.
+     * @param table Table name, identical on every shard.
+     * @param options Shard key and strategy.
+     *
+     * @throws vix::db::DBError on an empty pool list, a null pool or
+     *         invalid options (see ShardRouter).
+     */
+    ShardedRepository(const std::vector<vix::db::ConnectionPool *> &pools,
+                      std::string table,
+                      ShardingOptions options = ShardingOptions{})
+        : router_(std::move(options), pools.size())
+    {
+      shards_.reserve(pools.size());
+      for (vix::db::ConnectionPool *pool : pools)
+      {
+        if (pool == nullptr)
+        {
+          throw vix::db::DBError("ShardedRepository: null shard pool");
+        }
+        shards_.emplace_back(*pool, table);
+      }
+    }
+
+    /**
+     * @brief Return the database table name.
+     */
+    const std::string &table() const noexcept
+    {
+      return shards_.front().table();
+    }
+
+    /**
+     * @brief Number of shards.
+     */
+    std::size_t shardCount() const noexcept
+    {
+      return shards_.size();
+    }
+
+    /**
+     * @brief Key-to-shard mapping.
+     */
+    const ShardRouter &router() const noexcept
+    {
+      return router_;
+    }
+
+    /**
+     * @brief Shard holding an integer key.
+     */
+    std::size_t shardFor(std::int64_t key) const noexcept
+    {
+      return router_.shardFor(key);
+    }
+
+    /**
+     * @brief Shard holding a text key (hash strategy only).
+     *
+     * @throws vix::db::DBError with range sharding.
+     */
+    std::size_t shardFor(std::string_view key) const
+    {
+      return router_.shardFor(key);
+    }
+
+    /**
+     * @brief Repository of shard @p index.
+     */
+    BaseRepository<T> &shard(std::size_t index)
+    {
+      return shards_.at(index);
+    }
+
+    /**
+     * @brief Repository of the shard holding @p key.
+     */
+    template <class Key>
+    BaseRepository<T> &forKey(const Key &key)
+    {
+      if constexpr (std::is_integral_v<Key>)
+      {
+        return shards_[shardFor(static_cast<std::int64_t>(key))];
+      }
+      else
+      {
+        return shards_[shardFor(std::string_view(key))];
+      }
+    }
+
+    /**
+     * @brief Install a client-side id generator for nextId().
+     */
+    void setIdGenerator(std::shared_ptr<IdGenerator> generator)
+    {
+      ids_ = std::move(generator);
+    }
+
+    /**
+     * @brief Draw an id for a new entity before routing it.
+     *
+     * @throws vix::db::DBError if no id generator is installed.
+     */
+    std::int64_t nextId()
+    {
+      if (!ids_)
+      {
+        throw vix::db::DBError("ShardedRepository: no id generator installed");
+      }
+      return ids_->next();
+    }
+
+    /**
+     * @brief Insert an entity into the shard of its key.
+     *
+     * @return Generated primary key reported by the shard.
+     */
+    std::uint64_t create(const T &value)
+    {
+      return shards_[shardOf(Mapper<T>::toInsertFields(value), "create")].create(value);
+    }
+
+    /**
+     * @brief Insert entities, one batch per shard, shards in parallel.
+     *
+     * @return Ids in input order when every shard knows them, otherwise empty.
+     */
+    std::vector<std::int64_t> createMany(const std::vector<T> &values)
+    {
+      const std::size_t n = shards_.size();
+      std::vector<std::vector<T>> groups(n);
+      std::vector<std::vector<std::size_t>> positions(n);
+
+      for (std::size_t i = 0; i < values.size(); ++i)
+      {
+        const std::size_t s = shardOf(Mapper<T>::toInsertFields(values[i]), "createMany");
+        groups[s].push_back(values[i]);
+        positions[s].push_back(i);
+      }
+
+      std::vector<std::int64_t> ids(values.size());
+      std::size_t known = 0;
+
+      const auto created = scatter([&](BaseRepository<T> &shard)
+                                   { return shard.createMany(groups[&shard - shards_.data()]); });
+
+      for (std::size_t s = 0; s < n; ++s)
+      {
+        if (created[s].size() != positions[s].size())
+        {
+          continue;
+        }
+        for (std::size_t k = 0; k < created[s].size(); ++k)
+        {
+          ids[positions[s][k]] = created[s][k];
+        }
+        known += created[s].size();
+      }
+
+      if (known != values.size())
+      {
+        ids.clear();
+      }
+      return ids;
+    }
+
+    /**
+     * @brief Find by primary key: one shard when sharded by id, else all.
+     */
+    std::optional<T> findById(std::int64_t id)
+    {
+      if (keyedById())
+      {
+        return shards_[shardFor(id)].findById(id);
+      }
+
+      for (auto &found : scatter([id](BaseRepository<T> &shard)
+                                 { return shard.findById(id); }))
+      {
+        if (found)
+        {
+          return found;
+        }
+      }
+      return std::nullopt;
+    }
+
+    /**
+     * @brief Update by primary key in the shard of the entity's key.
+     *
+     * When sharding by id the id routes; otherwise the shard key is
+     * read from Mapper<T>::toInsertFields(value). Changing the shard key
+     * would move the row, which updateById does not do: remove it and
+     * create() it again instead.
+     *
+     * @return Rows updated; 0 if no shard holds @p id.
+     * @throws vix::db::DBError when @p id lives on another shard than
+     *         the one @p value's shard key routes to.
+     */
+    std::uint64_t updateById(std::int64_t id, const T &value)
+    {
+      if (keyedById())
+      {
+        return shards_[shardFor(id)].updateById(id, value);
+      }
+
+      const std::size_t s = shardOf(Mapper<T>::toInsertFields(value), "updateById");
+      const std::uint64_t updated = shards_[s].updateById(id, value);
+      if (updated != 0)
+      {
+        return updated;
+      }
+
+      const auto found = scatter([id](BaseRepository<T> &shard)
+                                 { return shard.existsById(id); });
+      for (std::size_t i = 0; i < found.size(); ++i)
+      {
+        if (found[i] && i != s)
+        {
+          throw vix::db::DBError("ShardedRepository: updateById of id " + std::to_string(id) +
+                                 " changes its shard key '" + router_.options().keyColumn +
+                                 "'; remove the row and create it again");
+        }
+      }
+      return 0;
+    }
+
+    /**
+     * @brief Delete by primary key: one shard when sharded by id, else all.
+     */
+    std::uint64_t removeById(std::int64_t id)
+    {
+      if (keyedById())
+      {
+        return shards_[shardFor(id)].removeById(id);
+      }
+
+      std::uint64_t removed = 0;
+      for (std::uint64_t n : scatter([id](BaseRepository<T> &shard)
+                                     { return shard.removeById(id); }))
+      {
+        removed += n;
+      }
+      return removed;
+    }
+
+    /**
+     * @brief All rows of all shards, shard by shard.
+     */
+    std::vector<T> findAll()
+    {
+      auto parts = scatter([](BaseRepository<T> &shard)
+                           { return shard.findAll(); });
+
+      std::size_t total = 0;
+      for (const auto &part : parts)
+      {
+        total += part.size();
+      }
+
+      std::vector<T> out;
+      out.reserve(total);
+      for (auto &part : parts)
+      {
+        std::move(part.begin(), part.end(), std::back_inserter(out));
+      }
+      return out;
+    }
+
+    /**
+     * @brief Total row count across shards.
+     */
+    std::uint64_t count()
+    {
+      std::uint64_t total = 0;
+      for (std::uint64_t n : scatter([](BaseRepository<T> &shard)
+                                     { return shard.count(); }))
+      {
+        total += n;
+      }
+      return total;
+    }
+
+    /**
+     * @brief Matching row count across shards.
+     */
+    std::uint64_t countWhere(const QueryBuilder &where)
+    {
+      std::uint64_t total = 0;
+      for (std::uint64_t n : scatter([&](BaseRepository<T> &shard)
+                                     { return shard.countWhere(where); }))
+      {
+        total += n;
+      }
+      return total;
+    }
+
+    /**
+     * @brief One page of rows ordered by a mapped column, across shards.
+     *
+     * Every shard returns its first offset + limit rows ordered by
+     * (column, id); a k-way merge over the shard results then skips
+     * @p page.offset rows and keeps @p page.limit. The merge compares
+     * values with operator<, which only agrees with the database order
+     * for numeric and time columns, so text columns (ordered by the
+     * database collation) are rejected at compile time. Deep offsets
+     * cost offset + limit rows per shard, so prefer narrowing @p where
+     * (keyset paging) for deep scrolling.
+     *
+     * @tparam Member Pointer to a non-text data member of T with a Column<> mapping.
+     * @tparam IdMember Pointer to the data member holding the primary key.
+     * @param page Limit, offset and direction.
+     * @param where Optional WHERE predicate fragment.
+     * @return Rows of the page in order.
+     */
+    template <auto Member, auto IdMember = &T::id>
+    std::vector<T> findPage(const PageRequest &page, const QueryBuilder &where = QueryBuilder{})
+    {
+      using Value = std::remove_cv_t<detail::member_value_t<Member>>;
+      static_assert(!std::is_convertible_v<const detail::column_value_t<Value> &, std::string_view>,
+                    "ShardedRepository::findPage: text columns follow the database collation "
+                    "and cannot be merged across shards");
+      static_assert(std::is_same_v<detail::member_owner_t<IdMember>, T> &&
+                        std::is_integral_v<detail::member_value_t<IdMember>>,
+                    "ShardedRepository::findPage: IdMember must be an integer member of T");
+
+      if (page.limit == 0)
+      {
+        return {};
+      }
+
+      const PageRequest head{page.offset + page.limit, 0, page.descending};
+      auto parts = scatter([&](BaseRepository<T> &shard)
+                           { return shard.template findPage<Member>(head, where); });
+
+      const auto before = [&](const T &a, const T &b)
+      {
+        const T &x = page.descending ? b : a;
+        const T &y = page.descending ? a : b;
+        if (x.*Member < y.*Member)
+        {
+          return true;
+        }
+        if (y.*Member < x.*Member)
+        {
+          return false;
+        }
+        return x.*IdMember < y.*IdMember;
+      };
+
+      return detail::merge_pages(parts, page.offset, page.limit, before);
+    }
+  };
+
+} // namespace vix::orm
+
+#endif // VIX_ORM_SHARDED_REPOSITORY_HPP
@@ -0,0 +1,261 @@
+/**
+ *
+ *  @file SqlTemplate.hpp
+ *  @author Gaspard Kirira
+ *
+ *  Copyright 2025, Gaspard Kirira.
+ *  All rights reserved.
+ *  https://github.com/vixcpp/vix
+ *
+ *  Use of this source code is governed by a MIT license
+ *  that can be found in the License file.
+ *
+ *  Vix.cpp
+ */
+#ifndef VIX_ORM_SQL_TEMPLATE_HPP
+#define VIX_ORM_SQL_TEMPLATE_HPP
+
+#include <vix/orm/db_compat.hpp>
+#include <vix/orm/Fingerprint.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <utility>
+
+namespace vix::orm
+{
+  /**
+   * @brief Fixed-size string usable as a non-type template parameter.
+   *
+   * @tparam N Size of the literal including the terminating null byte.
+   */
+  template <std::size_t N>
+  struct FixedString
+  {
+    char data[N]{};
+
+    constexpr FixedString(const char (&s)[N]) noexcept
+    {
+      for (std::size_t i = 0; i < N; ++i)
+      {
+        data[i] = s[i];
+      }
+    }
+
+    constexpr std::size_t size() const noexcept
+    {
+      return N - 1;
+    }
+
+    constexpr std::string_view view() const noexcept
+    {
+      return std::string_view(data, N - 1);
+    }
+  };
+
+  namespace detail
+  {
+    /**
+     * @brief Count positional '?' placeholders in a SQL string.
+     *
+     * Placeholders inside quoted literals, quoted identifiers and
+     * comments are ignored.
+     *
+     * @param sql SQL text.
+     * @return Number of placeholders.
+     */
+    constexpr std::size_t count_placeholders(std::string_view sql) noexcept
+    {
+      std::size_t count = 0;
+      std::size_t i = 0;
+
+      while (i < sql.size())
+      {
+        const char c = sql[i];
+
+        if (c == '\'' || c == '"' || c == '`')
+        {
+          ++i;
+          while (i < sql.size())
+          {
+            if (sql[i] == c)
+            {
+              if (i + 1 < sql.size() && sql[i + 1] == c)
+              {
+                i += 2;
+                continue;
+              }
+              break;
+            }
+            ++i;
+          }
+          ++i;
+          continue;
+        }
+
+        if (c == '-' && i + 1 < sql.size() && sql[i + 1] == '-')
+        {
+          while (i < sql.size() && sql[i] != '\n')
+          {
+            ++i;
+          }
+          continue;
+        }
+
+        if (c == '/' && i + 1 < sql.size() && sql[i + 1] == '*')
+        {
+          i += 2;
+          while (i + 1 < sql.size() && !(sql[i] == '*' && sql[i + 1] == '/'))
+          {
+            ++i;
+          }
+          i += 2;
+          continue;
+        }
+
+        if (c == '?')
+        {
+          ++count;
+        }
+
+        ++i;
+      }
+
+      return count;
+    }
+  } // namespace detail
+
+  /**
+   * @brief Compile-time SQL statement template.
+   *
+   * The SQL text, its placeholder count, its key and its fingerprint
+   * are all computed at compile time. Binding requires exactly as many
+   * typed arguments as the statement has placeholders, and every
+   * argument type must satisfy DbBindable.
+   *
+   * The key hashes the exact SQL text and is intended to be used as a
+   * statement-cache key without rehashing at runtime. The fingerprint
+   * is the normalized SqlFingerprint, which matches
+   * QueryBuilder::fingerprint() for the same statement; it is meant for
+   * statistics and logs only.
+   *
+   * Example:
+   * @code
+   * constexpr auto byEmail =
+   *     vix::orm::sql<"SELECT id, name FROM users WHERE email = ? LIMIT ?">;
+   *
+   * vix::db::PooledConn conn(pool);
+   * auto rs = byEmail.query(conn.get(), email, 1);
+   * @endcode
+   *
+   * @tparam Sql SQL literal.
+   */
+  template <FixedString Sql>
+  struct SqlTemplate
+  {
+    /**
+     * @brief SQL text.
+     */
+    static constexpr std::string_view text = Sql.view();
+
+    /**
+     * @brief Number of positional placeholders.
+     */
+    static constexpr std::size_t placeholders = detail::count_placeholders(text);
+
+    /**
+     * @brief Stable 64-bit FNV-1a hash of the exact SQL text.
+     */
+    static constexpr std::uint64_t key =
+        detail::fnv1a_update(detail::fnv1a_basis, text);
+
+    /**
+     * @brief Normalized 64-bit fingerprint of the SQL text.
+     *
+     * Distinct statements may share a fingerprint; see SqlFingerprint.
+     */
+    static constexpr std::uint64_t fingerprint = sql_fingerprint(text);
+
+    /**
+     * @brief Return the SQL text.
+     *
+     * @return SQL text.
+     */
+    constexpr std::string_view sql() const noexcept
+    {
+      return text;
+    }
+
+    /**
+     * @brief Bind typed arguments to a prepared statement.
+     *
+     * Binding starts at index 1.
+     *
+     * @param st Prepared statement.
+     * @param args Exactly @ref placeholders arguments.
+     */
+    template <DbBindable... Args>
+      requires(sizeof...(Args) == placeholders)
+    void bind(vix::db::Statement &st, Args &&...args) const
+    {
+      std::size_t index = 1;
+      (st.bind(index++, to_dbvalue(std::forward<Args>(args))), ...);
+    }
+
+    /**
+     * @brief Prepare and bind this statement on a connection.
+     *
+     * @param conn Database connection.
+     * @param args Exactly @ref placeholders arguments.
+     * @return Prepared statement ready for execution.
+     */
+    template <DbBindable... Args>
+      requires(sizeof...(Args) == placeholders)
+    auto prepare(vix::db::Connection &conn, Args &&...args) const
+    {
+      auto st = conn.prepare(text);
+      bind(*st, std::forward<Args>(args)...);
+      return st;
+    }
+
+    /**
+     * @brief Prepare, bind and run this statement as a query.
+     *
+     * @param conn Database connection.
+     * @param args Exactly @ref placeholders arguments.
+     * @return Result set.
+     */
+    template <DbBindable... Args>
+      requires(sizeof...(Args) == placeholders)
+    auto query(vix::db::Connection &conn, Args &&...args) const
+    {
+      return prepare(conn, std::forward<Args>(args)...)->query();
+    }
+
+    /**
+     * @brief Prepare, bind and execute this statement.
+     *
+     * @param conn Database connection.
+     * @param args Exactly @ref placeholders arguments.
+     * @return Number of affected rows.
+     */
+    template <DbBindable... Args>
+      requires(sizeof...(Args) == placeholders)
+    std::uint64_t exec(vix::db::Connection &conn, Args &&...args) const
+    {
+      return prepare(conn, std::forward<Args>(args)...)->exec();
+    }
+  };
+
+  /**
+   * @brief Compile-time SQL template instance.
+   *
+   * @tparam Sql SQL literal.
+   */
+  template <FixedString Sql>
+  inline constexpr SqlTemplate<Sql> sql{};
+
+} // namespace vix::orm
+
+#endif // VIX_ORM_SQL_TEMPLATE_HPP
@@ -0,0 +1,842 @@
+/**
+ *
+ *  @file TypedQuery.hpp
+ *  @author Gaspard Kirira
+ *
+ *  Copyright 2025, Gaspard Kirira.
+ *  All rights reserved.
+ *  https://github.com/vixcpp/vix
+ *
+ *  Use of this source code is governed by a MIT license
+ *  that can be found in the License file.
+ *
+ *  Vix.cpp
+ */
+#ifndef VIX_ORM_TYPED_QUERY_HPP
+#define VIX_ORM_TYPED_QUERY_HPP
+
+#include <vix/orm/db_compat.hpp>
+#include <vix/orm/Fingerprint.hpp>
+#include <vix/orm/Mapper.hpp>
+#include <vix/orm/QueryBuilder.hpp>
+#include <vix/orm/SqlTemplate.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace vix::orm
+{
+  /**
+   * @brief User-specialized table name for an entity type.
+   *
+   * Example:
+   * @code
+   * template <>
+   * struct vix::orm::Table<User>
+   * {
+   *   static constexpr std::string_view name = "users";
+   * };
+   * @endcode
+   *
+   * @tparam T Entity type.
+   */
+  template <class T>
+  struct Table
+  {
+    static_assert(detail::always_false_v<T>,
+                  "vix::orm::Table<T> is not specialized. "
+                  "Declare static constexpr std::string_view name.");
+  };
+
+  /**
+   * @brief User-specialized column name for a data member.
+   *
+   * Example:
+   * @code
+   * template <>
+   * struct vix::orm::Column<&User::email>
+   * {
+   *   static constexpr std::string_view name = "email";
+   * };
+   * @endcode
+   *
+   * @tparam Member Pointer to data member.
+   */
+  template <auto Member>
+  struct Column
+  {
+    static_assert(detail::always_false_v<decltype(Member)>,
+                  "vix::orm::Column<&T::member> is not specialized. "
+                  "Declare static constexpr std::string_view name.");
+  };
+
+  /**
+   * @brief Positional query argument, bound at execution time.
+   *
+   * @tparam I One-based argument number.
+   */
+  template <std::size_t I>
+  struct Placeholder
+  {
+    static_assert(I > 0, "vix::orm::Placeholder index starts at 1");
+  };
+
+  namespace placeholders
+  {
+    inline constexpr Placeholder<1> _1{};
+    inline constexpr Placeholder<2> _2{};
+    inline constexpr Placeholder<3> _3{};
+    inline constexpr Placeholder<4> _4{};
+    inline constexpr Placeholder<5> _5{};
+    inline constexpr Placeholder<6> _6{};
+    inline constexpr Placeholder<7> _7{};
+    inline constexpr Placeholder<8> _8{};
+    inline constexpr Placeholder<9> _9{};
+  } // namespace placeholders
+
+  namespace detail
+  {
+    template <class M>
+    struct member_pointer_traits;
+
+    template <class C, class V>
+    struct member_pointer_traits<V C::*>
+    {
+      using owner_type = C;
+      using value_type = V;
+    };
+
+    template <auto Member>
+    using member_owner_t =
+        typename member_pointer_traits<decltype(Member)>::owner_type;
+
+    template <auto Member>
+    using member_value_t =
+        typename member_pointer_traits<decltype(Member)>::value_type;
+
+    /**
+     * @brief Compile-time SQL output.
+     *
+     * When both buffers are null the sink only measures, which lets
+     * rendering run twice: once to size the storage, once to fill it.
+     */
+    struct SqlSink
+    {
+      char *text = nullptr;
+      std::size_t *args = nullptr;
+      std::size_t textSize = 0;
+      std::size_t argCount = 0;
+
+      constexpr void put(std::string_view s)
+      {
+        for (char c : s)
+        {
+          if (text != nullptr)
+          {
+            text[textSize] = c;
+          }
+          ++textSize;
+        }
+      }
+
+      constexpr void putNumber(std::size_t n)
+      {
+        char digits[20]{};
+        std::size_t len = 0;
+
+        do
+        {
+          digits[len++] = static_cast<char>('0' + (n % 10));
+          n /= 10;
+        } while (n != 0);
+
+        while (len > 0)
+        {
+          put(std::string_view(&digits[--len], 1));
+        }
+      }
+
+      constexpr void placeholder(std::size_t index)
+      {
+        put("?");
+        if (args != nullptr)
+        {
+          args[argCount] = index;
+        }
+        ++argCount;
+      }
+    };
+
+    /**
+     * @brief Rendered SQL text plus the argument number of each '?'.
+     */
+    template <std::size_t TextSize, std::size_t ArgCount>
+    struct RenderedSql
+    {
+      std::array<char, TextSize + 1> text{};
+      std::array<std::size_t, ArgCount> args{};
+
+      constexpr std::string_view view() const noexcept
+      {
+        return std::string_view(text.data(), TextSize);
+      }
+    };
+
+    template <class Node>
+    consteval auto render_sql()
+    {
+      constexpr SqlSink measured = []
+      {
+        SqlSink s;
+        Node::write(s);
+        return s;
+      }();
+
+      RenderedSql<measured.textSize, measured.argCount> out;
+      SqlSink s;
+      s.text = out.text.data();
+      s.args = out.args.data();
+      Node::write(s);
+      return out;
+    }
+
+    template <std::size_t N>
+    constexpr std::size_t max_arg(const std::array<std::size_t, N> &args)
+    {
+      std::size_t m = 0;
+      for (std::size_t a : args)
+      {
+        m = a > m ? a : m;
+      }
+      return m;
+    }
+
+    template <std::size_t N>
+    constexpr bool args_contiguous(const std::array<std::size_t, N> &args)
+    {
+      const std::size_t m = max_arg(args);
+      for (std::size_t k = 1; k <= m; ++k)
+      {
+        bool found = false;
+        for (std::size_t a : args)
+        {
+          found = found || a == k;
+        }
+        if (!found)
+        {
+          return false;
+        }
+      }
+      return true;
+    }
+
+    template <auto... Members>
+    struct ColumnList
+    {
+      static constexpr void write(SqlSink &s)
+      {
+        std::size_t i = 0;
+        ((s.put(i++ == 0 ? "" : ", "), s.put(Column<Members>::name)), ...);
+      }
+    };
+
+    struct NoClause
+    {
+      template <class E>
+      static constexpr bool belongs_to = true;
+
+      template <std::size_t Arg, class A>
+      static constexpr bool accepts = true;
+    };
+
+    template <bool Desc, auto Member>
+    struct OrderTerm
+    {
+      static constexpr void write(SqlSink &s)
+      {
+        s.put(Column<Member>::name);
+        if constexpr (Desc)
+        {
+          s.put(" DESC");
+        }
+      }
+    };
+
+    template <class... Terms>
+    struct OrderList
+    {
+      static constexpr void write(SqlSink &s)
+      {
+        if constexpr (sizeof...(Terms) > 0)
+        {
+          s.put(" ORDER BY ");
+          std::size_t i = 0;
+          ((s.put(i++ == 0 ? "" : ", "), Terms::write(s)), ...);
+        }
+      }
+    };
+
+    template <std::size_t I>
+    struct BoundCount
+    {
+      template <std::size_t Arg, class A>
+      static constexpr bool accepts = Arg != I || std::is_integral_v<std::remove_cvref_t<A>>;
+
+      static constexpr void write(SqlSink &s)
+      {
+        s.placeholder(I);
+      }
+    };
+
+    template <std::size_t N>
+    struct LiteralCount
+    {
+      template <std::size_t Arg, class A>
+      static constexpr bool accepts = true;
+
+      static constexpr void write(SqlSink &s)
+      {
+        s.putNumber(N);
+      }
+    };
+  } // namespace detail
+
+  /**
+   * @brief Comparison operators supported by typed predicates.
+   */
+  enum class CompareOp
+  {
+    Eq,
+    Ne,
+    Lt,
+    Le,
+    Gt,
+    Ge
+  };
+
+  /**
+   * @brief Typed reference to a mapped column.
+   *
+   * @tparam Member Pointer to data member.
+   */
+  template <auto Member>
+  struct ColumnRef
+  {
+  };
+
+  /**
+   * @brief Column reference variable template, e.g. col<&User::age>.
+   */
+  template <auto Member>
+  inline constexpr ColumnRef<Member> col{};
+
+  /**
+   * @brief Predicate comparing a column with a positional argument.
+   */
+  template <auto Member, CompareOp Op, std::size_t I>
+  struct Compare
+  {
+    static constexpr bool is_predicate = true;
+
+    /// Whether the column is a member of entity E.
+    template <class E>
+    static constexpr bool belongs_to = std::is_same_v<detail::member_owner_t<Member>, E>;
+
+    /// Whether argument number Arg may have type A.
+    template <std::size_t Arg, class A>
+    static constexpr bool accepts =
+        Arg != I || std::is_convertible_v<A, detail::member_value_t<Member>>;
+
+    static constexpr void write(detail::SqlSink &s)
+    {
+      constexpr std::string_view ops[] = {" = ", " <> ", " < ", " <= ", " > ", " >= "};
+
+      s.put(Column<Member>::name);
+      s.put(ops[static_cast<std::size_t>(Op)]);
+      s.placeholder(I);
+    }
+  };
+
+  /**
+   * @brief Logical combination of two predicates.
+   */
+  template <bool IsAnd, class L, class R>
+  struct Logical
+  {
+    static constexpr bool is_predicate = true;
+
+    template <class E>
+    static constexpr bool belongs_to = L::template belongs_to<E> && R::template belongs_to<E>;
+
+    template <std::size_t Arg, class A>
+    static constexpr bool accepts =
+        L::template accepts<Arg, A> && R::template accepts<Arg, A>;
+
+    static constexpr void write(detail::SqlSink &s)
+    {
+      s.put("(");
+      L::write(s);
+      s.put(IsAnd ? " AND " : " OR ");
+      R::write(s);
+      s.put(")");
+    }
+  };
+
+  /**
+   * @brief Types usable in a typed WHERE clause.
+   */
+  template <class E>
+  concept TypedPredicate = E::is_predicate;
+
+  template <auto M, std::size_t I>
+  constexpr Compare<M, CompareOp::Eq, I> operator==(ColumnRef<M>, Placeholder<I>) noexcept { return {}; }
+
+  template <auto M, std::size_t I>
+  constexpr Compare<M, CompareOp::Ne, I> operator!=(ColumnRef<M>, Placeholder<I>) noexcept { return {}; }
+
+  template <auto M, std::size_t I>
+  constexpr Compare<M, CompareOp::Lt, I> operator<(ColumnRef<M>, Placeholder<I>) noexcept { return {}; }
+
+  template <auto M, std::size_t I>
+  constexpr Compare<M, CompareOp::Le, I> operator<=(ColumnRef<M>, Placeholder<I>) noexcept { return {}; }
+
+  template <auto M, std::size_t I>
+  constexpr Compare<M, CompareOp::Gt, I> operator>(ColumnRef<M>, Placeholder<I>) noexcept { return {}; }
+
+  template <auto M, std::size_t I>
+  constexpr Compare<M, CompareOp::Ge, I> operator>=(ColumnRef<M>, Placeholder<I>) noexcept { return {}; }
+
+  template <TypedPredicate L, TypedPredicate R>
+  constexpr Logical<true, L, R> operator&&(L, R) noexcept { return {}; }
+
+  template <TypedPredicate L, TypedPredicate R>
+  constexpr Logical<false, L, R> operator||(L, R) noexcept { return {}; }
+
+  namespace detail
+  {
+    /**
+     * @brief SELECT statement renderer of a TypedQuery.
+     *
+     * Kept outside TypedQuery so the SQL can be rendered in its static
+     * member initializers, where TypedQuery itself is still incomplete.
+     */
+    template <class T, class Cols, class Where, class Order, class Limit>
+    struct SelectNode
+    {
+      static constexpr void write(SqlSink &s)
+      {
+        s.put("SELECT ");
+        Cols::write(s);
+        s.put(" FROM ");
+        s.put(Table<T>::name);
+
+        if constexpr (!std::is_same_v<Where, NoClause>)
+        {
+          s.put(" WHERE ");
+          Where::write(s);
+        }
+
+        Order::write(s);
+
+        if constexpr (!std::is_same_v<Limit, NoClause>)
+        {
+          s.put(" LIMIT ");
+          Limit::write(s);
+        }
+      }
+    };
+  } // namespace detail
+
+  /**
+   * @brief Compile-time typed SELECT query.
+   *
+   * All SQL composition happens at compile time: sql() returns a view
+   * over static storage and rows decode positionally into a tuple of
+   * the selected member types, with no name lookups.
+   *
+   * Instances are empty and are produced by select<...>().from<T>().
+   *
+   * @tparam T Entity type.
+   * @tparam Cols detail::ColumnList of selected members.
+   * @tparam Where Predicate or detail::NoClause.
+   * @tparam Order detail::OrderList.
+   * @tparam Limit Limit node or detail::NoClause.
+   */
+  template <class T, class Cols, class Where, class Order, class Limit>
+  class TypedQuery;
+
+  template <class T, auto... Members, class Where, class Order, class Limit>
+  class TypedQuery<T, detail::ColumnList<Members...>, Where, Order, Limit>
+  {
+    template <class, class, class, class, class>
+    friend class TypedQuery;
+
+  public:
+    /**
+     * @brief Render the statement into a compile-time sink.
+     *
+     * @param s SQL sink.
+     */
+    static constexpr void write(detail::SqlSink &s)
+    {
+      Node::write(s);
+    }
+
+  private:
+    using Node = detail::SelectNode<T, detail::ColumnList<Members...>, Where, Order, Limit>;
+
+    static constexpr auto rendered_ = detail::render_sql<Node>();
+
+    template <class... Args, std::size_t... K>
+    static constexpr bool argsMatch(std::index_sequence<K...>) noexcept
+    {
+      return ((Where::template accepts<K + 1, Args> &&
+               Limit::template accepts<K + 1, Args>) &&
+              ...);
+    }
+
+    template <std::size_t... I>
+    static auto decodeImpl(const vix::db::ResultRow &row,
+                           std::index_sequence<I...>)
+    {
+      return Row{read_column<detail::member_value_t<Members>>(row, I)...};
+    }
+
+    template <class... Args>
+    static void bindImpl(vix::db::Statement &st, Args &&...args)
+    {
+      static_assert(argsMatch<Args...>(std::index_sequence_for<Args...>{}),
+                    "vix::orm::TypedQuery: argument type does not match its column or LIMIT");
+
+      if constexpr (arity > 0)
+      {
+        const std::array<vix::db::DbValue, arity> values{
+            to_dbvalue(std::forward<Args>(args))...};
+
+        for (std::size_t i = 0; i < rendered_.args.size(); ++i)
+        {
+          st.bind(i + 1, values[rendered_.args[i] - 1]);
+        }
+      }
+    }
+
+    template <bool Desc, auto Member>
+    static constexpr auto withOrder()
+    {
+      return []<class... Terms>(detail::OrderList<Terms...>)
+      {
+        return TypedQuery<T, detail::ColumnList<Members...>, Where,
+                          detail::OrderList<Terms..., detail::OrderTerm<Desc, Member>>,
+                          Limit>{};
+      }(Order{});
+    }
+
+  public:
+    /**
+     * @brief Decoded row type.
+     */
+    using Row = std::tuple<detail::member_value_t<Members>...>;
+
+    /**
+     * @brief Number of arguments expected at execution time.
+     */
+    static constexpr std::size_t arity = detail::max_arg(rendered_.args);
+
+    static_assert(detail::args_contiguous(rendered_.args),
+                  "vix::orm::TypedQuery: placeholders must be numbered _1.._N without gaps");
+
+    /**
+     * @brief Return the generated SQL.
+     *
+     * @return SQL text in static storage.
+     */
+    static constexpr std::string_view sql() noexcept
+    {
+      return rendered_.view();
+    }
+
+    /**
+     * @brief Stable 64-bit hash of the generated SQL.
+     */
+    static constexpr std::uint64_t key =
+        detail::fnv1a_update(detail::fnv1a_basis, rendered_.view());
+
+    /**
+     * @brief Normalized 64-bit fingerprint of the generated SQL.
+     *
+     * For statistics and logs only; see SqlFingerprint.
+     */
+    static constexpr std::uint64_t fingerprint = sql_fingerprint(rendered_.view());
+
+    /**
+     * @brief Add a WHERE predicate.
+     *
+     * Every predicate column must belong to T. Arguments passed at
+     * execution time must convert to the type of the member they are
+     * compared with.
+     *
+     * @param predicate Typed predicate, e.g. col<&User::age> > _1.
+     * @return New query type.
+     */
+    template <TypedPredicate P>
+    constexpr auto where(P) const noexcept
+    {
+      static_assert(std::is_same_v<Where, detail::NoClause>,
+                    "vix::orm::TypedQuery: where() already set; combine predicates with && or ||");
+      static_assert(P::template belongs_to<T>,
+                    "vix::orm::TypedQuery: where() column belongs to another entity");
+      return TypedQuery<T, detail::ColumnList<Members...>, P, Order, Limit>{};
+    }
+
+    /**
+     * @brief Append an ascending ORDER BY term.
+     *
+     * @return New query type.
+     */
+    template <auto Member>
+    constexpr auto orderBy() const noexcept
+    {
+      static_assert(std::is_same_v<detail::member_owner_t<Member>, T>,
+                    "vix::orm::TypedQuery: orderBy column belongs to another entity");
+      return withOrder<false, Member>();
+    }
+
+    /**
+     * @brief Append a descending ORDER BY term.
+     *
+     * @return New query type.
+     */
+    template <auto Member>
+    constexpr auto orderByDesc() const noexcept
+    {
+      static_assert(std::is_same_v<detail::member_owner_t<Member>, T>,
+                    "vix::orm::TypedQuery: orderBy column belongs to another entity");
+      return withOrder<true, Member>();
+    }
+
+    /**
+     * @brief Limit the result size with a positional argument.
+     *
+     * @return New query type.
+     */
+    template <std::size_t I>
+    constexpr auto limit(Placeholder<I>) const noexcept
+    {
+      return TypedQuery<T, detail::ColumnList<Members...>, Where, Order,
+                        detail::BoundCount<I>>{};
+    }
+
+    /**
+     * @brief Limit the result size with a compile-time constant.
+     *
+     * @return New query type.
+     */
+    template <std::size_t N>
+    constexpr auto limit() const noexcept
+    {
+      return TypedQuery<T, detail::ColumnList<Members...>, Where, Order,
+                        detail::LiteralCount<N>>{};
+    }
+
+    /**
+     * @brief Decode a result row into the typed row tuple.
+     *
+     * @param row Database result row.
+     * @return Decoded row.
+     */
+    static Row decode(const vix::db::ResultRow &row)
+    {
+      return decodeImpl(row, std::index_sequence_for<decltype(Members)...>{});
+    }
+
+    /**
+     * @brief Bind execution arguments to a prepared statement.
+     *
+     * @param st Prepared statement.
+     * @param args Exactly @ref arity arguments.
+     */
+    template <DbBindable... Args>
+      requires(sizeof...(Args) == arity)
+    void bind(vix::db::Statement &st, Args &&...args) const
+    {
+      bindImpl(st, std::forward<Args>(args)...);
+    }
+
+    /**
+     * @brief Produce an equivalent QueryBuilder.
+     *
+     * @param args Exactly @ref arity arguments.
+     * @return QueryBuilder holding the SQL and ordered parameters.
+     */
+    template <DbBindable... Args>
+      requires(sizeof...(Args) == arity)
+    QueryBuilder toBuilder(Args &&...args) const
+    {
+      static_assert(argsMatch<Args...>(std::index_sequence_for<Args...>{}),
+                    "vix::orm::TypedQuery: argument type does not match its column or LIMIT");
+
+      QueryBuilder qb(sql());
+
+      if constexpr (arity > 0)
+      {
+        const std::array<vix::db::DbValue, arity> values{
+            to_dbvalue(std::forward<Args>(args))...};
+
+        qb.reserve(0, rendered_.args.size());
+        for (std::size_t a : rendered_.args)
+        {
+          qb.param(values[a - 1]);
+        }
+      }
+
+      return qb;
+    }
+
+    /**
+     * @brief Run the query and decode all rows.
+     *
+     * @param conn Database connection.
+     * @param args Exactly @ref arity arguments.
+     * @return Decoded rows.
+     */
+    template <DbBindable... Args>
+      requires(sizeof...(Args) == arity)
+    std::vector<Row> fetch(vix::db::Connection &conn, Args &&...args) const
+    {
+      auto st = conn.prepare(sql());
+      bindImpl(*st, std::forward<Args>(args)...);
+
+      auto rs = st->query();
+
+      std::vector<Row> out;
+      while (rs && rs->next())
+      {
+        out.push_back(decode(rs->row()));
+      }
+
+      return out;
+    }
+
+    /**
+     * @brief Run the query and decode the first row.
+     *
+     * @param conn Database connection.
+     * @param args Exactly @ref arity arguments.
+     * @return First decoded row, or std::nullopt.
+     */
+    template <DbBindable... Args>
+      requires(sizeof...(Args) == arity)
+    std::optional<Row> fetchOne(vix::db::Connection &conn, Args &&...args) const
+    {
+      auto st = conn.prepare(sql());
+      bindImpl(*st, std::forward<Args>(args)...);
+
+      auto rs = st->query();
+      if (!rs || !rs->next())
+      {
+        return std::nullopt;
+      }
+
+      return decode(rs->row());
+    }
+  };
+
+  /**
+   * @brief Column selection awaiting its source table.
+   *
+   * @tparam Members Selected data members.
+   */
+  template <auto... Members>
+  struct Selection
+  {
+    /**
+     * @brief Bind the selection to an entity table.
+     *
+     * @tparam T Entity type owning every selected member.
+     * @return Typed query.
+     */
+    template <class T>
+    constexpr auto from() const noexcept
+    {
+      static_assert((std::is_same_v<detail::member_owner_t<Members>, T> && ...),
+                    "vix::orm::select: every column must belong to the FROM entity");
+
+      return TypedQuery<T, detail::ColumnList<Members...>, detail::NoClause,
+                        detail::OrderList<>, detail::NoClause>{};
+    }
+  };
+
+  /**
+   * @brief Start a compile-time typed SELECT.
+   *
+   * Example:
+   * @code
+   * using namespace vix::orm::placeholders;
+   *
+   * constexpr auto adults = vix::orm::select<&User::id, &User::name>()
+   *                             .from<User>()
+   *                             .where(vix::orm::col<&User::age> > _1)
+   *                             .orderBy<&User::id>()
+   *                             .limit(_2);
+   *
+   * for (auto [id, name] : adults.fetch(conn.get(), 18, 50)) { ... }
+   * @endcode
+   *
+   * @tparam Members Pointers to selected data members.
+   * @return Selection.
+   */
+  template <auto... Members>
+  constexpr Selection<Members...> select() noexcept
+  {
+    static_assert(sizeof...(Members) > 0, "vix::orm::select: at least one column is required");
+    return {};
+  }
+
+  /**
+   * @brief Typed column assignment produced by set<&T::member>(value).
+   *
+   * @tparam Member Pointer to data member.
+   */
+  template <auto Member>
+  struct Assignment
+  {
+    using owner_type = detail::member_owner_t<Member>;
+    using value_type = detail::member_value_t<Member>;
+
+    static constexpr auto member = Member;
+
+    value_type value;
+  };
+
+  /**
+   * @brief Assign a value to a mapped column.
+   *
+   * The value must be convertible to the member type.
+   *
+   * Example:
+   * @code
+   * repo.update(id, vix::orm::set<&User::status>("active"),
+   *                 vix::orm::set<&User::lastSeen>(now));
+   * @endcode
+   *
+   * @tparam Member Pointer to data member.
+   * @param value New value.
+   * @return Typed assignment.
+   */
+  template <auto Member, class V>
+    requires std::is_convertible_v<V, detail::member_value_t<Member>>
+  constexpr Assignment<Member> set(V &&value)
+  {
+    return Assignment<Member>{detail::member_value_t<Member>(std::forward<V>(value))};
+  }
+
+} // namespace vix::orm
+
+#endif // VIX_ORM_TYPED_QUERY_HPP
@@ -32,6 +32,8 @@
 #endif
 
 #include <any>
+#include <concepts>
+#include <cstddef>
 #include <cstdint>
 #include <string>
 #include <string_view>
@@ -40,6 +42,7 @@
 #include <utility>
 #include <vector>
 #include <limits>
+#include <optional>
 
 namespace vix::orm
 {
@@ -204,6 +207,131 @@ namespace vix::orm
         std::string("ORM: unsupported std::any type: ") + value.type().name());
   }
 
+  namespace detail
+  {
+    /**
+     * @brief Detect std::optional specializations.
+     */
+    template <class T>
+    struct is_optional : std::false_type
+    {
+    };
+
+    template <class T>
+    struct is_optional<std::optional<T>> : std::true_type
+    {
+    };
+
+    /**
+     * @brief Value type of a column, without std::optional.
+     */
+    template <class V>
+    struct column_value
+    {
+      using type = V;
+    };
+
+    template <class V>
+    struct column_value<std::optional<V>>
+    {
+      using type = V;
+    };
+
+    template <class V>
+    using column_value_t = typename column_value<V>::type;
+
+    /**
+     * @brief Whether a non-reference type converts to a DbValue.
+     *
+     * std::optional<V> qualifies only when V does, so the
+     * check recurses through nested optionals.
+     */
+    template <class U>
+    struct is_db_bindable
+        : std::bool_constant<std::is_same_v<U, vix::db::DbValue> ||
+                             std::is_same_v<U, vix::db::Blob> ||
+                             std::is_same_v<U, std::nullptr_t> ||
+                             std::is_arithmetic_v<U> ||
+                             std::is_convertible_v<const U &, std::string_view>>
+    {
+    };
+
+    template <class V>
+    struct is_db_bindable<std::optional<V>> : is_db_bindable<std::remove_cv_t<V>>
+    {
+    };
+
+    /**
+     * @brief Throw unless @p name is a plain (optionally qualified) identifier.
+     *
+     * @param name Table or column name.
+     * @param context Short context string used in the error message.
+     */
+    inline void require_identifier(std::string_view name, const char *context)
+    {
+      bool ok = !name.empty();
+      for (char c : name)
+      {
+        ok = ok && ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+                    (c >= '0' && c <= '9') || c == '_' || c == '.');
+      }
+
+      if (!ok)
+      {
+        throw vix::db::DBError(std::string("ORM: invalid identifier '") +
+                               std::string(name) + "' in " + context);
+      }
+    }
+  } // namespace detail
+
+  /**
+   * @brief Types that can be converted to a DbValue without std::any.
+   *
+   * This is the statically typed counterpart of any_to_dbvalue_or_throw,
+   * used by compile-time APIs so unsupported types fail at compile time.
+   */
+  template <class V>
+  concept DbBindable =
+      detail::is_db_bindable<std::remove_cvref_t<V>>::value ||
+      std::is_convertible_v<V, std::string_view>;
+
+  /**
+   * @brief Convert a statically typed value into a vix::db::DbValue.
+   *
+   * std::optional<V> maps std::nullopt to NULL.
+   *
+   * @param value Value to convert.
+   * @return Converted DbValue.
+   */
+  template <DbBindable V>
+  inline vix::db::DbValue to_dbvalue(V &&value)
+  {
+    using U = std::remove_cvref_t<V>;
+
+    if constexpr (detail::is_optional<U>::value)
+      return value ? to_dbvalue(*std::forward<V>(value)) : vix::db::null();
+    else if constexpr (std::is_same_v<U, vix::db::DbValue>)
+      return std::forward<V>(value);
+    else if constexpr (std::is_same_v<U, vix::db::Blob>)
+      return vix::db::DbValue{std::forward<V>(value)};
+    else if constexpr (std::is_same_v<U, std::nullptr_t>)
+      return vix::db::null();
+    else if constexpr (std::is_same_v<U, bool>)
+      return vix::db::b(value);
+    else if constexpr (std::is_floating_point_v<U>)
+      return vix::db::f64(static_cast<double>(value));
+    else if constexpr (std::is_integral_v<U> && std::is_signed_v<U>)
+      return vix::db::i64(static_cast<std::int64_t>(value));
+    else if constexpr (std::is_integral_v<U>)
+      return vix::db::u64(static_cast<std::uint64_t>(value));
+    else if constexpr (std::is_same_v<U, std::string>)
+      return vix::db::str(std::forward<V>(value));
+    else if constexpr (std::is_pointer_v<U>)
+      return vix::db::str(std::string(value ? value : ""));
+    else
+      return vix::db::str(std::string(std::string_view(value)));
+  }
+
   /**
    * @brief Convert a field value directly into a DbValue.
    *
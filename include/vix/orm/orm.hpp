@@ -16,10 +16,25 @@
 #define VIX_ORM_HPP
 
 #include <vix/orm/db_compat.hpp>
+#include <vix/orm/BatchedJob.hpp>
+#include <vix/orm/BulkLoadSession.hpp>
+#include <vix/orm/Columnar.hpp>
+#include <vix/orm/Dialect.hpp>
 #include <vix/orm/Entity.hpp>
+#include <vix/orm/Errors.hpp>
+#include <vix/orm/Export.hpp>
+#include <vix/orm/Import.hpp>
+#include <vix/orm/Fingerprint.hpp>
+#include <vix/orm/IdGenerator.hpp>
+#include <vix/orm/JsonWriter.hpp>
 #include <vix/orm/Mapper.hpp>
 #include <vix/orm/QueryBuilder.hpp>
 #include <vix/orm/Repository.hpp>
+#include <vix/orm/RoutedRepository.hpp>
+#include <vix/orm/RowView.hpp>
+#include <vix/orm/ShardedRepository.hpp>
+#include <vix/orm/SqlTemplate.hpp>
+#include <vix/orm/TypedQuery.hpp>
 #include <vix/orm/UnitOfWork.hpp>
 
 #include <string>
@@ -0,0 +1,241 @@
+/**
+ *
+ *  @file BatchedJob.cpp
+ *  @author Gaspard Kirira
+ *
+ *  Copyright 2025, Gaspard Kirira.
+ *  All rights reserved.
+ *  https://github.com/vixcpp/vix
+ *
+ *  Use of this source code is governed by a MIT license
+ *  that can be found in the License file.
+ *
+ *  Vix.cpp
+ */
+#include <vix/orm/BatchedJob.hpp>
+
+#include <algorithm>
+#include <limits>
+#include <thread>
+#include <utility>
+
+namespace vix::orm
+{
+  namespace
+  {
+    /**
+     * @brief Append the [first, last] key range and the optional filter.
+     */
+    void append_range(std::string &sql, const BatchedJobOptions &o)
+    {
+      sql += " WHERE " + o.keyColumn + " >= ? AND " + o.keyColumn + " <= ?";
+      if (o.filter && !o.filter->sql().empty())
+      {
+        sql += " AND (";
+        sql.append(o.filter->sql());
+        sql += ")";
+      }
+    }
+
+    void bind_range(vix::db::Statement &st,
+                    const BatchedJobOptions &o,
+                    std::size_t index,
+                    std::int64_t first,
+                    std::int64_t last)
+    {
+      st.bind(index, first);
+      st.bind(index + 1, last);
+      if (o.filter)
+      {
+        o.filter->bind(st, index + 2);
+      }
+    }
+  } // namespace
+
+  BatchedJob::BatchedJob(vix::db::ConnectionPool &pool, BatchedJobOptions options, ChunkFn work)
+      : pool_(pool), options_(std::move(options)), work_(std::move(work))
+  {
+    if (options_.table.empty() || options_.keyColumn.empty())
+    {
+      throw vix::db::DBError("BatchedJob: table and key column are required");
+    }
+
+    detail::require_identifier(options_.table, "BatchedJob");
+    detail::require_identifier(options_.keyColumn, "BatchedJob");
+
+    if (options_.chunkSize == 0)
+    {
+      throw vix::db::DBError("BatchedJob: chunk size must be positive");
+    }
+
+    if (!(options_.dutyCycle > 0.0 && options_.dutyCycle <= 1.0))
+    {
+      throw vix::db::DBError("BatchedJob: duty cycle must be in (0, 1]");
+    }
+
+    if (!work_)
+    {
+      throw vix::db::DBError("BatchedJob: chunk function is required");
+    }
+  }
+
+  BatchedJob BatchedJob::update(vix::db::ConnectionPool &pool,
+                                BatchedJobOptions options,
+                                QueryBuilder set)
+  {
+    if (set.sql().empty())
+    {
+      throw vix::db::DBError("BatchedJob: empty SET list");
+    }
+
+    std::string sql = "UPDATE " + options.table + " SET ";
+    sql.append(set.sql());
+    append_range(sql, options);
+
+    const BatchedJobOptions o = options;
+    auto work = [o, sql = std::move(sql), set = std::move(set)](
+                    vix::db::Connection &conn, std::int64_t first, std::int64_t last)
+    {
+      auto st = conn.prepare(sql);
+      set.bind(*st);
+      bind_range(*st, o, set.paramCount() + 1, first, last);
+      return st->exec();
+    };
+
+    return BatchedJob(pool, std::move(options), std::move(work));
+  }
+
+  BatchedJob BatchedJob::purge(vix::db::ConnectionPool &pool, BatchedJobOptions options)
+  {
+    std::string sql = "DELETE FROM " + options.table;
+    append_range(sql, options);
+
+    const BatchedJobOptions o = options;
+    auto work = [o, sql = std::move(sql)](
+                    vix::db::Connection &conn, std::int64_t first, std::int64_t last)
+    {
+      auto st = conn.prepare(sql);
+      bind_range(*st, o, 1, first, last);
+      return st->exec();
+    };
+
+    return BatchedJob(pool, std::move(options), std::move(work));
+  }
+
+  BatchedJob &BatchedJob::resumeFrom(std::int64_t lastKey)
+  {
+    resume_ = lastKey;
+    return *this;
+  }
+
+  BatchedJob &BatchedJob::onCheckpoint(CheckpointFn fn)
+  {
+    checkpoint_ = std::move(fn);
+    return *this;
+  }
+
+  std::optional<std::int64_t> BatchedJob::nextUpperKey(std::optional<std::int64_t> lower)
+  {
+    const std::string &key = options_.keyColumn;
+    const std::string from = " FROM " + options_.table +
+                             (lower ? " WHERE " + key + " > ?" : std::string());
+
+    vix::db::PooledConn conn(pool_);
+
+    {
+      auto st = conn.get().prepare("SELECT " + key + from + " ORDER BY " + key +
+                                   " LIMIT 1 OFFSET " + std::to_string(options_.chunkSize - 1));
+      if (lower)
+      {
+        st->bind(1, *lower);
+      }
+
+      auto rs = st->query();
+      if (rs && rs->next())
+      {
+        return rs->row().getInt64(0);
+      }
+    }
+
+    // Fewer than chunkSize keys remain: the last chunk ends at the max key.
+    auto st = conn.get().prepare("SELECT MAX(" + key + ")" + from);
+    if (lower)
+    {
+      st->bind(1, *lower);
+    }
+
+    auto rs = st->query();
+    if (!rs || !rs->next() || rs->row().isNull(0))
+    {
+      return std::nullopt;
+    }
+
+    return rs->row().getInt64(0);
+  }
+
+  std::chrono::nanoseconds BatchedJob::pauseAfter(std::chrono::nanoseconds work) const
+  {
+    const auto idle = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::duration<double, std::nano>(
+            static_cast<double>(work.count()) * (1.0 - options_.dutyCycle) / options_.dutyCycle));
+
+    return std::max<std::chrono::nanoseconds>(idle, options_.pause);
+  }
+
+  BatchedJobProgress BatchedJob::run(const CancellationToken &token)
+  {
+    using clock = std::chrono::steady_clock;
+
+    BatchedJobProgress progress;
+    std::optional<std::int64_t> lower = resume_;
+    if (lower)
+    {
+      progress.lastKey = *lower;
+      progress.started = true;
+    }
+
+    while (!token.cancelled())
+    {
+      const auto started = clock::now();
+
+      const auto upper = nextUpperKey(lower);
+      if (!upper)
+      {
+        progress.finished = true;
+        break;
+      }
+
+      // The range is inclusive so the first chunk also covers INT64_MIN;
+      // *lower < *upper, so *lower + 1 cannot overflow.
+      const std::int64_t from = lower ? *lower + 1 : std::numeric_limits<std::int64_t>::min();
+
+      vix::db::Transaction tx(pool_);
+      const std::uint64_t affected = work_(tx.conn(), from, *upper);
+      tx.commit();
+
+      lower = *upper;
+      resume_ = *upper;
+
+      progress.lastKey = *upper;
+      progress.started = true;
+      progress.chunks += 1;
+      progress.rows += affected;
+
+      if (checkpoint_)
+      {
+        checkpoint_(progress);
+      }
+
+      auto remaining = pauseAfter(clock::now() - started);
+      while (remaining.count() > 0 && !token.cancelled())
+      {
+        const auto step = std::min<std::chrono::nanoseconds>(remaining, std::chrono::milliseconds(50));
+        std::this_thread::sleep_for(step);
+        remaining -= step;
+      }
+    }
+
+    return progress;
+  }
+
+} // namespace vix::orm
@@ -0,0 +1,659 @@
+/**
+ *
+ *  @file BulkLoadSession.cpp
+ *  @author Gaspard Kirira
+ *
+ *  Copyright 2025, Gaspard Kirira.
+ *  All rights reserved.
+ *  https://github.com/vixcpp/vix
+ *
+ *  Use of this source code is governed by a MIT license
+ *  that can be found in the License file.
+ *
+ *  Vix.cpp
+ */
+#include <vix/orm/BulkLoadSession.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include <map>
+#include <set>
+#include <utility>
+
+namespace vix::orm
+{
+  namespace
+  {
+    void exec(vix::db::Connection &conn, const std::string &sql)
+    {
+      auto st = conn.prepare(sql);
+      st->exec();
+    }
+
+    std::int64_t query_int(vix::db::Connection &conn, const std::string &sql)
+    {
+      auto st = conn.prepare(sql);
+      auto rs = st->query();
+      if (!rs || !rs->next())
+      {
+        throw vix::db::DBError("BulkLoadSession: no result for " + sql);
+      }
+      return rs->row().getInt64Or(0, 0);
+    }
+
+    std::string quote_ident(std::string_view name, char quote)
+    {
+      std::string out(1, quote);
+      for (char c : name)
+      {
+        if (c == quote)
+        {
+          out += quote;
+        }
+        out += c;
+      }
+      out += quote;
+      return out;
+    }
+
+    std::string upper(std::string_view s)
+    {
+      std::string out(s);
+      for (char &c : out)
+      {
+        c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+      }
+      return out;
+    }
+
+    /**
+     * @brief Validate a synchronous level (OFF, NORMAL, FULL, EXTRA or 0-3).
+     */
+    bool valid_synchronous(std::string_view level)
+    {
+      const std::string u = upper(level);
+      return u == "OFF" || u == "NORMAL" || u == "FULL" || u == "EXTRA" ||
+             (u.size() == 1 && u[0] >= '0' && u[0] <= '3');
+    }
+
+    /**
+     * @brief Foreign key of a MySQL table, columns in ordinal order.
+     */
+    struct ForeignKey
+    {
+      std::string name;
+      std::string parent;
+      std::vector<std::string> columns;
+      std::vector<std::string> parentColumns;
+    };
+
+    std::vector<ForeignKey> mysql_foreign_keys(vix::db::Connection &conn, const std::string &table)
+    {
+      auto st = conn.prepare(
+          "SELECT CONSTRAINT_NAME, COLUMN_NAME, REFERENCED_TABLE_NAME, REFERENCED_COLUMN_NAME"
+          " FROM information_schema.KEY_COLUMN_USAGE"
+          " WHERE TABLE_SCHEMA = DATABASE() AND TABLE_NAME = ?"
+          " AND REFERENCED_TABLE_NAME IS NOT NULL"
+          " ORDER BY CONSTRAINT_NAME, ORDINAL_POSITION");
+      st->bind(1, table);
+      auto rs = st->query();
+
+      std::vector<ForeignKey> keys;
+      while (rs && rs->next())
+      {
+        const auto &row = rs->row();
+        std::string name = row.getString(0);
+        if (keys.empty() || keys.back().name != name)
+        {
+          keys.push_back(ForeignKey{std::move(name), row.getString(2), {}, {}});
+        }
+        keys.back().columns.push_back(row.getString(1));
+        keys.back().parentColumns.push_back(row.getString(3));
+      }
+      return keys;
+    }
+
+    bool mysql_index_exists(vix::db::Connection &conn, const std::string &table, const std::string &name)
+    {
+      auto st = conn.prepare(
+          "SELECT 1 FROM information_schema.STATISTICS"
+          " WHERE TABLE_SCHEMA = DATABASE() AND TABLE_NAME = ? AND INDEX_NAME = ? LIMIT 1");
+      st->bind(1, table);
+      st->bind(2, name);
+      auto rs = st->query();
+      return rs && rs->next();
+    }
+
+    void ensure_journal(vix::db::Connection &conn, const std::string &journal)
+    {
+      exec(conn, "CREATE TABLE IF NOT EXISTS " + journal +
+                     " (tbl VARCHAR(64) NOT NULL, name VARCHAR(64) NOT NULL,"
+                     " definition TEXT NOT NULL, PRIMARY KEY (tbl, name))");
+    }
+
+    /**
+     * @brief Journaled indexes of @p table, or of every table when empty.
+     */
+    std::vector<BulkLoadIndex> journaled_indexes(vix::db::Connection &conn,
+                                                 const std::string &journal,
+                                                 const std::string &table)
+    {
+      std::string sql = "SELECT tbl, name, definition FROM " + journal;
+      if (!table.empty())
+      {
+        sql += " WHERE tbl = ?";
+      }
+      sql += " ORDER BY tbl, name";
+
+      auto st = conn.prepare(sql);
+      if (!table.empty())
+      {
+        st->bind(1, table);
+      }
+      auto rs = st->query();
+
+      std::vector<BulkLoadIndex> indexes;
+      while (rs && rs->next())
+      {
+        const auto &row = rs->row();
+        indexes.push_back(BulkLoadIndex{row.getString(0), row.getString(1), row.getString(2), false});
+      }
+      return indexes;
+    }
+
+    void clear_journal(vix::db::Connection &conn, const std::string &journal, const std::string &table)
+    {
+      auto st = conn.prepare("DELETE FROM " + journal + " WHERE tbl = ?");
+      st->bind(1, table);
+      st->exec();
+    }
+  } // namespace
+
+  BulkLoadSession::BulkLoadSession(vix::db::ConnectionPool &pool, BulkLoadOptions options)
+      : conn_(pool), options_(std::move(options))
+  {
+    for (const auto &table : options_.tables)
+    {
+      detail::require_identifier(table, "BulkLoadSession");
+    }
+
+    if (!options_.mysqlIndexJournal.empty())
+    {
+      detail::require_identifier(options_.mysqlIndexJournal, "BulkLoadSession");
+    }
+
+    if (!options_.sqliteSynchronous.empty() && !valid_synchronous(options_.sqliteSynchronous))
+    {
+      throw vix::db::DBError("BulkLoadSession: invalid synchronous level '" +
+                             options_.sqliteSynchronous + "'");
+    }
+
+    if (options_.sqliteCacheSizeKiB < 0)
+    {
+      throw vix::db::DBError("BulkLoadSession: cache size must not be negative");
+    }
+
+    dialect_ = detect_dialect(conn());
+
+    try
+    {
+      relaxSettings();
+
+      // MySQL DDL commits implicitly: drop before the transaction starts.
+      if (dialect_.kind == Dialect::MySQL && options_.dropIndexes)
+      {
+        dropIndexes();
+      }
+
+      conn().begin();
+      inTransaction_ = true;
+
+      if (dialect_.kind == Dialect::SQLite)
+      {
+        if (options_.deferForeignKeys)
+        {
+          // Reset by SQLite itself when the transaction ends.
+          exec(conn(), "PRAGMA defer_foreign_keys = ON");
+        }
+        if (options_.dropIndexes)
+        {
+          dropIndexes();
+        }
+      }
+
+      active_ = true;
+    }
+    catch (...)
+    {
+      undo();
+      throw;
+    }
+  }
+
+  BulkLoadSession::~BulkLoadSession()
+  {
+    rollback();
+  }
+
+  void BulkLoadSession::commit()
+  {
+    if (!active_)
+    {
+      throw vix::db::DBError("BulkLoadSession: session is no longer active");
+    }
+
+    active_ = false;
+
+    try
+    {
+      if (dialect_.kind == Dialect::SQLite)
+      {
+        rebuildIndexes();
+      }
+
+      if (options_.verifyIntegrity)
+      {
+        verify();
+      }
+
+      conn().commit();
+      inTransaction_ = false;
+
+      if (dialect_.kind == Dialect::MySQL)
+      {
+        rebuildIndexes();
+      }
+    }
+    catch (...)
+    {
+      undo();
+      throw;
+    }
+
+    restoreSettings();
+  }
+
+  void BulkLoadSession::rollback() noexcept
+  {
+    if (!active_)
+    {
+      return;
+    }
+
+    active_ = false;
+    undo();
+  }
+
+  void BulkLoadSession::undo() noexcept
+  {
+    if (inTransaction_)
+    {
+      inTransaction_ = false;
+      try
+      {
+        // Also restores indexes dropped inside the transaction (SQLite).
+        conn().rollback();
+      }
+      catch (...)
+      {
+      }
+    }
+
+    if (!missing_.empty())
+    {
+      try
+      {
+        rebuildIndexes();
+      }
+      catch (...)
+      {
+      }
+    }
+
+    restoreSettings();
+  }
+
+  std::size_t BulkLoadSession::recoverIndexes(vix::db::ConnectionPool &pool, const std::string &journal)
+  {
+    detail::require_identifier(journal, "BulkLoadSession");
+
+    vix::db::PooledConn conn(pool);
+    if (detect_dialect(conn.get()).kind != Dialect::MySQL)
+    {
+      return 0;
+    }
+
+    {
+      auto st = conn.get().prepare(
+          "SELECT 1 FROM information_schema.TABLES"
+          " WHERE TABLE_SCHEMA = DATABASE() AND TABLE_NAME = ? LIMIT 1");
+      st->bind(1, journal);
+      auto rs = st->query();
+      if (!rs || !rs->next())
+      {
+        return 0;
+      }
+    }
+
+    // Rows are ordered by table: one ALTER TABLE per table.
+    const auto indexes = journaled_indexes(conn.get(), journal, std::string());
+    std::size_t recreated = 0;
+    for (std::size_t begin = 0; begin < indexes.size();)
+    {
+      const std::string &table = indexes[begin].table;
+      detail::require_identifier(table, "BulkLoadSession");
+
+      std::string sql;
+      std::size_t end = begin;
+      for (; end < indexes.size() && indexes[end].table == table; ++end)
+      {
+        if (!mysql_index_exists(conn.get(), table, indexes[end].name))
+        {
+          sql += (sql.empty() ? "ALTER TABLE " + table + " " : ", ") + indexes[end].sql;
+          ++recreated;
+        }
+      }
+
+      if (!sql.empty())
+      {
+        exec(conn.get(), sql);
+      }
+      clear_journal(conn.get(), journal, table);
+      begin = end;
+    }
+
+    return recreated;
+  }
+
+  void BulkLoadSession::relaxSettings()
+  {
+    if (dialect_.kind == Dialect::SQLite)
+    {
+      // Both pragmas are set outside the transaction.
+      if (options_.sqliteCacheSizeKiB > 0)
+      {
+        savedCacheSize_ = query_int(conn(), "PRAGMA cache_size");
+        exec(conn(), "PRAGMA cache_size = -" + std::to_string(options_.sqliteCacheSizeKiB));
+      }
+      if (!options_.sqliteSynchronous.empty())
+      {
+        savedSynchronous_ = query_int(conn(), "PRAGMA synchronous");
+        exec(conn(), "PRAGMA synchronous = " + upper(options_.sqliteSynchronous));
+      }
+    }
+    else if (dialect_.kind == Dialect::MySQL && options_.deferForeignKeys)
+    {
+      savedForeignKeyChecks_ = query_int(conn(), "SELECT @@SESSION.foreign_key_checks");
+      exec(conn(), "SET SESSION foreign_key_checks = 0");
+    }
+  }
+
+  void BulkLoadSession::restoreSettings() noexcept
+  {
+    const auto restore = [this](std::optional<std::int64_t> &saved, const std::string &prefix)
+    {
+      if (!saved)
+      {
+        return;
+      }
+      try
+      {
+        exec(conn(), prefix + std::to_string(*saved));
+      }
+      catch (...)
+      {
+      }
+      saved.reset();
+    };
+
+    restore(savedCacheSize_, "PRAGMA cache_size = ");
+    restore(savedSynchronous_, "PRAGMA synchronous = ");
+    restore(savedForeignKeyChecks_, "SET SESSION foreign_key_checks = ");
+  }
+
+  void BulkLoadSession::dropIndexes()
+  {
+    for (const auto &table : options_.tables)
+    {
+      std::vector<BulkLoadIndex> indexes;
+
+      if (dialect_.kind == Dialect::SQLite)
+      {
+        // Automatic indexes (PRIMARY KEY, UNIQUE constraints) have no SQL.
+        auto st = conn().prepare(
+            "SELECT name, sql FROM sqlite_master"
+            " WHERE type = 'index' AND tbl_name = ? AND sql IS NOT NULL");
+        st->bind(1, table);
+        auto rs = st->query();
+        while (rs && rs->next())
+        {
+          const auto &row = rs->row();
+          BulkLoadIndex index{table, row.getString(0), row.getString(1), false};
+          index.unique = upper(index.sql.substr(0, 13)) == "CREATE UNIQUE";
+          if (!index.unique || options_.dropUniqueIndexes)
+          {
+            indexes.push_back(std::move(index));
+          }
+        }
+
+        for (const auto &index : indexes)
+        {
+          exec(conn(), "DROP INDEX " + quote_ident(index.name, '"'));
+          dropped_.push_back(index);
+        }
+        continue;
+      }
+
+      // MySQL: indexes a dead session left dropped are rebuilt with ours.
+      const std::string &journal = options_.mysqlIndexJournal;
+      std::vector<BulkLoadIndex> pending;
+      if (!journal.empty())
+      {
+        ensure_journal(conn(), journal);
+        for (auto &index : journaled_indexes(conn(), journal, table))
+        {
+          if (!mysql_index_exists(conn(), table, index.name))
+          {
+            pending.push_back(std::move(index));
+          }
+        }
+      }
+
+      // Rebuild index definitions from the catalog.
+      std::set<std::string> foreignKeyColumns;
+      for (const auto &fk : mysql_foreign_keys(conn(), table))
+      {
+        foreignKeyColumns.insert(fk.columns.begin(), fk.columns.end());
+      }
+
+      auto st = conn().prepare(
+          "SELECT INDEX_NAME, NON_UNIQUE, COLUMN_NAME, SUB_PART, INDEX_TYPE, COLLATION"
+          " FROM information_schema.STATISTICS"
+          " WHERE TABLE_SCHEMA = DATABASE() AND TABLE_NAME = ?"
+          " ORDER BY INDEX_NAME, SEQ_IN_INDEX");
+      st->bind(1, table);
+      auto rs = st->query();
+
+      std::set<std::string> excluded;
+      std::map<std::string, std::string> columns;
+      std::map<std::string, std::string> types;
+      while (rs && rs->next())
+      {
+        const auto &row = rs->row();
+        const std::string name = row.getString(0);
+
+        // Keep the primary key, unique indexes, functional indexes and
+        // indexes MySQL may need for a foreign key.
+        if (name == "PRIMARY" || row.getInt64Or(1, 1) == 0 || row.isNull(2) ||
+            foreignKeyColumns.count(row.getString(2)) != 0)
+        {
+          excluded.insert(name);
+          continue;
+        }
+
+        std::string &list = columns[name];
+        if (!list.empty())
+        {
+          list += ", ";
+        }
+        list += quote_ident(row.getString(2), '`');
+        if (!row.isNull(3))
+        {
+          list += "(" + std::to_string(row.getInt64(3)) + ")";
+        }
+        if (row.getStringOr(5, "A") == "D")
+        {
+          list += " DESC";
+        }
+        types[name] = row.getStringOr(4, "BTREE");
+      }
+
+      for (const auto &[name, list] : columns)
+      {
+        if (excluded.count(name) != 0)
+        {
+          continue;
+        }
+
+        const std::string &type = types[name];
+        const std::string kind = type == "FULLTEXT" ? "FULLTEXT INDEX "
+                                 : type == "SPATIAL" ? "SPATIAL INDEX "
+                                                     : "INDEX ";
+        indexes.push_back(
+            BulkLoadIndex{table, name, "ADD " + kind + quote_ident(name, '`') + " (" + list + ")", false});
+      }
+
+      missing_.insert(missing_.end(), pending.begin(), pending.end());
+      if (indexes.empty())
+      {
+        continue;
+      }
+
+      // Journal first: the DROP commits and must stay recoverable.
+      if (!journal.empty())
+      {
+        for (const auto &index : indexes)
+        {
+          auto ins = conn().prepare("REPLACE INTO " + journal + " (tbl, name, definition) VALUES (?, ?, ?)");
+          ins->bind(1, index.table);
+          ins->bind(2, index.name);
+          ins->bind(3, index.sql);
+          ins->exec();
+        }
+      }
+
+      std::string sql = "ALTER TABLE " + table;
+      for (std::size_t i = 0; i < indexes.size(); ++i)
+      {
+        sql += (i == 0 ? " DROP INDEX " : ", DROP INDEX ") + quote_ident(indexes[i].name, '`');
+      }
+      exec(conn(), sql);
+
+      dropped_.insert(dropped_.end(), indexes.begin(), indexes.end());
+      missing_.insert(missing_.end(), indexes.begin(), indexes.end());
+    }
+  }
+
+  void BulkLoadSession::rebuildIndexes()
+  {
+    if (dialect_.kind == Dialect::SQLite)
+    {
+      for (const auto &index : dropped_)
+      {
+        exec(conn(), index.sql);
+      }
+      return;
+    }
+
+    // One ALTER TABLE per table builds all of its indexes in one pass.
+    while (!missing_.empty())
+    {
+      const std::string table = missing_.front().table;
+
+      std::string sql = "ALTER TABLE " + table;
+      bool first = true;
+      for (const auto &index : missing_)
+      {
+        if (index.table == table)
+        {
+          sql += (first ? " " : ", ") + index.sql;
+          first = false;
+        }
+      }
+      exec(conn(), sql);
+
+      if (!options_.mysqlIndexJournal.empty())
+      {
+        clear_journal(conn(), options_.mysqlIndexJournal, table);
+      }
+
+      missing_.erase(std::remove_if(missing_.begin(), missing_.end(),
+                                    [&](const BulkLoadIndex &index)
+                                    { return index.table == table; }),
+                     missing_.end());
+    }
+  }
+
+  void BulkLoadSession::verify()
+  {
+    for (const auto &table : options_.tables)
+    {
+      if (dialect_.kind == Dialect::SQLite)
+      {
+        {
+          auto st = conn().prepare("PRAGMA foreign_key_check(" + table + ")");
+          auto rs = st->query();
+          if (rs && rs->next())
+          {
+            throw vix::db::DBError("BulkLoadSession: foreign key violation in " + table +
+                                   " referencing " + rs->row().getStringOr(2, "?"));
+          }
+        }
+
+        // The table argument needs SQLite 3.33; older versions would
+        // check the whole database.
+        if (dialect_.atLeast(3, 33))
+        {
+          auto st = conn().prepare("PRAGMA integrity_check(" + table + ")");
+          auto rs = st->query();
+          if (rs && rs->next())
+          {
+            const std::string status = rs->row().getStringOr(0, "ok");
+            if (status != "ok")
+            {
+              throw vix::db::DBError("BulkLoadSession: integrity check failed on " + table +
+                                     ": " + status);
+            }
+          }
+        }
+      }
+      else if (dialect_.kind == Dialect::MySQL && options_.deferForeignKeys)
+      {
+        // Rows written with foreign_key_checks = 0 are never re-checked.
+        for (const auto &fk : mysql_foreign_keys(conn(), table))
+        {
+          std::string sql = "SELECT 1 FROM " + table + " c WHERE ";
+          std::string match;
+          for (std::size_t i = 0; i < fk.columns.size(); ++i)
+          {
+            const std::string child = "c." + quote_ident(fk.columns[i], '`');
+            sql += (i == 0 ? "" : " AND ") + child + " IS NOT NULL";
+            match += (i == 0 ? "" : " AND ") + std::string("p.") +
+                     quote_ident(fk.parentColumns[i], '`') + " = " + child;
+          }
+          sql += " AND NOT EXISTS (SELECT 1 FROM " + quote_ident(fk.parent, '`') +
+                 " p WHERE " + match + ") LIMIT 1";
+
+          auto st = conn().prepare(sql);
+          auto rs = st->query();
+          if (rs && rs->next())
+          {
+            throw vix::db::DBError("BulkLoadSession: foreign key " + fk.name + " violated in " +
+                                   table + " (missing row in " + fk.parent + ")");
+          }
+        }
+      }
+    }
+  }
+
+} // namespace vix::orm
@@ -0,0 +1,93 @@
+/**
+ *
+ *  @file Dialect.cpp
+ *  @author Gaspard Kirira
+ *
+ *  Copyright 2025, Gaspard Kirira.
+ *  All rights reserved.
+ *  https://github.com/vixcpp/vix
+ *
+ *  Use of this source code is governed by a MIT license
+ *  that can be found in the License file.
+ *
+ *  Vix.cpp
+ */
+#include <vix/orm/Dialect.hpp>
+
+#include <exception>
+#include <string>
+
+namespace vix::orm
+{
+  void parse_server_version(std::string_view version, DialectInfo &info) noexcept
+  {
+    int parts[3] = {0, 0, 0};
+    std::size_t part = 0;
+
+    for (char c : version)
+    {
+      if (c >= '0' && c <= '9')
+      {
+        parts[part] = parts[part] * 10 + (c - '0');
+      }
+      else if (c == '.' && part < 2)
+      {
+        ++part;
+      }
+      else
+      {
+        break;
+      }
+    }
+
+    info.major = parts[0];
+    info.minor = parts[1];
+    info.patch = parts[2];
+    info.mariadb = version.find("MariaDB") != std::string_view::npos;
+  }
+
+  namespace
+  {
+    bool probe(vix::db::Connection &conn,
+               std::string_view sql,
+               Dialect kind,
+               DialectInfo &info)
+    {
+      try
+      {
+        auto st = conn.prepare(sql);
+        auto rs = st->query();
+        if (!rs || !rs->next())
+        {
+          return false;
+        }
+
+        info.kind = kind;
+        parse_server_version(rs->row().getString(0), info);
+        return true;
+      }
+      catch (const std::exception &)
+      {
+        return false;
+      }
+    }
+  } // namespace
+
+  DialectInfo detect_dialect(vix::db::Connection &conn)
+  {
+    DialectInfo info;
+
+    if (probe(conn, "SELECT sqlite_version()", Dialect::SQLite, info))
+    {
+      return info;
+    }
+
+    if (probe(conn, "SELECT VERSION()", Dialect::MySQL, info))
+    {
+      return info;
+    }
+
+    return DialectInfo{};
+  }
+
+} // namespace vix::orm
@@ -0,0 +1,570 @@
+/**
+ *
+ *  @file Export.cpp
+ *  @author Gaspard Kirira
+ *
+ *  Copyright 2025, Gaspard Kirira.
+ *  All rights reserved.
+ *  https://github.com/vixcpp/vix
+ *
+ *  Use of this source code is governed by a MIT license
+ *  that can be found in the License file.
+ *
+ *  Vix.cpp
+ */
+#include <vix/orm/Export.hpp>
+#include <vix/orm/JsonWriter.hpp>
+#include <vix/orm/RowView.hpp>
+
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <cmath>
+#include <exception>
+#include <fstream>
+#include <memory>
+#include <ostream>
+#include <thread>
+#include <utility>
+
+#if defined(_WIN32)
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace vix::orm
+{
+  namespace
+  {
+    /**
+     * @brief Encodes rows into a bounded buffer flushed to a sink.
+     */
+    class RowEncoder
+    {
+      const ExportSink &sink_;
+      const ExportOptions &options_;
+      std::string buffer_;
+      std::vector<std::string> scratch_;
+
+      template <class N>
+      void number(N v)
+      {
+        char tmp[32];
+        const auto res = std::to_chars(tmp, tmp + sizeof(tmp), v);
+        buffer_.append(tmp, static_cast<std::size_t>(res.ptr - tmp));
+      }
+
+      /**
+       * @brief Append a CSV field in one pass, quoting it afterwards if needed.
+       */
+      void csvField(std::string_view s)
+      {
+        const char d = options_.csvDelimiter;
+        const std::size_t start = buffer_.size();
+        bool quote = false;
+
+        std::size_t clean = 0;
+        for (std::size_t i = 0; i < s.size(); ++i)
+        {
+          const char c = s[i];
+          if (c == '"')
+          {
+            buffer_.append(s.data() + clean, i + 1 - clean);
+            buffer_ += '"';
+            clean = i + 1;
+            quote = true;
+          }
+          else if (c == d || c == '\n' || c == '\r')
+          {
+            quote = true;
+          }
+        }
+        buffer_.append(s.data() + clean, s.size() - clean);
+
+        if (quote)
+        {
+          buffer_.insert(start, 1, '"');
+          buffer_ += '"';
+        }
+      }
+
+      void jsonValue(const RowView &row, std::size_t index, ExportType type)
+      {
+        if (row.isNull(index))
+        {
+          buffer_ += "null";
+          return;
+        }
+
+        switch (type)
+        {
+        case ExportType::Integer:
+          number(row.getInt64(index));
+          return;
+        case ExportType::Real:
+        {
+          const double v = row.getDouble(index);
+          if (std::isfinite(v))
+            number(v);
+          else
+            buffer_ += "null";
+          return;
+        }
+        case ExportType::Boolean:
+          buffer_ += row.getInt64(index) != 0 ? "true" : "false";
+          return;
+        case ExportType::Text:
+          break;
+        }
+
+        buffer_ += '"';
+        detail::append_json_escaped(buffer_, row.getText(index));
+        buffer_ += '"';
+      }
+
+      void csvValue(const RowView &row, std::size_t index, ExportType type)
+      {
+        if (row.isNull(index))
+        {
+          return;
+        }
+
+        switch (type)
+        {
+        case ExportType::Integer:
+          number(row.getInt64(index));
+          return;
+        case ExportType::Real:
+          number(row.getDouble(index));
+          return;
+        case ExportType::Boolean:
+          buffer_ += row.getInt64(index) != 0 ? "true" : "false";
+          return;
+        case ExportType::Text:
+          csvField(row.getText(index));
+          return;
+        }
+      }
+
+    public:
+      RowEncoder(const ExportSink &sink, const ExportOptions &options)
+          : sink_(sink), options_(options)
+      {
+        buffer_.reserve(options_.bufferSize + options_.bufferSize / 8);
+      }
+
+      void header()
+      {
+        if (options_.format != ExportFormat::CSV)
+        {
+          return;
+        }
+
+        for (std::size_t i = 0; i < options_.columns.size(); ++i)
+        {
+          if (i != 0)
+          {
+            buffer_ += options_.csvDelimiter;
+          }
+          csvField(options_.columns[i].name);
+        }
+        buffer_ += '\n';
+      }
+
+      /**
+       * @brief Encode one row whose exported columns start at @p first.
+       */
+      void row(const vix::db::ResultRow &raw, std::size_t first)
+      {
+        const RowView row(raw, scratch_);
+        const auto &columns = options_.columns;
+
+        if (options_.format == ExportFormat::NDJSON)
+        {
+          buffer_ += '{';
+          for (std::size_t i = 0; i < columns.size(); ++i)
+          {
+            if (i != 0)
+            {
+              buffer_ += ',';
+            }
+            buffer_ += '"';
+            detail::append_json_escaped(buffer_, columns[i].name);
+            buffer_ += "\":";
+            jsonValue(row, first + i, columns[i].type);
+          }
+          buffer_ += "}\n";
+        }
+        else
+        {
+          for (std::size_t i = 0; i < columns.size(); ++i)
+          {
+            if (i != 0)
+            {
+              buffer_ += options_.csvDelimiter;
+            }
+            csvValue(row, first + i, columns[i].type);
+          }
+          buffer_ += '\n';
+        }
+
+        if (buffer_.size() >= options_.bufferSize)
+        {
+          flush();
+        }
+      }
+
+      void flush()
+      {
+        if (!buffer_.empty())
+        {
+          sink_(buffer_);
+          buffer_.clear();
+        }
+      }
+    };
+
+    void validate(const ExportOptions &options, bool keyset)
+    {
+      if (options.columns.empty())
+      {
+        throw vix::db::DBError("exportTable: no columns to export");
+      }
+
+      for (const auto &c : options.columns)
+      {
+        detail::require_identifier(c.name, "export");
+      }
+
+      if (keyset)
+      {
+        detail::require_identifier(options.keyColumn, "export");
+        if (options.chunkRows == 0)
+        {
+          throw vix::db::DBError("exportTable: chunk size must be positive");
+        }
+      }
+    }
+
+    std::string select_list(const ExportOptions &options)
+    {
+      std::string out = options.keyColumn;
+      for (const auto &c : options.columns)
+      {
+        out += ", ";
+        out += c.name;
+      }
+      return out;
+    }
+
+    /**
+     * @brief Keyset export of (after, until] with an optional header.
+     */
+    ExportProgress export_range(vix::db::ConnectionPool &pool,
+                                std::string_view table,
+                                const ExportSink &sink,
+                                const ExportOptions &options,
+                                std::optional<std::int64_t> after,
+                                std::optional<std::int64_t> until,
+                                bool header,
+                                bool notify)
+    {
+      const std::string &key = options.keyColumn;
+
+      std::string base = "SELECT " + select_list(options) + " FROM " + std::string(table) + " WHERE 1=1";
+      if (options.filter && !options.filter->sql().empty())
+      {
+        base.append(" AND (").append(options.filter->sql()).append(")");
+      }
+      if (until)
+      {
+        base += " AND " + key + " <= ?";
+      }
+
+      const std::string tail = " ORDER BY " + key + " LIMIT " + std::to_string(options.chunkRows);
+      const std::string first = base + tail;
+      const std::string next = base + " AND " + key + " > ?" + tail;
+
+      RowEncoder encoder(sink, options);
+      if (header)
+      {
+        encoder.header();
+      }
+
+      ExportProgress progress;
+      progress.lastKey = after;
+
+      for (;;)
+      {
+        std::size_t fetched = 0;
+        {
+          vix::db::PooledConn conn(pool);
+          auto st = conn.get().prepare(progress.lastKey ? next : first);
+
+          std::size_t index = 1;
+          if (options.filter)
+          {
+            options.filter->bind(*st, index);
+            index += options.filter->paramCount();
+          }
+          if (until)
+          {
+            st->bind(index++, *until);
+          }
+          if (progress.lastKey)
+          {
+            st->bind(index++, *progress.lastKey);
+          }
+
+          auto rs = st->query();
+          while (rs && rs->next())
+          {
+            const auto &row = rs->row();
+            progress.lastKey = row.getInt64(0);
+            encoder.row(row, 1);
+            ++fetched;
+          }
+        }
+
+        progress.rows += fetched;
+        encoder.flush();
+
+        if (notify && options.onChunk && fetched != 0)
+        {
+          options.onChunk(progress);
+        }
+
+        if (fetched < options.chunkRows)
+        {
+          break;
+        }
+      }
+
+      return progress;
+    }
+
+    std::optional<std::pair<std::int64_t, std::int64_t>>
+    key_bounds(vix::db::ConnectionPool &pool, std::string_view table, const ExportOptions &options)
+    {
+      const std::string &key = options.keyColumn;
+      std::string sql = "SELECT MIN(" + key + "), MAX(" + key + ") FROM " + std::string(table) + " WHERE 1=1";
+      if (options.resumeAfter)
+      {
+        sql += " AND " + key + " > ?";
+      }
+      if (options.until)
+      {
+        sql += " AND " + key + " <= ?";
+      }
+
+      vix::db::PooledConn conn(pool);
+      auto st = conn.get().prepare(sql);
+
+      std::size_t index = 1;
+      if (options.resumeAfter)
+      {
+        st->bind(index++, *options.resumeAfter);
+      }
+      if (options.until)
+      {
+        st->bind(index++, *options.until);
+      }
+
+      auto rs = st->query();
+      if (!rs || !rs->next() || rs->row().isNull(0))
+      {
+        return std::nullopt;
+      }
+
+      return std::make_pair(rs->row().getInt64(0), rs->row().getInt64(1));
+    }
+  } // namespace
+
+  ExportSink fd_sink(int fd)
+  {
+    return [fd](std::string_view chunk)
+    {
+      while (!chunk.empty())
+      {
+#if defined(_WIN32)
+        const auto n = ::_write(fd, chunk.data(), static_cast<unsigned>(chunk.size()));
+#else
+        const auto n = ::write(fd, chunk.data(), chunk.size());
+#endif
+        if (n < 0)
+        {
+          if (errno == EINTR)
+          {
+            continue;
+          }
+          throw vix::db::DBError("export: write to file descriptor failed");
+        }
+        chunk.remove_prefix(static_cast<std::size_t>(n));
+      }
+    };
+  }
+
+  ExportSink stream_sink(std::ostream &out)
+  {
+    return [&out](std::string_view chunk)
+    {
+      out.write(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+      if (!out)
+      {
+        throw vix::db::DBError("export: stream write failed");
+      }
+    };
+  }
+
+  ExportSink file_sink(const std::string &path)
+  {
+    auto file = std::make_shared<std::ofstream>(path, std::ios::binary | std::ios::trunc);
+    if (!*file)
+    {
+      throw vix::db::DBError("export: cannot open '" + path + "'");
+    }
+
+    return [file, path](std::string_view chunk)
+    {
+      file->write(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+      file->flush();
+      if (!*file)
+      {
+        throw vix::db::DBError("export: write to '" + path + "' failed");
+      }
+    };
+  }
+
+  ExportProgress exportTable(vix::db::ConnectionPool &pool,
+                             std::string_view table,
+                             const ExportSink &sink,
+                             const ExportOptions &options)
+  {
+    validate(options, true);
+    detail::require_identifier(table, "exportTable");
+
+    const bool header = options.csvHeader && !options.resumeAfter;
+    return export_range(pool, table, sink, options,
+                        options.resumeAfter, options.until, header, true);
+  }
+
+  ExportProgress exportQuery(vix::db::ConnectionPool &pool,
+                             const QueryBuilder &query,
+                             const ExportSink &sink,
+                             const ExportOptions &options)
+  {
+    validate(options, false);
+
+    RowEncoder encoder(sink, options);
+    if (options.csvHeader)
+    {
+      encoder.header();
+    }
+
+    ExportProgress progress;
+    {
+      vix::db::PooledConn conn(pool);
+      auto st = conn.get().prepare(query.sql());
+      query.bind(*st);
+
+      auto rs = st->query();
+      while (rs && rs->next())
+      {
+        encoder.row(rs->row(), 0);
+        ++progress.rows;
+      }
+    }
+
+    encoder.flush();
+    if (options.onChunk)
+    {
+      options.onChunk(progress);
+    }
+
+    return progress;
+  }
+
+  ExportProgress exportPartitioned(vix::db::ConnectionPool &pool,
+                                   std::string_view table,
+                                   std::size_t partitions,
+                                   const std::function<ExportSink(std::size_t)> &makeSink,
+                                   const ExportOptions &options)
+  {
+    validate(options, true);
+    detail::require_identifier(table, "exportPartitioned");
+
+    if (partitions == 0)
+    {
+      throw vix::db::DBError("exportPartitioned: partition count must be positive");
+    }
+
+    const auto bounds = key_bounds(pool, table, options);
+    if (!bounds)
+    {
+      return {};
+    }
+
+    // Slice [first, hi] by offsets from first in unsigned space. The
+    // span holds width + 1 keys, which does not fit in 64 bits when the
+    // keys cover the whole int64 range, so partitions are sized from
+    // width and the last one runs to width instead.
+    const std::int64_t hi = bounds->second;
+    const auto first = static_cast<std::uint64_t>(bounds->first);
+    const std::uint64_t width = static_cast<std::uint64_t>(hi) - first;
+    const std::uint64_t used = width < partitions ? width + 1 : partitions;
+    const std::uint64_t step = width < partitions ? 1 : width / partitions;
+
+    std::vector<ExportProgress> results(partitions);
+    std::vector<std::exception_ptr> errors(partitions);
+    std::vector<std::thread> threads;
+    threads.reserve(static_cast<std::size_t>(used));
+
+    for (std::size_t i = 0; i < used; ++i)
+    {
+      // Partition i holds offsets [offset, last]; the first one keeps
+      // the caller's lower bound instead of first - 1.
+      const std::uint64_t offset = step * i;
+      const std::uint64_t last = i + 1 == used ? width : offset + step - 1;
+      const std::optional<std::int64_t> after =
+          i == 0 ? options.resumeAfter : std::optional<std::int64_t>(static_cast<std::int64_t>(first + offset - 1));
+      const auto until = static_cast<std::int64_t>(first + last);
+
+      threads.emplace_back([&, i, after, until]
+                           {
+                             try
+                             {
+                               const ExportSink sink = makeSink(i);
+                               results[i] = export_range(pool, table, sink, options, after, until,
+                                                         options.csvHeader, false);
+                             }
+                             catch (...)
+                             {
+                               errors[i] = std::current_exception();
+                             } });
+    }
+
+    for (auto &t : threads)
+    {
+      t.join();
+    }
+
+    for (const auto &e : errors)
+    {
+      if (e)
+      {
+        std::rethrow_exception(e);
+      }
+    }
+
+    ExportProgress total;
+    for (const auto &r : results)
+    {
+      total.rows += r.rows;
+    }
+    total.lastKey = hi;
+
+    return total;
+  }
+
+} // namespace vix::orm
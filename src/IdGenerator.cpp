@@ -0,0 +1,201 @@
+/**
+ *
+ *  @file IdGenerator.cpp
+ *  @author Gaspard Kirira
+ *
+ *  Copyright 2025, Gaspard Kirira.
+ *  All rights reserved.
+ *  https://github.com/vixcpp/vix
+ *
+ *  Use of this source code is governed by a MIT license
+ *  that can be found in the License file.
+ *
+ *  Vix.cpp
+ */
+#include <vix/orm/IdGenerator.hpp>
+
+#include <chrono>
+#include <exception>
+#include <thread>
+#include <utility>
+
+namespace vix::orm
+{
+  namespace
+  {
+    std::int64_t now_ms()
+    {
+      using namespace std::chrono;
+      return duration_cast<milliseconds>(system_clock::now().time_since_epoch()).count();
+    }
+  } // namespace
+
+  SnowflakeIdGenerator::SnowflakeIdGenerator(std::uint32_t nodeId,
+                                             std::int64_t epochMs)
+      : nodeId_(nodeId), epochMs_(epochMs)
+  {
+    if (nodeId_ > max_node_id)
+    {
+      throw vix::db::DBError("SnowflakeIdGenerator: node id out of range");
+    }
+  }
+
+  std::int64_t SnowflakeIdGenerator::next()
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    std::int64_t ms = now_ms();
+    if (ms < lastMs_)
+    {
+      ms = lastMs_;
+    }
+
+    constexpr std::int64_t max_elapsed = (std::int64_t{1} << 41) - 1;
+    if (ms < epochMs_ || ms - epochMs_ > max_elapsed)
+    {
+      throw vix::db::DBError("SnowflakeIdGenerator: clock outside the epoch range");
+    }
+
+    if (ms == lastMs_)
+    {
+      sequence_ = (sequence_ + 1) & ((1u << sequence_bits) - 1);
+      if (sequence_ == 0)
+      {
+        while (ms <= lastMs_)
+        {
+          std::this_thread::yield();
+          ms = now_ms();
+        }
+      }
+    }
+    else
+    {
+      sequence_ = 0;
+    }
+
+    lastMs_ = ms;
+
+    return ((ms - epochMs_) << (node_bits + sequence_bits)) |
+           (static_cast<std::int64_t>(nodeId_) << sequence_bits) |
+           static_cast<std::int64_t>(sequence_);
+  }
+
+  HiLoIdGenerator::HiLoIdGenerator(vix::db::ConnectionPool &pool,
+                                   std::string sequence,
+                                   std::uint32_t blockSize,
+                                   std::string table)
+      : pool_(pool),
+        sequence_(std::move(sequence)),
+        blockSize_(blockSize),
+        table_(std::move(table))
+  {
+    if (sequence_.empty())
+    {
+      throw vix::db::DBError("HiLoIdGenerator: sequence name cannot be empty");
+    }
+
+    if (blockSize_ == 0)
+    {
+      throw vix::db::DBError("HiLoIdGenerator: block size must be positive");
+    }
+  }
+
+  std::int64_t HiLoIdGenerator::next()
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (!hasBlock_ || lo_ >= blockSize_)
+    {
+      hi_ = reserveBlock();
+      lo_ = 0;
+      hasBlock_ = true;
+    }
+
+    ++lo_;
+    return hi_ * static_cast<std::int64_t>(blockSize_) + static_cast<std::int64_t>(lo_);
+  }
+
+  void HiLoIdGenerator::ensureAbove(std::int64_t floor)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (floor <= floor_)
+    {
+      return;
+    }
+    floor_ = floor;
+
+    const std::int64_t nextId =
+        hi_ * static_cast<std::int64_t>(blockSize_) + static_cast<std::int64_t>(lo_) + 1;
+    if (hasBlock_ && nextId <= floor_)
+    {
+      hasBlock_ = false;
+    }
+  }
+
+  std::int64_t HiLoIdGenerator::reserveBlock()
+  {
+    if (!tableReady_)
+    {
+      vix::db::PooledConn conn(pool_);
+      conn.get()
+          .prepare("CREATE TABLE IF NOT EXISTS " + table_ +
+                   " (name VARCHAR(191) NOT NULL PRIMARY KEY, next_hi BIGINT NOT NULL)")
+          ->exec();
+      tableReady_ = true;
+    }
+
+    // Smallest hi whose block (hi * size + 1 ...) lies above the floor.
+    const auto size = static_cast<std::int64_t>(blockSize_);
+    const std::int64_t minHi = floor_ <= 0 ? 0 : floor_ / size + (floor_ % size != 0 ? 1 : 0);
+
+    for (int attempt = 0;; ++attempt)
+    {
+      try
+      {
+        vix::db::Transaction tx(pool_);
+        auto &conn = tx.conn();
+
+        auto up = conn.prepare("UPDATE " + table_ +
+                               " SET next_hi = CASE WHEN next_hi < ? THEN ? ELSE next_hi END + 1"
+                               " WHERE name = ?");
+        up->bind(1, minHi);
+        up->bind(2, minHi);
+        up->bind(3, sequence_);
+
+        std::int64_t hi = minHi;
+        if (up->exec() == 0)
+        {
+          auto ins = conn.prepare("INSERT INTO " + table_ + " (name, next_hi) VALUES (?, ?)");
+          ins->bind(1, sequence_);
+          ins->bind(2, minHi + 1);
+          ins->exec();
+        }
+        else
+        {
+          auto sel = conn.prepare("SELECT next_hi FROM " + table_ + " WHERE name = ?");
+          sel->bind(1, sequence_);
+
+          auto rs = sel->query();
+          if (!rs || !rs->next())
+          {
+            throw vix::db::DBError("HiLoIdGenerator: sequence row vanished");
+          }
+          hi = rs->row().getInt64(0) - 1;
+        }
+
+        tx.commit();
+        return hi;
+      }
+      catch (const std::exception &)
+      {
+        // A concurrent writer may have created the sequence row first.
+        if (attempt > 0)
+        {
+          throw;
+        }
+      }
+    }
+  }
+
+} // namespace vix::orm
@@ -0,0 +1,1327 @@
+/**
+ *
+ *  @file Import.cpp
+ *  @author Gaspard Kirira
+ *
+ *  Copyright 2025, Gaspard Kirira.
+ *  All rights reserved.
+ *  https://github.com/vixcpp/vix
+ *
+ *  Use of this source code is governed by a MIT license
+ *  that can be found in the License file.
+ *
+ *  Vix.cpp
+ */
+#include <vix/orm/Import.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <charconv>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace vix::orm
+{
+  namespace
+  {
+    // -------------------------------------------------------------------------
+    // Input
+    // -------------------------------------------------------------------------
+
+    /**
+     * @brief Read-only view of a whole file, memory-mapped when possible.
+     */
+    class MappedFile
+    {
+      std::string_view data_;
+      std::string fallback_;
+#if !defined(_WIN32)
+      void *map_ = nullptr;
+      std::size_t mapSize_ = 0;
+#endif
+
+    public:
+      explicit MappedFile(const std::string &path)
+      {
+#if !defined(_WIN32)
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd >= 0)
+        {
+          struct stat st{};
+          if (::fstat(fd, &st) == 0 && st.st_size > 0)
+          {
+            const auto size = static_cast<std::size_t>(st.st_size);
+            void *p = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (p != MAP_FAILED)
+            {
+              ::madvise(p, size, MADV_SEQUENTIAL);
+              map_ = p;
+              mapSize_ = size;
+              data_ = std::string_view(static_cast<const char *>(p), size);
+            }
+          }
+          ::close(fd);
+          if (map_ != nullptr)
+          {
+            return;
+          }
+        }
+#endif
+        std::ifstream in(path, std::ios::binary);
+        if (!in)
+        {
+          throw vix::db::DBError("importFile: cannot open '" + path + "'");
+        }
+        fallback_.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        data_ = fallback_;
+      }
+
+      MappedFile(const MappedFile &) = delete;
+      MappedFile &operator=(const MappedFile &) = delete;
+
+      ~MappedFile()
+      {
+#if !defined(_WIN32)
+        if (map_ != nullptr)
+        {
+          ::munmap(map_, mapSize_);
+        }
+#endif
+      }
+
+      std::string_view data() const noexcept { return data_; }
+    };
+
+    constexpr std::uint64_t ones = 0x0101010101010101ull;
+    constexpr std::uint64_t highs = 0x8080808080808080ull;
+
+    constexpr std::uint64_t has_byte(std::uint64_t w, char c) noexcept
+    {
+      const std::uint64_t x = w ^ (ones * static_cast<unsigned char>(c));
+      return (x - ones) & ~x & highs;
+    }
+
+    /**
+     * @brief First position >= @p i holding @p a or @p b, or s.size().
+     *
+     * Skips 8-byte blocks containing neither byte with one SWAR test.
+     */
+    std::size_t find_either(std::string_view s, std::size_t i, char a, char b) noexcept
+    {
+      const char *data = s.data();
+      const std::size_t n = s.size();
+
+      while (i + 8 <= n)
+      {
+        std::uint64_t w;
+        std::memcpy(&w, data + i, sizeof(w));
+        if ((has_byte(w, a) | has_byte(w, b)) == 0)
+        {
+          i += 8;
+          continue;
+        }
+        break;
+      }
+
+      for (; i < n; ++i)
+      {
+        if (data[i] == a || data[i] == b)
+        {
+          return i;
+        }
+      }
+      return n;
+    }
+
+    /**
+     * @brief Unparsed record text with its starting line.
+     */
+    struct RawRecord
+    {
+      std::size_t line = 0;
+      std::string_view text;
+    };
+
+    /**
+     * @brief Splits input into records; CSV quotes may span lines.
+     *
+     * Quotes follow ImportParser::csv: a quote opens a quoted field only
+     * at the start of a field, and inside one "" is an escaped quote
+     * while any other quote closes it. A stray quote in the middle of an
+     * unquoted field therefore does not swallow the following lines.
+     */
+    class RecordSplitter
+    {
+      std::string_view data_;
+      std::size_t pos_ = 0;
+      std::size_t line_ = 1;
+      ImportFormat format_;
+      char delimiter_;
+
+    public:
+      RecordSplitter(std::string_view data, ImportFormat format, char delimiter)
+          : data_(data), format_(format), delimiter_(delimiter)
+      {
+        // Skip a UTF-8 byte order mark.
+        if (data_.substr(0, 3) == "\xEF\xBB\xBF")
+        {
+          pos_ = 3;
+        }
+      }
+
+      std::size_t position() const noexcept { return pos_; }
+
+      bool next(RawRecord &out)
+      {
+        while (pos_ < data_.size())
+        {
+          const std::size_t start = pos_;
+          const std::size_t line = line_;
+          std::size_t end = data_.size();
+
+          if (format_ == ImportFormat::NDJSON)
+          {
+            const void *nl = std::memchr(data_.data() + start, '\n', data_.size() - start);
+            end = nl ? static_cast<std::size_t>(static_cast<const char *>(nl) - data_.data())
+                     : data_.size();
+            ++line_;
+          }
+          else
+          {
+            bool quoted = false;
+            std::size_t i = start;
+            for (;;)
+            {
+              i = find_either(data_, i, '"', '\n');
+              if (i >= data_.size())
+              {
+                break;
+              }
+              if (data_[i] == '"')
+              {
+                if (quoted)
+                {
+                  const bool escaped = i + 1 < data_.size() && data_[i + 1] == '"';
+                  quoted = escaped;
+                  i += escaped ? 2 : 1;
+                }
+                else
+                {
+                  quoted = i == start || data_[i - 1] == delimiter_;
+                  ++i;
+                }
+                continue;
+              }
+              ++line_;
+              if (!quoted)
+              {
+                break;
+              }
+              ++i;
+            }
+            end = std::min(i, data_.size());
+            if (end == data_.size())
+            {
+              ++line_;
+            }
+          }
+
+          pos_ = std::min(end + 1, data_.size());
+
+          std::string_view text = data_.substr(start, end - start);
+          if (!text.empty() && text.back() == '\r')
+          {
+            text.remove_suffix(1);
+          }
+
+          if (text.find_first_not_of(" \t") == std::string_view::npos)
+          {
+            continue;
+          }
+
+          out = RawRecord{line, text};
+          return true;
+        }
+
+        return false;
+      }
+    };
+
+    // -------------------------------------------------------------------------
+    // Pipeline data
+    // -------------------------------------------------------------------------
+
+    struct RawBatch
+    {
+      std::size_t seq = 0;
+      std::vector<RawRecord> records;
+    };
+
+    /**
+     * @brief Consecutive mapped rows sharing one column list.
+     */
+    struct RowGroup
+    {
+      std::shared_ptr<const std::vector<std::string>> columns;
+      std::vector<vix::db::DbValue> values;
+      std::size_t rows = 0;
+    };
+
+    struct MappedBatch
+    {
+      std::vector<RowGroup> groups;
+      std::vector<ImportError> errors;
+      std::size_t records = 0;
+    };
+
+    bool same_columns(const std::vector<std::string> &a, const ImportRecord &r)
+    {
+      if (a.size() != r.size())
+      {
+        return false;
+      }
+      for (std::size_t i = 0; i < a.size(); ++i)
+      {
+        if (a[i] != r.name(i))
+        {
+          return false;
+        }
+      }
+      return true;
+    }
+
+    bool same_columns(const std::vector<std::string> &a, const FieldValues &f)
+    {
+      if (a.size() != f.size())
+      {
+        return false;
+      }
+      for (std::size_t i = 0; i < a.size(); ++i)
+      {
+        if (a[i] != f[i].first)
+        {
+          return false;
+        }
+      }
+      return true;
+    }
+
+    template <class Source>
+    RowGroup &group_for(MappedBatch &batch, const Source &source, std::size_t count,
+                        const auto &nameAt)
+    {
+      if (batch.groups.empty() || !same_columns(*batch.groups.back().columns, source))
+      {
+        auto columns = std::make_shared<std::vector<std::string>>();
+        columns->reserve(count);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+          const std::string_view name = nameAt(i);
+          detail::require_identifier(name, "importFile");
+          columns->emplace_back(name);
+        }
+
+        RowGroup group;
+        group.columns = std::move(columns);
+        batch.groups.push_back(std::move(group));
+      }
+      return batch.groups.back();
+    }
+
+    /**
+     * @brief Bounded multi-producer / multi-consumer queue.
+     */
+    template <class T>
+    class BoundedQueue
+    {
+      std::mutex mutex_;
+      std::condition_variable notEmpty_;
+      std::condition_variable notFull_;
+      std::deque<T> items_;
+      std::size_t capacity_;
+      bool closed_ = false;
+
+    public:
+      explicit BoundedQueue(std::size_t capacity) : capacity_(capacity) {}
+
+      bool push(T item)
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        notFull_.wait(lock, [&]
+                      { return closed_ || items_.size() < capacity_; });
+        if (closed_)
+        {
+          return false;
+        }
+        items_.push_back(std::move(item));
+        notEmpty_.notify_one();
+        return true;
+      }
+
+      bool pop(T &out)
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        notEmpty_.wait(lock, [&]
+                       { return closed_ || !items_.empty(); });
+        if (items_.empty())
+        {
+          return false;
+        }
+        out = std::move(items_.front());
+        items_.pop_front();
+        notFull_.notify_one();
+        return true;
+      }
+
+      void close()
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        closed_ = true;
+        notEmpty_.notify_all();
+        notFull_.notify_all();
+      }
+    };
+
+    // -------------------------------------------------------------------------
+    // Writer
+    // -------------------------------------------------------------------------
+
+    /**
+     * @brief Multi-row INSERT writer inside a long-lived transaction.
+     *
+     * The pipeline commits between batches only, so every commit
+     * boundary is also a record boundary that a resumed import can
+     * skip to.
+     */
+    class RowWriter
+    {
+      static constexpr std::size_t max_bind_params = 999;
+
+      vix::db::ConnectionPool &pool_;
+      const std::string &table_;
+      std::optional<vix::db::Transaction> tx_;
+      std::size_t pending_ = 0;
+
+      std::shared_ptr<const std::vector<std::string>> sqlColumns_;
+      std::size_t sqlRows_ = 0;
+      std::string sql_;
+
+      const std::string &insertSql(const RowGroup &g, std::size_t rows)
+      {
+        if (sqlColumns_ && sqlRows_ == rows &&
+            (sqlColumns_ == g.columns || *sqlColumns_ == *g.columns))
+        {
+          return sql_;
+        }
+
+        const auto &cols = *g.columns;
+        std::string tuple = "(";
+        for (std::size_t i = 0; i < cols.size(); ++i)
+        {
+          tuple += (i == 0) ? "?" : ",?";
+        }
+        tuple += ")";
+
+        sql_ = "INSERT INTO " + table_ + " (";
+        for (std::size_t i = 0; i < cols.size(); ++i)
+        {
+          if (i != 0)
+          {
+            sql_ += ",";
+          }
+          sql_ += cols[i];
+        }
+        sql_ += ") VALUES ";
+        sql_.reserve(sql_.size() + rows * (tuple.size() + 1));
+        for (std::size_t r = 0; r < rows; ++r)
+        {
+          if (r != 0)
+          {
+            sql_ += ",";
+          }
+          sql_ += tuple;
+        }
+
+        sqlColumns_ = g.columns;
+        sqlRows_ = rows;
+        return sql_;
+      }
+
+    public:
+      RowWriter(vix::db::ConnectionPool &pool, const std::string &table)
+          : pool_(pool), table_(table)
+      {
+      }
+
+      std::size_t pending() const noexcept { return pending_; }
+
+      /**
+       * @brief Insert a group in the open transaction.
+       */
+      void write(const RowGroup &g)
+      {
+        const std::size_t columns = g.columns->size();
+        const std::size_t perStatement = std::max<std::size_t>(1, max_bind_params / columns);
+
+        if (!tx_)
+        {
+          tx_.emplace(pool_);
+        }
+
+        for (std::size_t begin = 0; begin < g.rows;)
+        {
+          const std::size_t rows = std::min(perStatement, g.rows - begin);
+
+          auto st = tx_->conn().prepare(insertSql(g, rows));
+          const std::size_t first = begin * columns;
+          for (std::size_t i = 0; i < rows * columns; ++i)
+          {
+            st->bind(i + 1, g.values[first + i]);
+          }
+          st->exec();
+
+          begin += rows;
+          pending_ += rows;
+        }
+      }
+
+      /**
+       * @brief Commit the open transaction; returns its row count.
+       */
+
+      std::size_t commit()
+      {
+        if (!tx_)
+        {
+          return 0;
+        }
+
+        tx_->commit();
+        tx_.reset();
+
+        const std::size_t n = pending_;
+        pending_ = 0;
+        return n;
+      }
+
+      void rollback() noexcept
+      {
+        if (tx_)
+        {
+          try
+          {
+            tx_->rollback();
+          }
+          catch (...)
+          {
+          }
+          tx_.reset();
+          pending_ = 0;
+        }
+      }
+    };
+  } // namespace
+
+  // ---------------------------------------------------------------------------
+  // Record parsing
+  // ---------------------------------------------------------------------------
+
+  namespace detail
+  {
+    struct ImportParser
+    {
+      using Span = ImportRecord::Span;
+
+      static void reset(ImportRecord &r, std::size_t line, std::string_view source,
+                        const std::vector<std::string> *names)
+      {
+        r.line_ = line;
+        r.source_ = source;
+        r.arena_.clear();
+        r.sharedNames_ = names;
+        r.names_.clear();
+        r.values_.clear();
+      }
+
+      static Span borrowed(std::string_view source, std::string_view part)
+      {
+        return Span{static_cast<std::size_t>(part.data() - source.data()), part.size(), false, false};
+      }
+
+      static Span owned(ImportRecord &r, std::string_view text)
+      {
+        Span s{r.arena_.size(), text.size(), true, false};
+        r.arena_.append(text);
+        return s;
+      }
+
+      static void csv(ImportRecord &r, std::size_t line, std::string_view text, char delimiter,
+                      bool emptyIsNull, const std::vector<std::string> *names)
+      {
+        reset(r, line, text, names);
+
+        std::size_t i = 0;
+        for (;;)
+        {
+          if (i < text.size() && text[i] == '"')
+          {
+            ++i;
+            const std::size_t start = i;
+            bool escaped = false;
+            std::size_t end = std::string_view::npos;
+
+            while (i < text.size())
+            {
+              if (text[i] == '"')
+              {
+                if (i + 1 < text.size() && text[i + 1] == '"')
+                {
+                  escaped = true;
+                  i += 2;
+                  continue;
+                }
+                end = i;
+                ++i;
+                break;
+              }
+              ++i;
+            }
+
+            if (end == std::string_view::npos)
+            {
+              throw vix::db::DBError("unterminated quoted field");
+            }
+
+            const std::string_view raw = text.substr(start, end - start);
+            if (!escaped)
+            {
+              r.values_.push_back(borrowed(text, raw));
+            }
+            else
+            {
+              std::string unescaped;
+              unescaped.reserve(raw.size());
+              for (std::size_t k = 0; k < raw.size(); ++k)
+              {
+                unescaped += raw[k];
+                if (raw[k] == '"')
+                {
+                  ++k;
+                }
+              }
+              r.values_.push_back(owned(r, unescaped));
+            }
+
+            if (i < text.size() && text[i] != delimiter)
+            {
+              throw vix::db::DBError("unexpected character after quoted field");
+            }
+          }
+          else
+          {
+            const std::size_t end = std::min(text.find(delimiter, i), text.size());
+            Span s = borrowed(text, text.substr(i, end - i));
+            s.null = emptyIsNull && s.length == 0;
+            r.values_.push_back(s);
+            i = end;
+          }
+
+          if (i >= text.size())
+          {
+            break;
+          }
+          ++i; // delimiter
+        }
+
+        if (names && r.values_.size() != names->size())
+        {
+          throw vix::db::DBError("expected " + std::to_string(names->size()) + " fields, got " +
+                                 std::to_string(r.values_.size()));
+        }
+      }
+
+      // -- NDJSON -------------------------------------------------------------
+
+      static void skip_ws(std::string_view t, std::size_t &i)
+      {
+        while (i < t.size() && (t[i] == ' ' || t[i] == '\t' || t[i] == '\r' || t[i] == '\n'))
+        {
+          ++i;
+        }
+      }
+
+      static void append_utf8(std::string &out, std::uint32_t cp)
+      {
+        if (cp < 0x80)
+        {
+          out += static_cast<char>(cp);
+        }
+        else if (cp < 0x800)
+        {
+          out += static_cast<char>(0xC0 | (cp >> 6));
+          out += static_cast<char>(0x80 | (cp & 0x3F));
+        }
+        else if (cp < 0x10000)
+        {
+          out += static_cast<char>(0xE0 | (cp >> 12));
+          out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+          out += static_cast<char>(0x80 | (cp & 0x3F));
+        }
+        else
+        {
+          out += static_cast<char>(0xF0 | (cp >> 18));
+          out += static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+          out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+          out += static_cast<char>(0x80 | (cp & 0x3F));
+        }
+      }
+
+      static std::uint32_t hex4(std::string_view t, std::size_t i)
+      {
+        if (i + 4 > t.size())
+        {
+          throw vix::db::DBError("truncated \\u escape");
+        }
+
+        std::uint32_t v = 0;
+        const auto res = std::from_chars(t.data() + i, t.data() + i + 4, v, 16);
+        if (res.ptr != t.data() + i + 4)
+        {
+          throw vix::db::DBError("invalid \\u escape");
+        }
+        return v;
+      }
+
+      /**
+       * @brief Parse a JSON string at t[i] == '"'.
+       */
+      static Span json_string(ImportRecord &r, std::string_view t, std::size_t &i)
+      {
+        const std::size_t start = ++i;
+        const std::size_t end = find_either(t, i, '"', '\\');
+        if (end < t.size() && t[end] == '"')
+        {
+          i = end + 1;
+          return borrowed(t, t.substr(start, end - start));
+        }
+
+        std::string out(t.substr(start, end - start));
+        i = end;
+        while (i < t.size() && t[i] != '"')
+        {
+          if (t[i] != '\\')
+          {
+            out += t[i++];
+            continue;
+          }
+
+          if (++i >= t.size())
+          {
+            break;
+          }
+
+          const char e = t[i++];
+          switch (e)
+          {
+          case '"':
+          case '\\':
+          case '/':
+            out += e;
+            break;
+          case 'b':
+            out += '\b';
+            break;
+          case 'f':
+            out += '\f';
+            break;
+          case 'n':
+            out += '\n';
+            break;
+          case 'r':
+            out += '\r';
+            break;
+          case 't':
+            out += '\t';
+            break;
+          case 'u':
+          {
+            std::uint32_t cp = hex4(t, i);
+            i += 4;
+            if (cp >= 0xD800 && cp <= 0xDBFF && i + 6 <= t.size() && t[i] == '\\' && t[i + 1] == 'u')
+            {
+              const std::uint32_t lo = hex4(t, i + 2);
+              if (lo >= 0xDC00 && lo <= 0xDFFF)
+              {
+                cp = 0x10000 + ((cp - 0xD800) << 10) + (lo - 0xDC00);
+                i += 6;
+              }
+            }
+            append_utf8(out, cp);
+            break;
+          }
+          default:
+            throw vix::db::DBError("invalid escape in JSON string");
+          }
+        }
+
+        if (i >= t.size())
+        {
+          throw vix::db::DBError("unterminated JSON string");
+        }
+        ++i;
+        return owned(r, out);
+      }
+
+      /**
+       * @brief Skip a nested JSON object or array, returning its text.
+       */
+      static std::string_view json_nested(std::string_view t, std::size_t &i)
+      {
+        const std::size_t start = i;
+        int depth = 0;
+        while (i < t.size())
+        {
+          const char c = t[i];
+          if (c == '"')
+          {
+            ++i;
+            while (i < t.size() && t[i] != '"')
+            {
+              i += (t[i] == '\\') ? 2 : 1;
+            }
+            ++i;
+            continue;
+          }
+          if (c == '{' || c == '[')
+          {
+            ++depth;
+          }
+          else if (c == '}' || c == ']')
+          {
+            if (--depth == 0)
+            {
+              ++i;
+              return t.substr(start, i - start);
+            }
+          }
+          ++i;
+        }
+        throw vix::db::DBError("unterminated JSON value");
+      }
+
+      static void ndjson(ImportRecord &r, std::size_t line, std::string_view t)
+      {
+        reset(r, line, t, nullptr);
+
+        std::size_t i = 0;
+        skip_ws(t, i);
+        if (i >= t.size() || t[i] != '{')
+        {
+          throw vix::db::DBError("expected a JSON object");
+        }
+        ++i;
+
+        skip_ws(t, i);
+        if (i < t.size() && t[i] == '}')
+        {
+          return;
+        }
+
+        for (;;)
+        {
+          skip_ws(t, i);
+          if (i >= t.size() || t[i] != '"')
+          {
+            throw vix::db::DBError("expected a member name");
+          }
+          r.names_.push_back(json_string(r, t, i));
+
+          skip_ws(t, i);
+          if (i >= t.size() || t[i] != ':')
+          {
+            throw vix::db::DBError("expected ':'");
+          }
+          ++i;
+          skip_ws(t, i);
+          if (i >= t.size())
+          {
+            throw vix::db::DBError("expected a value");
+          }
+
+          const char c = t[i];
+          if (c == '"')
+          {
+            r.values_.push_back(json_string(r, t, i));
+          }
+          else if (c == '{' || c == '[')
+          {
+            r.values_.push_back(borrowed(t, json_nested(t, i)));
+          }
+          else if (t.compare(i, 4, "null") == 0)
+          {
+            Span s{};
+            s.null = true;
+            r.values_.push_back(s);
+            i += 4;
+          }
+          else if (t.compare(i, 4, "true") == 0)
+          {
+            r.values_.push_back(owned(r, "1"));
+            i += 4;
+          }
+          else if (t.compare(i, 5, "false") == 0)
+          {
+            r.values_.push_back(owned(r, "0"));
+            i += 5;
+          }
+          else
+          {
+            const std::size_t start = i;
+            while (i < t.size() && (std::isdigit(static_cast<unsigned char>(t[i])) ||
+                                    t[i] == '-' || t[i] == '+' || t[i] == '.' ||
+                                    t[i] == 'e' || t[i] == 'E'))
+            {
+              ++i;
+            }
+            if (i == start)
+            {
+              throw vix::db::DBError("invalid JSON value");
+            }
+            r.values_.push_back(borrowed(t, t.substr(start, i - start)));
+          }
+
+          skip_ws(t, i);
+          if (i < t.size() && t[i] == ',')
+          {
+            ++i;
+            continue;
+          }
+          if (i < t.size() && t[i] == '}')
+          {
+            return;
+          }
+          throw vix::db::DBError("expected ',' or '}'");
+        }
+      }
+    };
+
+    // -------------------------------------------------------------------------
+    // Pipeline
+    // -------------------------------------------------------------------------
+
+    ImportResult run_import(vix::db::ConnectionPool &pool,
+                            const std::string &table,
+                            const std::string &path,
+                            const ImportConfig &config,
+                            const RecordMapper &mapper)
+    {
+      require_identifier(table, "importFile");
+
+      const MappedFile file(path);
+      const std::string_view data = file.data();
+
+      RecordSplitter splitter(data, config.format, config.csvDelimiter);
+
+      // CSV column names: header line or configured list.
+      std::vector<std::string> header;
+      if (config.format == ImportFormat::CSV)
+      {
+        if (config.csvHeader)
+        {
+          RawRecord first;
+          if (splitter.next(first))
+          {
+            ImportRecord r;
+            ImportParser::csv(r, first.line, first.text, config.csvDelimiter, false, nullptr);
+            for (std::size_t i = 0; i < r.size(); ++i)
+            {
+              header.emplace_back(r.value(i));
+            }
+          }
+        }
+        else
+        {
+          header = config.columns;
+        }
+
+        if (header.empty() && !data.empty())
+        {
+          throw vix::db::DBError("importFile: CSV column names are required");
+        }
+      }
+
+      const std::size_t workers =
+          config.workers != 0 ? config.workers
+                              : std::max(2u, std::thread::hardware_concurrency()) - 1;
+      const std::size_t batchRecords = std::max<std::size_t>(1, config.batchRecords);
+
+      BoundedQueue<RawBatch> work(workers * 2);
+
+      // Mapped batches wait in `done` until the writer reaches them.
+      // Workers only publish batches within `window` of the one being
+      // written, so a slow database bounds memory instead of letting
+      // mapped rows pile up.
+      const std::size_t window = workers * 2;
+
+      std::mutex doneMutex;
+      std::condition_variable doneCv;
+      std::map<std::size_t, MappedBatch> done;
+      std::size_t writing = 0;
+
+      std::atomic<bool> stop{false};
+      std::atomic<std::uint64_t> bytesRead{0};
+      std::exception_ptr failure;
+      std::mutex failureMutex;
+
+      auto fail = [&](std::exception_ptr e)
+      {
+        {
+          std::lock_guard<std::mutex> lock(failureMutex);
+          if (!failure)
+          {
+            failure = e;
+          }
+        }
+        stop = true;
+        work.close();
+        doneCv.notify_all();
+      };
+
+      std::size_t batchCount = 0;
+      std::atomic<bool> readerDone{false};
+
+      // Stage 1: split the mapped file into record batches.
+      std::thread reader([&]
+                         {
+                           try
+                           {
+                             std::uint64_t skip = config.skipRecords;
+                             RawBatch batch;
+                             RawRecord rec;
+                             std::size_t seq = 0;
+
+                             while (!stop && splitter.next(rec))
+                             {
+                               if (skip != 0)
+                               {
+                                 --skip;
+                                 continue;
+                               }
+
+                               batch.records.push_back(rec);
+                               if (batch.records.size() >= batchRecords)
+                               {
+                                 batch.seq = seq++;
+                                 bytesRead = splitter.position();
+                                 if (!work.push(std::move(batch)))
+                                 {
+                                   return;
+                                 }
+                                 batch = RawBatch{};
+                               }
+                             }
+
+                             if (!batch.records.empty())
+                             {
+                               batch.seq = seq++;
+                               work.push(std::move(batch));
+                             }
+
+                             bytesRead = splitter.position();
+                             {
+                               std::lock_guard<std::mutex> lock(doneMutex);
+                               batchCount = seq;
+                               readerDone = true;
+                             }
+                             doneCv.notify_all();
+                             work.close();
+                           }
+                           catch (...)
+                           {
+                             fail(std::current_exception());
+                           } });
+
+      // Stage 2: parse and map records on worker threads.
+      const std::vector<std::string> *names = header.empty() ? nullptr : &header;
+
+      auto mapBatch = [&](const RawBatch &raw)
+      {
+        MappedBatch out;
+        out.records = raw.records.size();
+
+        ImportRecord record;
+        for (const RawRecord &rec : raw.records)
+        {
+          try
+          {
+            if (config.format == ImportFormat::CSV)
+            {
+              ImportParser::csv(record, rec.line, rec.text, config.csvDelimiter, config.emptyIsNull, names);
+            }
+            else
+            {
+              ImportParser::ndjson(record, rec.line, rec.text);
+            }
+
+            if (mapper)
+            {
+              const FieldValues fields = mapper(record);
+              if (fields.empty())
+              {
+                throw vix::db::DBError("mapper produced no fields");
+              }
+
+              std::vector<vix::db::DbValue> values;
+              values.reserve(fields.size());
+              for (const auto &f : fields)
+              {
+                values.push_back(any_to_dbvalue_or_throw(f.second));
+              }
+
+              RowGroup &g = group_for(out, fields, fields.size(), [&](std::size_t i)
+                                      { return std::string_view(fields[i].first); });
+              std::move(values.begin(), values.end(), std::back_inserter(g.values));
+              ++g.rows;
+            }
+            else
+            {
+              if (record.size() == 0)
+              {
+                throw vix::db::DBError("record has no fields");
+              }
+
+              RowGroup &g = group_for(out, record, record.size(), [&](std::size_t i)
+                                      { return record.name(i); });
+              for (std::size_t i = 0; i < record.size(); ++i)
+              {
+                g.values.push_back(record.isNull(i) ? vix::db::null()
+                                                    : vix::db::str(std::string(record.value(i))));
+              }
+              ++g.rows;
+            }
+          }
+          catch (const std::exception &e)
+          {
+            out.errors.push_back(ImportError{rec.line, e.what()});
+          }
+        }
+
+        return out;
+      };
+
+      std::vector<std::thread> pool_threads;
+      pool_threads.reserve(workers);
+      for (std::size_t w = 0; w < workers; ++w)
+      {
+        pool_threads.emplace_back([&]
+                                  {
+                                    try
+                                    {
+                                      RawBatch raw;
+                                      while (!stop && work.pop(raw))
+                                      {
+                                        MappedBatch mapped = mapBatch(raw);
+                                        {
+                                          std::unique_lock<std::mutex> lock(doneMutex);
+                                          doneCv.wait(lock, [&]
+                                                      { return stop || raw.seq < writing + window; });
+                                          if (stop)
+                                          {
+                                            return;
+                                          }
+                                          done.emplace(raw.seq, std::move(mapped));
+                                        }
+                                        doneCv.notify_all();
+                                      }
+                                    }
+                                    catch (...)
+                                    {
+                                      fail(std::current_exception());
+                                    } });
+      }
+
+      auto joinAll = [&]
+      {
+        stop = true;
+        work.close();
+        doneCv.notify_all();
+        if (reader.joinable())
+        {
+          reader.join();
+        }
+        for (auto &t : pool_threads)
+        {
+          if (t.joinable())
+          {
+            t.join();
+          }
+        }
+      };
+
+      // Stage 3: write batches in file order on this thread.
+      ImportResult result;
+      result.progress.totalBytes = data.size();
+      RowWriter writer(pool, table);
+      const std::size_t transactionRows = std::max<std::size_t>(1, config.transactionRows);
+      std::uint64_t pendingRecords = 0;
+
+      auto report = [&]
+      {
+        result.progress.bytesRead = bytesRead;
+        if (config.onProgress)
+        {
+          config.onProgress(result.progress);
+        }
+      };
+
+      try
+      {
+        for (std::size_t next = 0;; ++next)
+        {
+          MappedBatch batch;
+          {
+            std::unique_lock<std::mutex> lock(doneMutex);
+            doneCv.wait(lock, [&]
+                        { return stop || done.count(next) != 0 || (readerDone && next >= batchCount); });
+
+            if (failure)
+            {
+              std::rethrow_exception(failure);
+            }
+
+            auto it = done.find(next);
+            if (it == done.end())
+            {
+              break;
+            }
+            batch = std::move(it->second);
+            done.erase(it);
+            writing = next + 1;
+          }
+          doneCv.notify_all();
+
+          result.progress.failed += batch.errors.size();
+          for (auto &e : batch.errors)
+          {
+            if (result.errors.size() < config.maxErrors)
+            {
+              result.errors.push_back(std::move(e));
+            }
+          }
+
+          if (result.progress.failed > config.maxErrors)
+          {
+            throw vix::db::DBError("importFile: too many rejected records (" +
+                          std::to_string(result.progress.failed) + ")");
+          }
+
+          pendingRecords += batch.records;
+          for (const RowGroup &g : batch.groups)
+          {
+            writer.write(g);
+          }
+
+          if (writer.pending() >= transactionRows)
+          {
+            result.progress.inserted += writer.commit();
+            result.progress.records += pendingRecords;
+            pendingRecords = 0;
+            report();
+          }
+        }
+
+        result.progress.inserted += writer.commit();
+        result.progress.records += pendingRecords;
+        report();
+      }
+      catch (...)
+      {
+        writer.rollback();
+        joinAll();
+        throw;
+      }
+
+      joinAll();
+      if (failure)
+      {
+        std::rethrow_exception(failure);
+      }
+
+      return result;
+    }
+  } // namespace detail
+
+  // ---------------------------------------------------------------------------
+  // ImportRecord typed accessors
+  // ---------------------------------------------------------------------------
+
+  std::int64_t ImportRecord::getInt64(std::string_view field, std::int64_t fallback) const
+  {
+    const auto v = get(field);
+    if (!v || v->empty())
+    {
+      return fallback;
+    }
+
+    std::int64_t out = 0;
+    const auto res = std::from_chars(v->data(), v->data() + v->size(), out);
+    if (res.ec != std::errc() || res.ptr != v->data() + v->size())
+    {
+      throw vix::db::DBError("field '" + std::string(field) + "' is not an integer");
+    }
+    return out;
+  }
+
+  double ImportRecord::getDouble(std::string_view field, double fallback) const
+  {
+    const auto v = get(field);
+    if (!v || v->empty())
+    {
+      return fallback;
+    }
+
+    double out = 0;
+    const auto res = std::from_chars(v->data(), v->data() + v->size(), out);
+    if (res.ec != std::errc() || res.ptr != v->data() + v->size())
+    {
+      throw vix::db::DBError("field '" + std::string(field) + "' is not a number");
+    }
+    return out;
+  }
+
+  bool ImportRecord::getBool(std::string_view field, bool fallback) const
+  {
+    const auto v = get(field);
+    if (!v || v->empty())
+    {
+      return fallback;
+    }
+    if (*v == "1" || *v == "true" || *v == "TRUE")
+    {
+      return true;
+    }
+    if (*v == "0" || *v == "false" || *v == "FALSE")
+    {
+      return false;
+    }
+    throw vix::db::DBError("field '" + std::string(field) + "' is not a boolean");
+  }
+
+} // namespace vix::orm
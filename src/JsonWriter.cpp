@@ -0,0 +1,330 @@
+/**
+ *
+ *  @file JsonWriter.cpp
+ *  @author Gaspard Kirira
+ *
+ *  Copyright 2025, Gaspard Kirira.
+ *  All rights reserved.
+ *  https://github.com/vixcpp/vix
+ *
+ *  Use of this source code is governed by a MIT license
+ *  that can be found in the License file.
+ *
+ *  Vix.cpp
+ */
+#include <vix/orm/JsonWriter.hpp>
+
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <ostream>
+#include <utility>
+
+namespace vix::orm
+{
+  namespace
+  {
+    constexpr std::uint64_t ones = 0x0101010101010101ull;
+    constexpr std::uint64_t highs = 0x8080808080808080ull;
+
+    /**
+     * @brief Whether any of the 8 bytes of @p w needs JSON escaping.
+     *
+     * SWAR test for bytes < 0x20, '"' or '\\'; exact, no false negatives
+     * or positives for the block as a whole.
+     */
+    constexpr bool block_needs_escape(std::uint64_t w) noexcept
+    {
+      const std::uint64_t control = (w - ones * 0x20) & ~w & highs;
+      const std::uint64_t q = w ^ (ones * '"');
+      const std::uint64_t quote = (q - ones) & ~q & highs;
+      const std::uint64_t b = w ^ (ones * '\\');
+      const std::uint64_t backslash = (b - ones) & ~b & highs;
+      return (control | quote | backslash) != 0;
+    }
+
+    constexpr bool byte_needs_escape(unsigned char c) noexcept
+    {
+      return c < 0x20 || c == '"' || c == '\\';
+    }
+
+    void append_escape(std::string &out, unsigned char c)
+    {
+      switch (c)
+      {
+      case '"':
+        out += "\\\"";
+        return;
+      case '\\':
+        out += "\\\\";
+        return;
+      case '\n':
+        out += "\\n";
+        return;
+      case '\r':
+        out += "\\r";
+        return;
+      case '\t':
+        out += "\\t";
+        return;
+      case '\b':
+        out += "\\b";
+        return;
+      case '\f':
+        out += "\\f";
+        return;
+      default:
+        break;
+      }
+
+      static constexpr char hex[] = "0123456789abcdef";
+      const char seq[6] = {'\\', 'u', '0', '0', hex[c >> 4], hex[c & 0xF]};
+      out.append(seq, sizeof(seq));
+    }
+
+    template <class N>
+    void append_number(std::string &out, N v)
+    {
+      char tmp[32];
+      const auto res = std::to_chars(tmp, tmp + sizeof(tmp), v);
+      out.append(tmp, static_cast<std::size_t>(res.ptr - tmp));
+    }
+  } // namespace
+
+  namespace detail
+  {
+    void append_json_escaped(std::string &out, std::string_view s)
+    {
+      const char *data = s.data();
+      const std::size_t n = s.size();
+
+      // Copy clean 8-byte blocks in bulk; only blocks containing a byte
+      // that needs escaping are walked one byte at a time.
+      std::size_t clean = 0;
+      std::size_t i = 0;
+
+      while (i < n)
+      {
+        if (i + 8 <= n)
+        {
+          std::uint64_t w;
+          std::memcpy(&w, data + i, sizeof(w));
+          if (!block_needs_escape(w))
+          {
+            i += 8;
+            continue;
+          }
+        }
+
+        const std::size_t end = (i + 8 <= n) ? i + 8 : n;
+        for (; i < end; ++i)
+        {
+          const auto c = static_cast<unsigned char>(data[i]);
+          if (byte_needs_escape(c))
+          {
+            out.append(data + clean, i - clean);
+            append_escape(out, c);
+            clean = i + 1;
+          }
+        }
+      }
+
+      out.append(data + clean, n - clean);
+    }
+  } // namespace detail
+
+  JsonWriter::JsonWriter(Sink sink, std::size_t chunkSize)
+      : sink_(std::move(sink)), chunkSize_(chunkSize == 0 ? default_chunk_size : chunkSize)
+  {
+    buffer_.reserve(chunkSize_ + chunkSize_ / 4);
+  }
+
+  JsonWriter::JsonWriter(std::string &out, std::size_t chunkSize)
+      : JsonWriter([&out](std::string_view chunk)
+                   { out.append(chunk); },
+                   chunkSize)
+  {
+  }
+
+  JsonWriter::JsonWriter(std::ostream &out, std::size_t chunkSize)
+      : JsonWriter([&out](std::string_view chunk)
+                   { out.write(chunk.data(), static_cast<std::streamsize>(chunk.size())); },
+                   chunkSize)
+  {
+  }
+
+  JsonWriter::~JsonWriter()
+  {
+    try
+    {
+      flush();
+    }
+    catch (...)
+    {
+    }
+  }
+
+  void JsonWriter::separate()
+  {
+    if (needComma_)
+    {
+      buffer_ += ',';
+    }
+    needComma_ = true;
+  }
+
+  void JsonWriter::maybeFlush()
+  {
+    if (buffer_.size() >= chunkSize_)
+    {
+      flush();
+    }
+  }
+
+  void JsonWriter::flush()
+  {
+    if (buffer_.empty())
+    {
+      return;
+    }
+
+    if (sink_)
+    {
+      sink_(buffer_);
+    }
+    buffer_.clear();
+  }
+
+  void JsonWriter::beginObject()
+  {
+    separate();
+    buffer_ += '{';
+    needComma_ = false;
+  }
+
+  void JsonWriter::endObject()
+  {
+    buffer_ += '}';
+    needComma_ = true;
+    maybeFlush();
+  }
+
+  void JsonWriter::beginArray()
+  {
+    separate();
+    buffer_ += '[';
+    needComma_ = false;
+  }
+
+  void JsonWriter::endArray()
+  {
+    buffer_ += ']';
+    needComma_ = true;
+    maybeFlush();
+  }
+
+  void JsonWriter::key(std::string_view name)
+  {
+    separate();
+    buffer_ += '"';
+    detail::append_json_escaped(buffer_, name);
+    buffer_ += "\":";
+    needComma_ = false;
+  }
+
+  void JsonWriter::null()
+  {
+    separate();
+    buffer_ += "null";
+    maybeFlush();
+  }
+
+  void JsonWriter::value(bool v)
+  {
+    separate();
+    buffer_ += v ? "true" : "false";
+    maybeFlush();
+  }
+
+  void JsonWriter::value(std::int64_t v)
+  {
+    separate();
+    append_number(buffer_, v);
+    maybeFlush();
+  }
+
+  void JsonWriter::value(std::uint64_t v)
+  {
+    separate();
+    append_number(buffer_, v);
+    maybeFlush();
+  }
+
+  void JsonWriter::value(double v)
+  {
+    separate();
+    if (std::isfinite(v))
+    {
+      append_number(buffer_, v);
+    }
+    else
+    {
+      buffer_ += "null";
+    }
+    maybeFlush();
+  }
+
+  void JsonWriter::value(std::string_view v)
+  {
+    separate();
+    buffer_ += '"';
+    detail::append_json_escaped(buffer_, v);
+    buffer_ += '"';
+    maybeFlush();
+  }
+
+  void JsonWriter::value(std::span<const std::byte> bytes)
+  {
+    static constexpr char alphabet[] =
+        "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+    separate();
+    buffer_ += '"';
+
+    std::size_t i = 0;
+    for (; i + 3 <= bytes.size(); i += 3)
+    {
+      const auto n = (std::to_integer<std::uint32_t>(bytes[i]) << 16) |
+                     (std::to_integer<std::uint32_t>(bytes[i + 1]) << 8) |
+                     std::to_integer<std::uint32_t>(bytes[i + 2]);
+      const char quad[4] = {alphabet[(n >> 18) & 63], alphabet[(n >> 12) & 63],
+                            alphabet[(n >> 6) & 63], alphabet[n & 63]};
+      buffer_.append(quad, 4);
+    }
+
+    if (const std::size_t rest = bytes.size() - i; rest != 0)
+    {
+      std::uint32_t n = std::to_integer<std::uint32_t>(bytes[i]) << 16;
+      if (rest == 2)
+      {
+        n |= std::to_integer<std::uint32_t>(bytes[i + 1]) << 8;
+      }
+
+      buffer_ += alphabet[(n >> 18) & 63];
+      buffer_ += alphabet[(n >> 12) & 63];
+      buffer_ += rest == 2 ? alphabet[(n >> 6) & 63] : '=';
+      buffer_ += '=';
+    }
+
+    buffer_ += '"';
+    maybeFlush();
+  }
+
+  void JsonWriter::raw(std::string_view json)
+  {
+    separate();
+    buffer_.append(json);
+    maybeFlush();
+  }
+
+} // namespace vix::orm
@@ -0,0 +1,92 @@
+/**
+ *
+ *  @file RoutedRepository.cpp
+ *  @author Gaspard Kirira
+ *
+ *  Copyright 2025, Gaspard Kirira.
+ *  All rights reserved.
+ *  https://github.com/vixcpp/vix
+ *
+ *  Use of this source code is governed by a MIT license
+ *  that can be found in the License file.
+ *
+ *  Vix.cpp
+ */
+#include <vix/orm/RoutedRepository.hpp>
+
+#include <system_error>
+#include <utility>
+
+namespace vix::orm::detail
+{
+  HedgeExecutor::HedgeExecutor(std::size_t threads)
+  {
+    workers_.reserve(threads);
+    for (std::size_t i = 0; i < threads; ++i)
+    {
+      try
+      {
+        workers_.emplace_back([this]
+                              { work(); });
+      }
+      catch (const std::system_error &)
+      {
+        // Run with the workers started so far; none means no hedging.
+        break;
+      }
+    }
+  }
+
+  HedgeExecutor::~HedgeExecutor()
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stopping_ = true;
+    }
+    cv_.notify_all();
+
+    for (auto &t : workers_)
+    {
+      t.join();
+    }
+  }
+
+  bool HedgeExecutor::trySubmit(std::function<void()> task)
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (stopping_ || idle_ <= tasks_.size())
+      {
+        return false;
+      }
+      tasks_.push_back(std::move(task));
+    }
+
+    cv_.notify_one();
+    return true;
+  }
+
+  void HedgeExecutor::work()
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;)
+    {
+      ++idle_;
+      cv_.wait(lock, [this]
+               { return stopping_ || !tasks_.empty(); });
+      --idle_;
+
+      if (tasks_.empty())
+      {
+        return;
+      }
+
+      auto task = std::move(tasks_.front());
+      tasks_.pop_front();
+
+      lock.unlock();
+      task();
+      lock.lock();
+    }
+  }
+} // namespace vix::orm::detail
@@ -0,0 +1,254 @@
+/**
+ *
+ *  @file batched_job_test.cpp
+ *  @author Gaspard Kirira
+ *
+ *  Copyright 2025, Gaspard Kirira.
+ *  All rights reserved.
+ *  https://github.com/vixcpp/vix
+ *
+ *  Use of this source code is governed by a MIT license
+ *  that can be found in the License file.
+ *
+ *  Vix.cpp
+ */
+#include <vix/orm/BatchedJob.hpp>
+
+#include "fake_db.hpp"
+
+#include <cstdint>
+#include <cstdio>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace
+{
+  using vix::orm::BatchedJob;
+  using vix::orm::BatchedJobOptions;
+  using vix::orm::BatchedJobProgress;
+  using vix::orm::CancellationToken;
+  using vix::orm::QueryBuilder;
+  using vix::orm::test::as_int;
+  using vix::orm::test::as_text;
+  using vix::orm::test::Call;
+  using vix::orm::test::FakeConnection;
+  using vix::orm::test::Row;
+
+  constexpr std::int64_t min64 = std::numeric_limits<std::int64_t>::min();
+
+  int failures = 0;
+
+  void check(bool ok, const char *what)
+  {
+    if (!ok)
+    {
+      std::fprintf(stderr, "FAILED: %s\n", what);
+      ++failures;
+    }
+  }
+
+  template <class Fn>
+  bool throws(Fn &&fn)
+  {
+    try
+    {
+      fn();
+    }
+    catch (const vix::db::DBError &)
+    {
+      return true;
+    }
+    return false;
+  }
+
+  /**
+   * @brief Keyed table answering the job's key probes; DELETE removes keys.
+   */
+  struct Table
+  {
+    std::set<std::int64_t> keys;
+    std::shared_ptr<FakeConnection> conn = std::make_shared<FakeConnection>();
+    vix::db::ConnectionPool pool = vix::orm::test::fake_pool(conn);
+
+    explicit Table(std::set<std::int64_t> initial)
+        : keys(std::move(initial))
+    {
+      conn->onQuery = [this](const Call &call)
+      {
+        std::vector<std::int64_t> after;
+        for (std::int64_t k : keys)
+        {
+          if (call.binds.empty() || k > *as_int(call.binds[0]))
+          {
+            after.push_back(k);
+          }
+        }
+
+        std::size_t pick = after.size();
+        if (const auto at = call.sql.find(" OFFSET "); at != std::string::npos)
+        {
+          pick = std::stoul(call.sql.substr(at + 8));
+        }
+        else if (call.sql.find("MAX(") != std::string::npos && !after.empty())
+        {
+          pick = after.size() - 1;
+        }
+
+        return pick < after.size() ? std::vector<Row>{{std::to_string(after[pick])}}
+                                   : std::vector<Row>{};
+      };
+
+      conn->onExec = [this](const Call &call)
+      {
+        const std::int64_t first = *as_int(call.binds[call.binds.size() - rangeFromEnd(call) - 2]);
+        const std::int64_t last = *as_int(call.binds[call.binds.size() - rangeFromEnd(call) - 1]);
+
+        std::uint64_t n = 0;
+        for (auto it = keys.lower_bound(first); it != keys.end() && *it <= last;)
+        {
+          ++n;
+          it = call.sql.rfind("DELETE", 0) == 0 ? keys.erase(it) : std::next(it);
+        }
+        return n;
+      };
+    }
+
+    Table(const Table &) = delete;
+    Table &operator=(const Table &) = delete;
+
+    /// Filter parameters bound after the key range.
+    static std::size_t rangeFromEnd(const Call &call)
+    {
+      return call.sql.find(" AND (") == std::string::npos ? 0 : 1;
+    }
+
+    BatchedJobOptions options(std::size_t chunkSize) const
+    {
+      BatchedJobOptions opt;
+      opt.table = "events";
+      opt.chunkSize = chunkSize;
+      return opt;
+    }
+  };
+
+  std::set<std::int64_t> keysUpTo(std::int64_t n)
+  {
+    std::set<std::int64_t> out{min64};
+    for (std::int64_t k = 1; k <= n; ++k)
+    {
+      out.insert(k);
+    }
+    return out;
+  }
+} // namespace
+
+int main()
+{
+  {
+    Table table(keysUpTo(10));
+
+    std::vector<std::int64_t> checkpoints;
+    const BatchedJobProgress progress = BatchedJob::purge(table.pool, table.options(4))
+                                            .onCheckpoint([&](const BatchedJobProgress &p)
+                                                          { checkpoints.push_back(p.lastKey); })
+                                            .run();
+
+    const auto deletes = table.conn->callsWith("DELETE FROM events");
+
+    check(table.keys.empty(), "purge: every row removed, INT64_MIN included");
+    check(progress.finished && progress.started && progress.chunks == 3 && progress.rows == 11,
+          "purge: progress counts chunks and rows");
+    check(checkpoints == std::vector<std::int64_t>{3, 7, 10}, "purge: a checkpoint after each chunk");
+    check(!deletes.empty() && deletes[0].sql == "DELETE FROM events WHERE id >= ? AND id <= ?" &&
+              as_int(deletes[0].binds[0]) == min64 && as_int(deletes[0].binds[1]) == 3,
+          "purge: the first chunk starts at INT64_MIN");
+    check(deletes.size() == 3 && as_int(deletes[1].binds[0]) == 4 && as_int(deletes[2].binds[1]) == 10,
+          "purge: chunks are contiguous key ranges");
+    check(table.conn->callsWith("COMMIT").size() == 3, "purge: one transaction per chunk");
+  }
+
+  {
+    Table table(keysUpTo(10));
+
+    CancellationToken token;
+    auto job = BatchedJob::purge(table.pool, table.options(4));
+    job.onCheckpoint([&](const BatchedJobProgress &)
+                     { token.cancel(); });
+
+    const auto first = job.run(token);
+    check(!first.finished && first.chunks == 1 && first.lastKey == 3,
+          "cancel: stops after the current chunk");
+
+    const auto rest = BatchedJob::purge(table.pool, table.options(4)).resumeFrom(first.lastKey).run();
+    check(rest.finished && rest.chunks == 2 && rest.rows == 7 && table.keys.empty(),
+          "resumeFrom: continues after the last committed key");
+  }
+
+  {
+    Table table(keysUpTo(3));
+
+    CancellationToken token;
+    token.cancel();
+    const auto progress = BatchedJob::purge(table.pool, table.options(2)).run(token);
+
+    check(!progress.started && progress.chunks == 0 && table.conn->calls().empty(),
+          "cancelled token: nothing runs");
+  }
+
+  {
+    Table table(keysUpTo(5));
+
+    QueryBuilder set("status = ?");
+    set.param(std::string("archived"));
+
+    auto opt = table.options(10);
+    opt.filter = QueryBuilder("owner = ?");
+    opt.filter->param(std::int64_t{42});
+
+    const auto progress = BatchedJob::update(table.pool, opt, set).run();
+    const auto updates = table.conn->callsWith("UPDATE events");
+
+    check(progress.finished && progress.rows == 6 && table.keys.size() == 6, "update: rows kept");
+    check(updates.size() == 1 &&
+              updates[0].sql == "UPDATE events SET status = ? WHERE id >= ? AND id <= ? AND (owner = ?)",
+          "update: SET list, key range and filter");
+    check(updates.size() == 1 && updates[0].binds.size() == 4 && as_text(updates[0].binds[0]) == "archived" &&
+              as_int(updates[0].binds[2]) == 5 && as_int(updates[0].binds[3]) == 42,
+          "update: SET parameters, then range, then filter");
+  }
+
+  {
+    Table table({});
+
+    const auto progress = BatchedJob::purge(table.pool, table.options(4)).run();
+    check(progress.finished && !progress.started && progress.chunks == 0, "empty table: finishes at once");
+
+    auto bad = table.options(4);
+    bad.table = "events; DROP TABLE users";
+    check(throws([&]
+                 { (void)BatchedJob::purge(table.pool, bad); }),
+          "invalid table name throws");
+
+    check(throws([&]
+                 { (void)BatchedJob::purge(table.pool, table.options(0)); }),
+          "zero chunk size throws");
+
+    auto idle = table.options(4);
+    idle.dutyCycle = 0.0;
+    check(throws([&]
+                 { (void)BatchedJob::purge(table.pool, idle); }),
+          "duty cycle outside (0, 1] throws");
+
+    check(throws([&]
+                 { (void)BatchedJob::update(table.pool, table.options(4), QueryBuilder{}); }),
+          "update with an empty SET list throws");
+  }
+
+  return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,170 @@
+/**
+ *
+ *  @file export_test.cpp
+ *  @author Gaspard Kirira
+ *
+ *  Copyright 2025, Gaspard Kirira.
+ *  All rights reserved.
+ *  https://github.com/vixcpp/vix
+ *
+ *  Use of this source code is governed by a MIT license
+ *  that can be found in the License file.
+ *
+ *  Vix.cpp
+ */
+#include <vix/orm/Export.hpp>
+
+#include "fake_db.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace
+{
+  using vix::orm::ExportOptions;
+  using vix::orm::test::as_int;
+  using vix::orm::test::Call;
+  using vix::orm::test::FakeConnection;
+  using vix::orm::test::Row;
+
+  constexpr std::int64_t min64 = std::numeric_limits<std::int64_t>::min();
+  constexpr std::int64_t max64 = std::numeric_limits<std::int64_t>::max();
+
+  int failures = 0;
+
+  void check(bool ok, const char *what)
+  {
+    if (!ok)
+    {
+      std::fprintf(stderr, "FAILED: %s\n", what);
+      ++failures;
+    }
+  }
+
+  /**
+   * @brief Answer MIN/MAX and keyset queries over a sorted key list.
+   */
+  std::shared_ptr<FakeConnection> table_of(std::vector<std::int64_t> keys)
+  {
+    auto conn = std::make_shared<FakeConnection>();
+    conn->onQuery = [keys](const Call &call)
+    {
+      if (call.sql.find("MIN(") != std::string::npos)
+      {
+        return std::vector<Row>{{std::to_string(keys.front()), std::to_string(keys.back())}};
+      }
+
+      std::size_t index = 0;
+      std::int64_t until = max64;
+      std::optional<std::int64_t> after;
+      if (call.sql.find(" <= ?") != std::string::npos)
+      {
+        until = *as_int(call.binds[index++]);
+      }
+      if (call.sql.find(" > ?") != std::string::npos)
+      {
+        after = as_int(call.binds[index++]);
+      }
+
+      std::vector<Row> rows;
+      for (std::int64_t k : keys)
+      {
+        if ((!after || k > *after) && k <= until)
+        {
+          rows.push_back({std::to_string(k), "k" + std::to_string(k)});
+        }
+      }
+      return rows;
+    };
+    return conn;
+  }
+
+  ExportOptions options()
+  {
+    ExportOptions opt;
+    opt.columns = {{"name"}};
+    return opt;
+  }
+
+  /**
+   * @brief Export into one string per partition; return every partition.
+   */
+  std::vector<std::string> run(const std::shared_ptr<FakeConnection> &conn,
+                               std::size_t partitions,
+                               std::uint64_t &rows)
+  {
+    auto pool = vix::orm::test::fake_pool(conn);
+    std::vector<std::string> out(partitions);
+
+    const auto total = vix::orm::exportPartitioned(
+        pool, "items", partitions,
+        [&](std::size_t i) -> vix::orm::ExportSink
+        { return [&out, i](std::string_view chunk)
+          { out[i].append(chunk); }; },
+        options());
+
+    rows = total.rows;
+    return out;
+  }
+
+  std::size_t occurrences(const std::vector<std::string> &parts, const std::string &needle)
+  {
+    std::size_t n = 0;
+    for (const auto &p : parts)
+    {
+      for (auto at = p.find(needle); at != std::string::npos; at = p.find(needle, at + 1))
+      {
+        ++n;
+      }
+    }
+    return n;
+  }
+} // namespace
+
+int main()
+{
+  const std::vector<std::int64_t> full{min64, min64 + 1, -1, 0, 7, max64 - 1, max64};
+
+  for (std::size_t partitions : {1u, 2u, 3u, 8u})
+  {
+    std::uint64_t rows = 0;
+    const auto parts = run(table_of(full), partitions, rows);
+
+    check(rows == full.size(), "full int64 range: every row exported");
+
+    bool once = true;
+    for (std::int64_t k : full)
+    {
+      once = once && occurrences(parts, "\"k" + std::to_string(k) + "\"") == 1;
+    }
+    check(once, "full int64 range: each key in exactly one partition");
+  }
+
+  {
+    std::uint64_t rows = 0;
+    const auto parts = run(table_of({10, 11, 12}), 8, rows);
+
+    check(rows == 3, "more partitions than keys: every row exported");
+    check(std::count_if(parts.begin(), parts.end(), [](const std::string &p)
+                        { return !p.empty(); }) == 3,
+          "more partitions than keys: one key per used partition");
+  }
+
+  {
+    auto conn = table_of({min64, max64});
+    std::uint64_t rows = 0;
+    (void)run(conn, 1, rows);
+
+    const auto slices = conn->callsWith(" <= ?");
+    check(!slices.empty() && as_int(slices.back().binds[0]) == max64,
+          "single partition runs to MAX(key)");
+    check(rows == 2, "single partition over the full range exports both ends");
+  }
+
+  return failures == 0 ? 0 : 1;
+}
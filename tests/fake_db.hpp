@@ -0,0 +1,296 @@
+/**
+ *
+ *  @file fake_db.hpp
+ *  @author Gaspard Kirira
+ *
+ *  Copyright 2025, Gaspard Kirira.
+ *  All rights reserved.
+ *  https://github.com/vixcpp/vix
+ *
+ *  Use of this source code is governed by a MIT license
+ *  that can be found in the License file.
+ *
+ *  Vix.cpp
+ */
+#ifndef VIX_ORM_TESTS_FAKE_DB_HPP
+#define VIX_ORM_TESTS_FAKE_DB_HPP
+
+#include <vix/orm/db_compat.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief In-memory vix::db connection for behavior tests.
+ *
+ * FakeConnection records every executed statement with its bound
+ * values and answers queries through hooks set by the test, so the
+ * generated SQL and its parameters can be checked without a server.
+ */
+namespace vix::orm::test
+{
+  /**
+   * @brief One result row; std::nullopt is SQL NULL.
+   */
+  using Row = std::vector<std::optional<std::string>>;
+
+  /**
+   * @brief An executed statement, or BEGIN/COMMIT/ROLLBACK.
+   */
+  struct Call
+  {
+    std::string sql;
+    std::vector<vix::db::DbValue> binds;
+  };
+
+  /**
+   * @brief Variant held by a DbValue, whether it is the variant or wraps it.
+   */
+  inline const auto &value_variant(const vix::db::DbValue &value)
+  {
+    if constexpr (requires { value.v; })
+    {
+      return value.v;
+    }
+    else
+    {
+      return value;
+    }
+  }
+
+  /**
+   * @brief Integer held by a bound value, if any.
+   */
+  inline std::optional<std::int64_t> as_int(const vix::db::DbValue &value)
+  {
+    const auto &v = value_variant(value);
+    if (const auto *i = std::get_if<std::int64_t>(&v))
+    {
+      return *i;
+    }
+    return std::nullopt;
+  }
+
+  /**
+   * @brief Text held by a bound value, if any.
+   */
+  inline std::optional<std::string> as_text(const vix::db::DbValue &value)
+  {
+    const auto &v = value_variant(value);
+    if (const auto *s = std::get_if<std::string>(&v))
+    {
+      return *s;
+    }
+    return std::nullopt;
+  }
+
+  /**
+   * @brief Whether a bound value is SQL NULL.
+   */
+  inline bool is_null(const vix::db::DbValue &value)
+  {
+    return std::holds_alternative<std::monostate>(value_variant(value));
+  }
+
+  class FakeRow final : public vix::db::ResultRow
+  {
+  public:
+    Row values;
+
+    bool isNull(std::size_t i) const override
+    {
+      return i >= values.size() || !values[i];
+    }
+
+    std::string getString(std::size_t i) const override
+    {
+      return values.at(i).value();
+    }
+
+    std::int64_t getInt64(std::size_t i) const override
+    {
+      return std::stoll(values.at(i).value());
+    }
+
+    double getDouble(std::size_t i) const override
+    {
+      return std::stod(values.at(i).value());
+    }
+  };
+
+  class FakeResultSet final : public vix::db::ResultSet
+  {
+    std::vector<Row> rows_;
+    std::size_t next_ = 0;
+    FakeRow row_;
+
+  public:
+    explicit FakeResultSet(std::vector<Row> rows)
+        : rows_(std::move(rows))
+    {
+    }
+
+    bool next() override
+    {
+      if (next_ >= rows_.size())
+      {
+        return false;
+      }
+      row_.values = rows_[next_++];
+      return true;
+    }
+
+    std::size_t cols() const override
+    {
+      return row_.values.size();
+    }
+
+    const vix::db::ResultRow &row() const override
+    {
+      return row_;
+    }
+  };
+
+  class FakeConnection final : public vix::db::Connection
+  {
+  public:
+    /**
+     * @brief Rows returned by query(); no rows by default.
+     */
+    std::function<std::vector<Row>(const Call &)> onQuery;
+
+    /**
+     * @brief Affected-row count returned by exec(); 1 by default.
+     */
+    std::function<std::uint64_t(const Call &)> onExec;
+
+    std::uint64_t lastId = 0;
+
+    vix::db::StatementPtr prepare(std::string_view sql) override;
+
+    void begin() override
+    {
+      record(Call{"BEGIN", {}});
+    }
+
+    void commit() override
+    {
+      record(Call{"COMMIT", {}});
+    }
+
+    void rollback() override
+    {
+      record(Call{"ROLLBACK", {}});
+    }
+
+    std::uint64_t lastInsertId() override
+    {
+      return lastId;
+    }
+
+    bool ping() override
+    {
+      return true;
+    }
+
+    /**
+     * @brief Copy of the statements executed so far.
+     */
+    std::vector<Call> calls() const
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      return calls_;
+    }
+
+    /**
+     * @brief Executed statements whose SQL contains @p part.
+     */
+    std::vector<Call> callsWith(std::string_view part) const
+    {
+      std::vector<Call> out;
+      for (Call &call : calls())
+      {
+        if (call.sql.find(part) != std::string::npos)
+        {
+          out.push_back(std::move(call));
+        }
+      }
+      return out;
+    }
+
+    void clear()
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      calls_.clear();
+    }
+
+    void record(Call call)
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      calls_.push_back(std::move(call));
+    }
+
+  private:
+    mutable std::mutex mutex_;
+    std::vector<Call> calls_;
+  };
+
+  class FakeStatement final : public vix::db::Statement
+  {
+    FakeConnection &conn_;
+    Call call_;
+
+  public:
+    FakeStatement(FakeConnection &conn, std::string_view sql)
+        : conn_(conn), call_{std::string(sql), {}}
+    {
+    }
+
+    using vix::db::Statement::bind;
+
+    void bind(std::size_t index, const vix::db::DbValue &value) override
+    {
+      if (call_.binds.size() < index)
+      {
+        call_.binds.resize(index);
+      }
+      call_.binds[index - 1] = value;
+    }
+
+    std::unique_ptr<vix::db::ResultSet> query() override
+    {
+      conn_.record(call_);
+      return std::make_unique<FakeResultSet>(conn_.onQuery ? conn_.onQuery(call_) : std::vector<Row>{});
+    }
+
+    std::uint64_t exec() override
+    {
+      conn_.record(call_);
+      return conn_.onExec ? conn_.onExec(call_) : 1;
+    }
+  };
+
+  inline vix::db::StatementPtr FakeConnection::prepare(std::string_view sql)
+  {
+    return std::make_unique<FakeStatement>(*this, sql);
+  }
+
+  /**
+   * @brief Pool whose every connection is @p conn.
+   */
+  inline vix::db::ConnectionPool fake_pool(const std::shared_ptr<FakeConnection> &conn)
+  {
+    return vix::db::ConnectionPool([conn]
+                                   { return std::static_pointer_cast<vix::db::Connection>(conn); });
+  }
+} // namespace vix::orm::test
+
+#endif // VIX_ORM_TESTS_FAKE_DB_HPP
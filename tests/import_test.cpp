@@ -0,0 +1,195 @@
+/**
+ *
+ *  @file import_test.cpp
+ *  @author Gaspard Kirira
+ *
+ *  Copyright 2025, Gaspard Kirira.
+ *  All rights reserved.
+ *  https://github.com/vixcpp/vix
+ *
+ *  Use of this source code is governed by a MIT license
+ *  that can be found in the License file.
+ *
+ *  Vix.cpp
+ */
+#include <vix/orm/Import.hpp>
+
+#include "fake_db.hpp"
+
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+struct Item
+{
+  std::int64_t id = 0;
+  std::string name;
+};
+
+template <>
+struct vix::orm::Mapper<Item>
+{
+  static Item fromRow(const vix::db::ResultRow &row)
+  {
+    return Item{row.getInt64(0), row.getString(1)};
+  }
+
+  static FieldValues toInsertFields(const Item &item)
+  {
+    return {{"name", item.name}};
+  }
+
+  static FieldValues toUpdateFields(const Item &item)
+  {
+    return {{"name", item.name}};
+  }
+};
+
+namespace
+{
+  using vix::orm::ImportFormat;
+  using vix::orm::ImportOptions;
+  using vix::orm::test::as_text;
+  using vix::orm::test::FakeConnection;
+  using vix::orm::test::is_null;
+
+  using Values = std::vector<std::optional<std::string>>;
+
+  int failures = 0;
+
+  void check(bool ok, const char *what)
+  {
+    if (!ok)
+    {
+      std::fprintf(stderr, "FAILED: %s\n", what);
+      ++failures;
+    }
+  }
+
+  struct Outcome
+  {
+    vix::orm::ImportResult result;
+
+    /// Every inserted value, in bind order.
+    Values values;
+  };
+
+  /**
+   * @brief Import @p content from a temporary file into a fake table.
+   */
+  Outcome run(const std::string &content, ImportOptions<Item> options = {})
+  {
+    static int counter = 0;
+    const auto path = std::filesystem::temp_directory_path() /
+                      ("vix_orm_import_test_" + std::to_string(++counter));
+    {
+      std::ofstream out(path, std::ios::binary);
+      out << content;
+    }
+
+    auto conn = std::make_shared<FakeConnection>();
+    auto pool = vix::orm::test::fake_pool(conn);
+    vix::orm::BaseRepository<Item> repo(pool, "items");
+
+    options.workers = 1;
+
+    Outcome outcome;
+    outcome.result = vix::orm::importFile(repo, path.string(), options);
+    std::filesystem::remove(path);
+
+    for (const auto &call : conn->callsWith("INSERT INTO items"))
+    {
+      for (const auto &v : call.binds)
+      {
+        outcome.values.push_back(is_null(v) ? std::nullopt : as_text(v));
+      }
+    }
+    return outcome;
+  }
+
+  ImportOptions<Item> ndjson()
+  {
+    ImportOptions<Item> opt;
+    opt.format = ImportFormat::NDJSON;
+    return opt;
+  }
+} // namespace
+
+int main()
+{
+  {
+    const auto out = run("id,name\n"
+                         "1,\"a, b\"\n"
+                         "2,\"he said \"\"hi\"\"\"\n"
+                         "3,\"two\nlines\"\n");
+
+    check(out.result.errors.empty(), "csv quoting: no errors");
+    check(out.values == Values{"1", "a, b", "2", "he said \"hi\"", "3", "two\nlines"},
+          "csv quoting: delimiters, escaped quotes and line breaks inside quotes");
+  }
+
+  {
+    // A quote inside an unquoted field is data, not the start of a
+    // quoted section, so the next line is still its own record.
+    const auto out = run("id,name\n"
+                         "1,ab\"c\n"
+                         "2,d\n");
+
+    check(out.result.progress.records == 2, "csv stray quote: records stay split");
+    check(out.values == Values{"1", "ab\"c", "2", "d"}, "csv stray quote: kept as text");
+  }
+
+  {
+    const auto out = run("\xEF\xBB\xBFid,name\r\n"
+                         "1,x\r\n"
+                         "2,\"\"\r\n"
+                         "3,\r\n");
+
+    check(out.result.errors.empty(), "bom and crlf: no errors");
+    check(out.values == Values{"1", "x", "2", "", "3", std::nullopt},
+          "bom and crlf: no stray bytes, quoted empty is text, bare empty is NULL");
+  }
+
+  {
+    const auto out = run("id,name\n"
+                         "1,x\n"
+                         "2,\"open\n");
+
+    check(out.result.progress.failed == 1 && out.result.errors.size() == 1,
+          "csv unterminated quote: record rejected");
+    check(out.values == Values{"1", "x"}, "csv unterminated quote: earlier rows kept");
+  }
+
+  {
+    const auto out = run("{\"id\": 1, \"name\": \"q\\\"b\\\\s\\n\\u00e9\"}\n"
+                         "{\"id\": 2, \"name\": \"\\ud83d\\ude00\"}\n"
+                         "{\"id\": 3, \"name\": null}\n",
+                         ndjson());
+
+    check(out.result.errors.empty(), "ndjson: no errors");
+    check(out.values == Values{"1", "q\"b\\s\n\xC3\xA9", "2", "\xF0\x9F\x98\x80", "3", std::nullopt},
+          "ndjson: escapes, surrogate pairs and null");
+  }
+
+  {
+    std::string content = "id,name\n";
+    for (int i = 1; i <= 5; ++i)
+    {
+      content += std::to_string(i) + ",n" + std::to_string(i) + "\n";
+    }
+
+    ImportOptions<Item> opt;
+    opt.skipRecords = 3;
+    const auto out = run(content, opt);
+
+    check(out.result.progress.records == 2, "skipRecords: only the remaining records are read");
+    check(out.values == Values{"4", "n4", "5", "n5"}, "skipRecords: resumes after the skipped records");
+  }
+
+  return failures == 0 ? 0 : 1;
+}
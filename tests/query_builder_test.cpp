@@ -0,0 +1,174 @@
+/**
+ *
+ *  @file query_builder_test.cpp
+ *  @author Gaspard Kirira
+ *
+ *  Copyright 2025, Gaspard Kirira.
+ *  All rights reserved.
+ *  https://github.com/vixcpp/vix
+ *
+ *  Use of this source code is governed by a MIT license
+ *  that can be found in the License file.
+ *
+ *  Vix.cpp
+ */
+#include <vix/orm/QueryBuilder.hpp>
+
+#include "fake_db.hpp"
+
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace
+{
+  using vix::orm::QueryBuilder;
+  using vix::orm::test::as_int;
+  using vix::orm::test::as_text;
+  using vix::orm::test::FakeConnection;
+  using vix::orm::test::is_null;
+
+  int failures = 0;
+
+  void check(bool ok, const char *what)
+  {
+    if (!ok)
+    {
+      std::fprintf(stderr, "FAILED: %s\n", what);
+      ++failures;
+    }
+  }
+
+  /**
+   * @brief Statement able to bind caller memory, recording what it got.
+   */
+  class DirectStatement final : public vix::db::Statement, public vix::orm::BorrowedBindable
+  {
+  public:
+    std::vector<vix::db::DbValue> owned;
+    std::vector<const void *> borrowed;
+
+    using vix::db::Statement::bind;
+
+    void bind(std::size_t index, const vix::db::DbValue &value) override
+    {
+      slot(index);
+      owned[index - 1] = value;
+    }
+
+    void bindBorrowedText(std::size_t index, std::string_view value) override
+    {
+      slot(index);
+      borrowed[index - 1] = value.data();
+    }
+
+    void bindBorrowedBlob(std::size_t index, std::span<const std::uint8_t> value) override
+    {
+      slot(index);
+      borrowed[index - 1] = value.data();
+    }
+
+    std::unique_ptr<vix::db::ResultSet> query() override
+    {
+      return nullptr;
+    }
+
+    std::uint64_t exec() override
+    {
+      return 0;
+    }
+
+  private:
+    void slot(std::size_t index)
+    {
+      if (owned.size() < index)
+      {
+        owned.resize(index);
+        borrowed.resize(index);
+      }
+    }
+  };
+} // namespace
+
+int main()
+{
+  const std::string payload(4096, 'x');
+  const std::vector<std::uint8_t> bytes{1, 2, 3};
+
+  {
+    QueryBuilder qb("INSERT INTO docs(id, body, data) VALUES(?, ?, ?)");
+    qb.param(std::int64_t{7}).paramRef(payload).paramRef(std::span<const std::uint8_t>(bytes));
+
+    check(qb.hasBorrowedParams(), "paramRef keeps a view");
+    check(qb.paramCount() == 3, "paramCount includes borrowed slots");
+    check(qb.hasBorrowedParams(), "paramCount does not copy borrowed values");
+
+    DirectStatement st;
+    qb.bind(st);
+    check(st.borrowed[1] == payload.data(), "borrowed text bound without a copy");
+    check(st.borrowed[2] == bytes.data(), "borrowed blob bound without a copy");
+    check(as_int(st.owned[0]) == 7, "owned values still bound normally");
+  }
+
+  {
+    auto conn = std::make_shared<FakeConnection>();
+
+    QueryBuilder qb("SELECT id FROM docs WHERE a = ? AND body = ?");
+    qb.param(std::int64_t{1}).paramRef(payload);
+
+    auto st = conn->prepare(qb.sql());
+    qb.bind(*st);
+    st->exec();
+
+    const auto calls = conn->calls();
+    check(calls.size() == 1 && calls[0].binds.size() == 2, "fallback binds every slot");
+    check(as_text(calls[0].binds[1]) == payload, "plain statements receive a copy");
+    check(qb.hasBorrowedParams(), "bind() leaves the builder borrowed");
+  }
+
+  {
+    QueryBuilder where("status = ? AND name = ?");
+    where.param(std::int64_t{2}).paramRef(std::string_view("ann"));
+
+    auto conn = std::make_shared<FakeConnection>();
+    auto st = conn->prepare("UPDATE t SET x = ? WHERE " + where.sql());
+    st->bind(1, vix::db::i64(5));
+    where.bind(*st, 2);
+    st->exec();
+
+    const auto binds = conn->calls().at(0).binds;
+    check(binds.size() == 3 && as_text(binds[2]) == "ann", "borrowed slot honors the first index");
+  }
+
+  {
+    std::string name = "before";
+    QueryBuilder qb("SELECT 1 WHERE name = ?");
+    qb.paramRef(name);
+
+    const auto &params = qb.params();
+    check(!qb.hasBorrowedParams(), "params() copies borrowed values");
+    check(params.size() == 1 && as_text(params[0]) == "before", "params() holds the borrowed value, not NULL");
+
+    name = "after";
+    check(as_text(qb.params()[0]) == "before", "copied params no longer follow caller memory");
+  }
+
+  {
+    QueryBuilder qb("INSERT INTO t VALUES(?, ?)");
+    qb.paramRef(std::span<const std::uint8_t>(bytes)).paramNull();
+
+    auto params = qb.takeParams();
+    check(params.size() == 2 && !is_null(params[0]) && is_null(params[1]),
+          "takeParams() copies borrowed blobs");
+
+    qb.clear();
+    qb.paramRef(payload).clear();
+    check(!qb.hasBorrowedParams() && qb.paramCount() == 0, "clear() drops borrowed slots");
+  }
+
+  return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,1097 @@
+/**
+ *
+ *  @file repository_test.cpp
+ *  @author Gaspard Kirira
+ *
+ *  Copyright 2025, Gaspard Kirira.
+ *  All rights reserved.
+ *  https://github.com/vixcpp/vix
+ *
+ *  Use of this source code is governed by a MIT license
+ *  that can be found in the License file.
+ *
+ *  Vix.cpp
+ */
+#include <vix/orm/Repository.hpp>
+
+#include "fake_db.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <optional>
+#include <set>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+struct User
+{
+  std::int64_t id = 0;
+  std::string name;
+  std::int64_t score = 0;
+};
+
+template <>
+struct vix::orm::Mapper<User>
+{
+  static User fromRow(const vix::db::ResultRow &row)
+  {
+    return User{row.getInt64(0), row.getString(1), row.getInt64(2)};
+  }
+
+  static FieldValues toInsertFields(const User &user)
+  {
+    return {{"name", user.name}, {"score", user.score}};
+  }
+
+  static FieldValues toUpdateFields(const User &user)
+  {
+    return {{"name", user.name}, {"score", user.score}};
+  }
+};
+
+template <>
+struct vix::orm::Column<&User::name>
+{
+  static constexpr std::string_view name = "name";
+};
+
+template <>
+struct vix::orm::Column<&User::score>
+{
+  static constexpr std::string_view name = "score";
+};
+
+struct Tag
+{
+  std::optional<std::int64_t> id;
+  std::string label;
+};
+
+template <>
+struct vix::orm::Mapper<Tag>
+{
+  static Tag fromRow(const vix::db::ResultRow &row)
+  {
+    return Tag{row.getInt64(0), row.getString(1)};
+  }
+
+  static FieldValues toInsertFields(const Tag &tag)
+  {
+    return {{"id", tag.id}, {"label", tag.label}};
+  }
+
+  static FieldValues toUpdateFields(const Tag &tag)
+  {
+    return {{"label", tag.label}};
+  }
+};
+
+struct Doc
+{
+  std::int64_t id = 0;
+  std::string title;
+  std::int64_t revision = 0;
+  std::int64_t views = 0;
+};
+
+template <>
+struct vix::orm::Mapper<Doc>
+{
+  static constexpr std::string_view version_column = "revision";
+
+  static std::int64_t version(const Doc &doc)
+  {
+    return doc.revision;
+  }
+
+  static Doc fromRow(const vix::db::ResultRow &row)
+  {
+    return Doc{row.getInt64(0), row.getString(1), row.getInt64(2), row.getInt64(3)};
+  }
+
+  static FieldValues toInsertFields(const Doc &doc)
+  {
+    return {{"title", doc.title}, {"revision", doc.revision}, {"views", doc.views}};
+  }
+
+  static FieldValues toUpdateFields(const Doc &doc)
+  {
+    return {{"title", doc.title}, {"revision", doc.revision}, {"views", doc.views}};
+  }
+};
+
+template <>
+struct vix::orm::Column<&Doc::title>
+{
+  static constexpr std::string_view name = "title";
+};
+
+template <>
+struct vix::orm::Column<&Doc::revision>
+{
+  static constexpr std::string_view name = "revision";
+};
+
+struct Order
+{
+  std::int64_t id = 0;
+  std::int64_t userId = 0;
+  std::int64_t total = 0;
+};
+
+template <>
+struct vix::orm::Mapper<Order>
+{
+  static Order fromRow(const vix::db::ResultRow &row)
+  {
+    return Order{row.getInt64(0), row.getInt64(1), row.getInt64(2)};
+  }
+
+  static FieldValues toInsertFields(const Order &order)
+  {
+    return {{"user_id", order.userId}, {"total", order.total}};
+  }
+
+  static FieldValues toUpdateFields(const Order &order)
+  {
+    return {{"total", order.total}};
+  }
+};
+
+struct UserSummary
+{
+  std::int64_t id = 0;
+  std::string name;
+};
+
+template <>
+struct vix::orm::Mapper<UserSummary>
+{
+  static constexpr std::array<std::string_view, 2> columns{"id", "name"};
+
+  static UserSummary fromRow(const vix::db::ResultRow &row)
+  {
+    return {row.getInt64(0), row.getString(1)};
+  }
+};
+
+struct BadSummary
+{
+  std::string name;
+};
+
+template <>
+struct vix::orm::Mapper<BadSummary>
+{
+  static constexpr std::array<std::string_view, 1> columns{"name, password"};
+
+  static BadSummary fromRow(const vix::db::ResultRow &row)
+  {
+    return {row.getString(0)};
+  }
+};
+
+namespace
+{
+  using vix::orm::AggregateFn;
+  using vix::orm::BaseRepository;
+  using vix::orm::Dialect;
+  using vix::orm::DialectInfo;
+  using vix::orm::OptimisticLockError;
+  using vix::orm::QueryBuilder;
+  using vix::orm::test::as_int;
+  using vix::orm::test::as_text;
+  using vix::orm::test::Call;
+  using vix::orm::test::FakeConnection;
+  using vix::orm::test::Row;
+
+  int failures = 0;
+
+  void check(bool ok, const char *what)
+  {
+    if (!ok)
+    {
+      std::fprintf(stderr, "FAILED: %s\n", what);
+      ++failures;
+    }
+  }
+
+  template <class Fn>
+  bool throws(Fn &&fn)
+  {
+    try
+    {
+      fn();
+    }
+    catch (const vix::db::DBError &)
+    {
+      return true;
+    }
+    return false;
+  }
+
+  /**
+   * @brief A fake connection and a pool handing it out.
+   */
+  struct Db
+  {
+    std::shared_ptr<FakeConnection> conn = std::make_shared<FakeConnection>();
+    vix::db::ConnectionPool pool = vix::orm::test::fake_pool(conn);
+  };
+
+  /// SQLite with INSERT/UPDATE/DELETE ... RETURNING.
+  const DialectInfo sqlite{Dialect::SQLite, 3, 45};
+
+  /// SQLite before RETURNING.
+  const DialectInfo oldSqlite{Dialect::SQLite, 3, 30};
+
+  /**
+   * @brief Answer "SELECT * ... WHERE id = ?" with the requested id.
+   */
+  std::vector<Row> userById(const Call &call)
+  {
+    if (call.sql.find("WHERE id = ?") == std::string::npos)
+    {
+      return {};
+    }
+    return {{std::to_string(*as_int(call.binds.back())), "stored", "0"}};
+  }
+
+  /**
+   * @brief Generator handing out first, first + 1, ...
+   */
+  class CountingIds final : public vix::orm::IdGenerator
+  {
+  public:
+    explicit CountingIds(std::int64_t first)
+        : next_(first)
+    {
+    }
+
+    std::int64_t next() override
+    {
+      return next_++;
+    }
+
+  private:
+    std::int64_t next_;
+  };
+} // namespace
+
+int main()
+{
+  {
+    Db db;
+    db.conn->onQuery = [](const Call &)
+    {
+      return std::vector<Row>{{"7", "ann", "3"}};
+    };
+
+    BaseRepository<User> users(db.pool, "users");
+    users.setDialect(sqlite);
+
+    const User created = users.createReturning(User{0, "ann", 3});
+    const auto calls = db.conn->calls();
+
+    check(created.id == 7, "createReturning: id read from the returned row");
+    check(calls.size() == 1 && calls[0].sql == "INSERT INTO users (name,score) VALUES (?,?) RETURNING *",
+          "createReturning: a single INSERT ... RETURNING round trip");
+  }
+
+  {
+    Db db;
+    db.conn->lastId = 9;
+    db.conn->onQuery = userById;
+
+    BaseRepository<User> users(db.pool, "users");
+    users.setDialect(oldSqlite);
+
+    const User created = users.createReturning(User{0, "bob", 1});
+    const auto selects = db.conn->callsWith("SELECT * FROM users WHERE id = ?");
+
+    check(created.id == 9, "createReturning without RETURNING: row re-read by lastInsertId");
+    check(selects.size() == 1 && as_int(selects[0].binds[0]) == 9,
+          "createReturning without RETURNING: one SELECT by the inserted id");
+  }
+
+  {
+    Db db;
+    db.conn->onQuery = [](const Call &)
+    {
+      return std::vector<Row>{};
+    };
+
+    BaseRepository<User> users(db.pool, "users");
+    users.setDialect(sqlite);
+
+    check(throws([&]
+                 { (void)users.createReturning(User{0, "ann", 3}); }),
+          "createReturning: an INSERT returning no row throws");
+  }
+
+  {
+    Db db;
+    db.conn->onQuery = [](const Call &call)
+    {
+      return call.sql.find("RETURNING") != std::string::npos
+                 ? std::vector<Row>{{"4", "cid", "8"}}
+                 : std::vector<Row>{};
+    };
+
+    BaseRepository<User> users(db.pool, "users");
+    users.setDialect(sqlite);
+
+    const auto updated = users.updateReturning(4, User{4, "cid", 8});
+    const auto calls = db.conn->calls();
+
+    check(updated && updated->score == 8, "updateReturning: row read from RETURNING");
+    check(calls.size() == 1 && calls[0].sql == "UPDATE users SET name=?,score=? WHERE id=? RETURNING *",
+          "updateReturning: a single UPDATE ... RETURNING round trip");
+    check(calls.size() == 1 && as_int(calls[0].binds[2]) == 4, "updateReturning: id bound after the fields");
+  }
+
+  {
+    Db db;
+    db.conn->onQuery = userById;
+    db.conn->onExec = [](const Call &)
+    {
+      return std::uint64_t{0};
+    };
+
+    BaseRepository<User> users(db.pool, "users");
+    users.setDialect(oldSqlite);
+
+    check(!users.updateReturning(5, User{5, "dan", 2}),
+          "updateReturning without RETURNING: no updated row gives nullopt");
+    check(db.conn->callsWith("SELECT *").empty(), "updateReturning: no re-read when nothing was updated");
+  }
+
+  {
+    Db db;
+    db.conn->lastId = 1;
+
+    BaseRepository<User> users(db.pool, "users");
+    check(throws([&]
+                 { (void)users.nextId(); }),
+          "nextId: throws without a generator");
+
+    users.setIdGenerator(std::make_shared<CountingIds>(100));
+    check(users.nextId() == 100, "nextId: reserves from the generator");
+
+    const auto id = users.create(User{0, "ann", 3});
+    const auto inserts = db.conn->callsWith("INSERT INTO users");
+
+    check(id == 101, "create: returns the generated id, not lastInsertId");
+    check(inserts.size() == 1 && inserts[0].sql == "INSERT INTO users (id,name,score) VALUES (?,?,?)" &&
+              as_int(inserts[0].binds[0]) == 101,
+          "create: generated id inserted as the first column");
+
+    db.conn->clear();
+    const auto ids = users.createMany({User{0, "a", 1}, User{0, "b", 2}});
+    const auto batch = db.conn->callsWith("INSERT INTO users");
+
+    check(ids == std::vector<std::int64_t>{102, 103}, "createMany: returns the generated ids in order");
+    check(batch.size() == 1 && batch[0].binds.size() == 6 && as_int(batch[0].binds[3]) == 103,
+          "createMany: one multi-row INSERT carrying each id");
+
+    db.conn->clear();
+    db.conn->onQuery = userById;
+    users.setDialect(oldSqlite);
+    const User created = users.createReturning(User{0, "c", 4});
+    check(created.id == 104, "createReturning: re-reads the row by the generated id");
+
+    users.setIdGenerator(nullptr);
+    db.conn->clear();
+    check(users.create(User{0, "d", 5}) == 1, "create: lastInsertId once the generator is removed");
+  }
+
+  {
+    Db db;
+    BaseRepository<Tag> tags(db.pool, "tags");
+    tags.setIdGenerator(std::make_shared<CountingIds>(500));
+
+    (void)tags.create(Tag{std::nullopt, "placeholder"});
+    (void)tags.create(Tag{42, "explicit"});
+    const auto inserts = db.conn->callsWith("INSERT INTO tags");
+
+    check(inserts.size() == 2 && inserts[0].sql == "INSERT INTO tags (id,label) VALUES (?,?)" &&
+              as_int(inserts[0].binds[0]) == 500,
+          "generator: a null mapper id is replaced, not duplicated");
+    check(inserts.size() == 2 && as_int(inserts[1].binds[0]) == 42, "generator: an explicit mapper id is kept");
+    check(tags.nextId() == 501, "generator: explicit ids do not consume generated ones");
+  }
+
+  {
+    vix::orm::SnowflakeIdGenerator ids(5);
+
+    std::set<std::int64_t> seen;
+    std::int64_t last = 0;
+    bool ordered = true;
+    for (int i = 0; i < 10000; ++i)
+    {
+      const std::int64_t id = ids.next();
+      ordered = ordered && id > last;
+      last = id;
+      seen.insert(id);
+    }
+
+    check(ordered && seen.size() == 10000, "snowflake: unique, increasing, positive ids");
+    check(((last >> vix::orm::SnowflakeIdGenerator::sequence_bits) &
+           vix::orm::SnowflakeIdGenerator::max_node_id) == 5,
+          "snowflake: node id encoded in the id");
+    check(throws([]
+                 { vix::orm::SnowflakeIdGenerator bad(vix::orm::SnowflakeIdGenerator::max_node_id + 1); }),
+          "snowflake: out-of-range node id throws");
+  }
+
+  {
+    Db db;
+    std::optional<std::int64_t> nextHi;
+
+    db.conn->onExec = [&](const Call &call) -> std::uint64_t
+    {
+      if (call.sql.rfind("UPDATE vix_orm_sequences", 0) == 0)
+      {
+        if (!nextHi)
+        {
+          return 0;
+        }
+        nextHi = std::max(*nextHi, *as_int(call.binds[0])) + 1;
+      }
+      else if (call.sql.rfind("INSERT INTO vix_orm_sequences", 0) == 0)
+      {
+        nextHi = as_int(call.binds[1]);
+      }
+      return 1;
+    };
+    db.conn->onQuery = [&](const Call &)
+    {
+      return std::vector<Row>{{std::to_string(*nextHi)}};
+    };
+
+    vix::orm::HiLoIdGenerator ids(db.pool, "users", 3);
+
+    std::vector<std::int64_t> got;
+    for (int i = 0; i < 4; ++i)
+    {
+      got.push_back(ids.next());
+    }
+    check(got == std::vector<std::int64_t>{1, 2, 3, 4}, "hilo: consecutive ids across blocks");
+    check(db.conn->callsWith("BEGIN").size() == 2, "hilo: one reservation per block");
+
+    ids.ensureAbove(10);
+    check(ids.next() > 10, "hilo: ensureAbove skips past existing ids");
+
+    check(throws([&]
+                 { vix::orm::HiLoIdGenerator bad(db.pool, "users", 0); }),
+          "hilo: zero block size throws");
+  }
+
+  {
+    Db db;
+    BaseRepository<User> users(db.pool, "users");
+
+    (void)users.updateFields(3, {{"name", std::string("eve")}});
+    (void)users.updateFields(4, {{"name", std::string("fay")}});
+    (void)users.updateFields(5, {{"score", std::int64_t{9}}, {"name", std::string("gus")}});
+    (void)users.update(6, vix::orm::set<&User::name>("hal"));
+    const auto calls = db.conn->calls();
+
+    check(calls.size() == 4 && calls[0].sql == "UPDATE users SET name=? WHERE id=?" &&
+              calls[1].sql == calls[0].sql,
+          "updateFields: only the given columns are written");
+    check(calls.size() == 4 && as_text(calls[0].binds[0]) == "eve" && as_int(calls[0].binds[1]) == 3,
+          "updateFields: values then id");
+    check(calls.size() == 4 && calls[2].sql == "UPDATE users SET score=?,name=? WHERE id=?",
+          "updateFields: another column set gets its own statement");
+    check(calls.size() == 4 && calls[3].sql == calls[0].sql && as_text(calls[3].binds[0]) == "hal" &&
+              as_int(calls[3].binds[1]) == 6,
+          "update: typed assignments match the untyped SQL");
+
+    check(throws([&]
+                 { (void)users.updateFields(3, {{"name = name; --", std::string("x")}}); }),
+          "updateFields: invalid column names throw");
+    check(db.conn->calls().size() == 4, "updateFields: nothing is executed for rejected columns");
+  }
+
+  {
+    Db db;
+    BaseRepository<User> users(db.pool, "users");
+
+    (void)users.increment(3, "score", 5);
+    (void)users.increment<&User::score>(4);
+    const auto calls = db.conn->calls();
+
+    check(calls.size() == 2 && calls[0].sql == "UPDATE users SET score = score + ? WHERE id = ?" &&
+              as_int(calls[0].binds[0]) == 5 && as_int(calls[0].binds[1]) == 3,
+          "increment: server-side addition, delta then id");
+    check(calls.size() == 2 && calls[1].sql == calls[0].sql && as_int(calls[1].binds[0]) == 1,
+          "increment: typed column defaults to a delta of 1");
+    check(throws([&]
+                 { (void)users.increment(3, "score) + 1 --", 1); }),
+          "increment: invalid column names throw");
+  }
+
+  {
+    Db db;
+    db.conn->onExec = [](const Call &)
+    {
+      return std::uint64_t{0};
+    };
+    BaseRepository<User> users(db.pool, "users");
+
+    const auto swapped = users.compareAndSet(3, "name", std::string("old"), std::string("new"));
+    (void)users.compareAndSet(3, "name", nullptr, std::string("set"));
+    (void)users.compareAndSet<&User::score>(4, 1, 2);
+    const auto calls = db.conn->calls();
+
+    check(swapped == 0, "compareAndSet: reports a lost race as zero rows");
+    check(calls.size() == 3 && calls[0].sql == "UPDATE users SET name=? WHERE id=? AND name=?" &&
+              as_text(calls[0].binds[0]) == "new" && as_int(calls[0].binds[1]) == 3 &&
+              as_text(calls[0].binds[2]) == "old",
+          "compareAndSet: desired, id, expected");
+    check(calls.size() == 3 && calls[1].sql == "UPDATE users SET name=? WHERE id=? AND name IS NULL" &&
+              calls[1].binds.size() == 2,
+          "compareAndSet: a null expectation compares with IS NULL");
+    check(calls.size() == 3 && calls[2].sql == "UPDATE users SET score=? WHERE id=? AND score=?" &&
+              as_int(calls[2].binds[2]) == 1,
+          "compareAndSet: typed column");
+  }
+
+  {
+    Db db;
+    BaseRepository<User> users(db.pool, "users");
+
+    (void)users.updateIf(3, {{"name", std::string("ivy")}}, 7);
+    (void)users.updateIf(3, {{"name", std::string("ivy")}}, 8, "rev");
+    const auto calls = db.conn->calls();
+
+    check(calls.size() == 2 &&
+              calls[0].sql == "UPDATE users SET name=?,version=version+1 WHERE id=? AND version=?" &&
+              as_int(calls[0].binds[1]) == 3 && as_int(calls[0].binds[2]) == 7,
+          "updateIf: guarded by and bumping the version column");
+    check(calls.size() == 2 && calls[1].sql == "UPDATE users SET name=?,rev=rev+1 WHERE id=? AND rev=?",
+          "updateIf: custom version column");
+    check(throws([&]
+                 { (void)users.updateIf(3, {{"version", std::int64_t{1}}}, 7); }),
+          "updateIf: assigning the version column throws");
+    check(throws([&]
+                 { (void)users.updateIf(3, {{"name", std::string("x")}}, 7, "rev = 0 --"); }),
+          "updateIf: invalid version column throws");
+  }
+
+  {
+    Db db;
+    BaseRepository<Doc> docs(db.pool, "docs");
+
+    const auto updated = docs.updateById(4, Doc{4, "draft", 3, 10});
+    const auto calls = db.conn->calls();
+
+    check(updated == 1, "versioned updateById: reports the updated row");
+    check(calls.size() == 1 &&
+              calls[0].sql == "UPDATE docs SET title=?,views=?,revision=revision+1 WHERE id=? AND revision=?",
+          "versioned updateById: bumps and checks the version, never assigns it");
+    check(calls.size() == 1 && calls[0].binds.size() == 4 && as_int(calls[0].binds[2]) == 4 &&
+              as_int(calls[0].binds[3]) == 3,
+          "versioned updateById: id then expected version");
+  }
+
+  {
+    Db db;
+    db.conn->onExec = [](const Call &)
+    {
+      return std::uint64_t{0};
+    };
+    db.conn->onQuery = [](const Call &call)
+    {
+      return call.sql == "SELECT id FROM docs WHERE id = ? LIMIT 1" ? std::vector<Row>{{"4"}}
+                                                                     : std::vector<Row>{};
+    };
+    BaseRepository<Doc> docs(db.pool, "docs");
+
+    bool conflict = false;
+    try
+    {
+      (void)docs.updateById(4, Doc{4, "draft", 3, 10});
+    }
+    catch (const OptimisticLockError &e)
+    {
+      conflict = e.table() == "docs" && e.id() == 4 && e.expectedVersion() == 3;
+    }
+    check(conflict, "updateById: stale version on an existing row throws OptimisticLockError");
+
+    docs.setDialect(sqlite);
+    bool returningConflict = false;
+    try
+    {
+      (void)docs.updateReturning(4, Doc{4, "draft", 3, 10});
+    }
+    catch (const OptimisticLockError &)
+    {
+      returningConflict = true;
+    }
+    check(returningConflict, "updateReturning: stale version throws OptimisticLockError");
+
+    docs.setDialect(oldSqlite);
+    returningConflict = false;
+    try
+    {
+      (void)docs.updateReturning(4, Doc{4, "draft", 3, 10});
+    }
+    catch (const OptimisticLockError &)
+    {
+      returningConflict = true;
+    }
+    check(returningConflict, "updateReturning without RETURNING: stale version throws OptimisticLockError");
+  }
+
+  {
+    Db db;
+    db.conn->onExec = [](const Call &)
+    {
+      return std::uint64_t{0};
+    };
+    BaseRepository<Doc> docs(db.pool, "docs");
+
+    bool threw = false;
+    std::uint64_t updated = 1;
+    try
+    {
+      updated = docs.updateById(4, Doc{4, "draft", 3, 10});
+    }
+    catch (const vix::db::DBError &)
+    {
+      threw = true;
+    }
+    check(!threw && updated == 0, "updateById: a missing row is not a conflict");
+    check(db.conn->callsWith("SELECT id FROM docs").size() == 1, "updateById: conflict check reads the row once");
+  }
+
+  {
+    Db db;
+    BaseRepository<Doc> docs(db.pool, "docs");
+
+    QueryBuilder stale("views > ?");
+    stale.param(std::int64_t{100});
+
+    (void)docs.updateFields(4, {{"title", std::string("a")}});
+    (void)docs.update(4, vix::orm::set<&Doc::title>("b"));
+    (void)docs.increment(4, "views", 2);
+    (void)docs.compareAndSet<&Doc::title>(4, "b", "c");
+    (void)docs.updateWhere(stale, {{"title", std::string("d")}});
+    (void)docs.updateIf(4, {{"title", std::string("e")}}, 3);
+    const auto calls = db.conn->calls();
+
+    check(calls.size() == 6 && calls[0].sql == "UPDATE docs SET title=?,revision=revision+1 WHERE id=?" &&
+              calls[1].sql == calls[0].sql,
+          "updateFields and update: bump the version");
+    check(calls.size() == 6 &&
+              calls[2].sql == "UPDATE docs SET views = views + ?,revision=revision+1 WHERE id = ?",
+          "increment: bumps the version");
+    check(calls.size() == 6 &&
+              calls[3].sql == "UPDATE docs SET title=?,revision=revision+1 WHERE id=? AND title=?",
+          "compareAndSet: bumps the version");
+    check(calls.size() == 6 && calls[4].sql == "UPDATE docs SET title=?,revision=revision+1 WHERE views > ?" &&
+              as_int(calls[4].binds[1]) == 100,
+          "updateWhere: bumps the version");
+    check(calls.size() == 6 &&
+              calls[5].sql == "UPDATE docs SET title=?,revision=revision+1 WHERE id=? AND revision=?",
+          "updateIf: defaults to the mapper's version column");
+
+    db.conn->clear();
+    check(throws([&]
+                 { (void)docs.updateFields(4, {{"revision", std::int64_t{1}}}); }),
+          "updateFields: version column rejected");
+    check(throws([&]
+                 { (void)docs.update(4, vix::orm::set<&Doc::revision>(1)); }),
+          "update: version column rejected");
+    check(throws([&]
+                 { (void)docs.increment(4, "revision", 1); }),
+          "increment: version column rejected");
+    check(throws([&]
+                 { (void)docs.compareAndSet<&Doc::revision>(4, 1, 2); }),
+          "compareAndSet: version column rejected");
+    check(throws([&]
+                 { (void)docs.updateWhere(stale, {{"revision", std::int64_t{1}}}); }),
+          "updateWhere: version column rejected");
+    check(throws([&]
+                 { (void)docs.updateIf(4, {{"revision", std::int64_t{1}}}, 3); }),
+          "updateIf: version column rejected");
+    check(throws([&]
+                 { (void)docs.updateIf(4, {{"title", std::string("x")}}, 3, "version"); }),
+          "updateIf: a column other than the mapper's throws");
+    check(db.conn->calls().empty(), "rejected version writes execute nothing");
+  }
+
+  {
+    Db db;
+    db.conn->onExec = [](const Call &)
+    {
+      return std::uint64_t{3};
+    };
+    BaseRepository<User> users(db.pool, "users");
+    users.setDialect(sqlite);
+
+    QueryBuilder low("score < ? AND name = ?");
+    low.param(std::int64_t{5}).param(std::string("x"));
+
+    const auto updated = users.updateWhere(low, {{"score", std::int64_t{0}}});
+    (void)users.updateWhere(low, {{"score", std::int64_t{0}}}, 10);
+    const auto removed = users.removeWhere(low);
+    (void)users.removeWhere(low, 10);
+    const auto calls = db.conn->calls();
+
+    check(updated == 3 && removed == 3, "updateWhere/removeWhere: return the affected row count");
+    check(calls.size() == 4 && calls[0].sql == "UPDATE users SET score=? WHERE score < ? AND name = ?" &&
+              as_int(calls[0].binds[0]) == 0 && as_int(calls[0].binds[1]) == 5 &&
+              as_text(calls[0].binds[2]) == "x",
+          "updateWhere: one statement, values before predicate parameters");
+    check(calls.size() == 4 &&
+              calls[1].sql == "UPDATE users SET score=? WHERE id IN "
+                              "(SELECT id FROM users WHERE score < ? AND name = ? LIMIT 10)",
+          "updateWhere: limit through a key subquery outside MySQL");
+    check(calls.size() == 4 && calls[2].sql == "DELETE FROM users WHERE score < ? AND name = ?" &&
+              calls[2].binds.size() == 2 && as_int(calls[2].binds[0]) == 5,
+          "removeWhere: one statement with the predicate parameters");
+    check(calls.size() == 4 &&
+              calls[3].sql == "DELETE FROM users WHERE id IN "
+                              "(SELECT id FROM users WHERE score < ? AND name = ? LIMIT 10)",
+          "removeWhere: limit through a key subquery outside MySQL");
+  }
+
+  {
+    Db db;
+    BaseRepository<User> users(db.pool, "users");
+    users.setDialect(DialectInfo{Dialect::MySQL, 8, 0});
+
+    QueryBuilder low("score < ?");
+    low.param(std::int64_t{5});
+
+    (void)users.updateWhere(low, {{"score", std::int64_t{0}}}, 10);
+    (void)users.removeWhere(low, 10);
+    const auto calls = db.conn->calls();
+
+    check(calls.size() == 2 && calls[0].sql == "UPDATE users SET score=? WHERE score < ? LIMIT 10" &&
+              calls[1].sql == "DELETE FROM users WHERE score < ? LIMIT 10",
+          "updateWhere/removeWhere: MySQL limits the statement directly");
+
+    db.conn->clear();
+    check(throws([&]
+                 { (void)users.updateWhere(QueryBuilder{}, {{"score", std::int64_t{0}}}); }),
+          "updateWhere: empty predicate throws");
+    check(throws([&]
+                 { (void)users.removeWhere(QueryBuilder{}); }),
+          "removeWhere: empty predicate throws");
+    check(db.conn->calls().empty(), "empty predicates execute nothing");
+  }
+
+  {
+    Db db;
+    db.conn->onQuery = [](const Call &call)
+    {
+      if (call.sql.find("GROUP BY") != std::string::npos)
+      {
+        return std::vector<Row>{{"ann", "2"}, {std::nullopt, "1"}, {"bob", "3"}};
+      }
+      if (call.sql.find("AVG(") != std::string::npos)
+      {
+        return std::vector<Row>{{std::nullopt}};
+      }
+      return std::vector<Row>{{"42"}};
+    };
+    BaseRepository<User> users(db.pool, "users");
+
+    QueryBuilder named("name = ?");
+    named.param(std::string("ann"));
+
+    check(users.sum<&User::score>(named) == 42, "sum: value read from the single row");
+    check(users.countWhere(named) == 42, "countWhere: value read from the single row");
+    check(users.aggregate(AggregateFn::Max, "score") == 42.0, "aggregate: value read as double");
+    check(!users.avg<&User::score>(), "avg: NULL aggregate gives nullopt");
+
+    const auto counts = users.countBy<&User::name>();
+    const auto sums = users.sumBy<&User::name, &User::score>(named);
+
+    using Counts = std::vector<std::pair<std::string, std::uint64_t>>;
+    check(counts == Counts{{"ann", 2}, {"bob", 3}}, "countBy: NULL keys skipped for non-optional members");
+    check(sums.size() == 2 && sums[1].first == "bob" && sums[1].second == 3, "sumBy: one entry per group");
+
+    const auto calls = db.conn->calls();
+    check(calls.size() == 6 && calls[0].sql == "SELECT SUM(score) FROM users WHERE name = ?" &&
+              as_text(calls[0].binds[0]) == "ann",
+          "sum: pushed down with the predicate");
+    check(calls.size() == 6 && calls[1].sql == "SELECT COUNT(*) FROM users WHERE name = ?",
+          "countWhere: pushed down with the predicate");
+    check(calls.size() == 6 && calls[2].sql == "SELECT MAX(score) FROM users" &&
+              calls[3].sql == "SELECT AVG(score) FROM users",
+          "aggregate and avg: no WHERE without a predicate");
+    check(calls.size() == 6 && calls[4].sql == "SELECT name, COUNT(*) FROM users GROUP BY name ORDER BY name",
+          "countBy: grouped and ordered by the key");
+    check(calls.size() == 6 &&
+              calls[5].sql == "SELECT name, SUM(score) FROM users WHERE name = ? GROUP BY name ORDER BY name",
+          "sumBy: predicate before GROUP BY");
+
+    check(throws([&]
+                 { (void)users.aggregate(AggregateFn::Sum, "score) FROM users; --"); }),
+          "aggregate: invalid column names throw");
+  }
+
+  {
+    Db db;
+    BaseRepository<User> users(db.pool, "users");
+    check(users.sum<&User::score>() == 0 && users.countWhere(QueryBuilder{}) == 0,
+          "sum and countWhere: zero when no row comes back");
+  }
+
+  {
+    Db db;
+    bool analyzed = true;
+    db.conn->onQuery = [&](const Call &call)
+    {
+      if (call.sql.find("sqlite_stat1") != std::string::npos)
+      {
+        if (!analyzed)
+        {
+          throw vix::db::DBError("no such table: sqlite_stat1");
+        }
+        return std::vector<Row>{{"80 2"}, {"120 1"}, {"bad"}, {std::nullopt}};
+      }
+      return std::vector<Row>{{"50"}};
+    };
+    BaseRepository<User> users(db.pool, "users");
+    users.setDialect(sqlite);
+
+    check(users.estimateCount() == 120, "estimateCount: largest valid sqlite_stat1 figure");
+    const auto stats = db.conn->callsWith("sqlite_stat1");
+    check(stats.size() == 1 && stats[0].sql == "SELECT stat FROM sqlite_stat1 WHERE tbl = ?" &&
+              as_text(stats[0].binds[0]) == "users",
+          "estimateCount: statistics looked up by table name");
+    check(db.conn->callsWith("COUNT(*)").empty(), "estimateCount: no COUNT(*) when statistics exist");
+
+    analyzed = false;
+    check(users.estimateCount() == 50, "estimateCount: falls back to COUNT(*) before ANALYZE");
+  }
+
+  {
+    Db db;
+    db.conn->onQuery = [](const Call &call)
+    {
+      return call.sql.find("information_schema") != std::string::npos ? std::vector<Row>{{"77"}}
+                                                                        : std::vector<Row>{};
+    };
+
+    BaseRepository<User> users(db.pool, "users");
+    users.setDialect(DialectInfo{Dialect::MySQL, 8, 0});
+    BaseRepository<User> qualified(db.pool, "app.users");
+    qualified.setDialect(DialectInfo{Dialect::MySQL, 8, 0});
+
+    check(users.estimateCount() == 77 && qualified.estimateCount() == 77,
+          "estimateCount: MySQL TABLE_ROWS");
+
+    const auto calls = db.conn->callsWith("information_schema");
+    check(calls.size() == 2 &&
+              calls[0].sql == "SELECT TABLE_ROWS FROM information_schema.TABLES "
+                              "WHERE TABLE_SCHEMA = DATABASE() AND TABLE_NAME = ?" &&
+              as_text(calls[0].binds[0]) == "users",
+          "estimateCount: unqualified tables use the current schema");
+    check(calls.size() == 2 && calls[1].binds.size() == 2 && as_text(calls[1].binds[0]) == "app" &&
+              as_text(calls[1].binds[1]) == "users",
+          "estimateCount: qualified tables bind schema and name");
+  }
+
+  {
+    Db db;
+    db.conn->onQuery = [](const Call &call)
+    {
+      return call.sql == "SELECT COUNT(*) FROM users" ? std::vector<Row>{{"50"}} : std::vector<Row>{};
+    };
+    db.conn->onExec = [](const Call &call)
+    {
+      return call.sql.rfind("DELETE", 0) == 0 ? std::uint64_t{3} : std::uint64_t{1};
+    };
+    BaseRepository<User> users(db.pool, "users");
+    users.setDialect(DialectInfo{});
+    users.trackCount();
+
+    const auto counts = [&]
+    {
+      return db.conn->callsWith("COUNT(*)").size();
+    };
+
+    check(users.cachedCount() == 50 && counts() == 1, "cachedCount: first call reconciles");
+
+    (void)users.create(User{0, "new", 0});
+    (void)users.createMany({User{0, "a", 0}, User{0, "b", 0}});
+    check(users.cachedCount() == 53 && counts() == 1, "cachedCount: creates adjust the tracked count");
+
+    (void)users.removeById(1);
+    check(users.cachedCount() == 50 && counts() == 1, "cachedCount: removes subtract the affected rows");
+    check(users.estimateCount() == 50 && counts() == 1, "estimateCount: tracked count without statistics");
+
+    users.untrackCount();
+    check(users.cachedCount() == 50 && counts() == 2, "untrackCount: back to COUNT(*)");
+
+    users.trackCount(std::chrono::seconds(0));
+    (void)users.cachedCount();
+    (void)users.cachedCount();
+    check(counts() == 4, "trackCount: an expired count is reconciled");
+  }
+
+  {
+    Db db;
+    BaseRepository<Order> orders(db.pool, "orders");
+    orders.addCounterCache({"users", "user_id", "orders_count"});
+
+    (void)orders.create(Order{0, 7, 10});
+    auto calls = db.conn->calls();
+
+    check(calls.size() == 4 && calls[0].sql == "BEGIN" &&
+              calls[1].sql == "INSERT INTO orders (user_id,total) VALUES (?,?)" &&
+              calls[2].sql == "UPDATE users SET orders_count = orders_count + ? WHERE id = ?" &&
+              calls[3].sql == "COMMIT",
+          "counter cache: create increments the parent in the same transaction");
+    check(calls.size() == 4 && as_int(calls[2].binds[0]) == 1 && as_int(calls[2].binds[1]) == 7,
+          "counter cache: delta then parent key");
+
+    db.conn->clear();
+    (void)orders.createMany({Order{0, 8, 1}, Order{0, 7, 2}, Order{0, 8, 3}});
+    const auto bumps = db.conn->callsWith("UPDATE users");
+
+    check(bumps.size() == 2 && as_int(bumps[0].binds[1]) == 7 && as_int(bumps[0].binds[0]) == 1 &&
+              as_int(bumps[1].binds[1]) == 8 && as_int(bumps[1].binds[0]) == 2,
+          "counter cache: createMany issues one update per parent, in key order");
+
+    orders.clearCounterCaches();
+    db.conn->clear();
+    (void)orders.create(Order{0, 7, 10});
+    check(db.conn->callsWith("BEGIN").empty() && db.conn->callsWith("UPDATE users").empty(),
+          "counter cache: cleared caches leave plain writes");
+
+    check(throws([&]
+                 { orders.addCounterCache({"users", "user_id", "orders_count = 0 --"}); }),
+          "counter cache: invalid identifiers throw");
+  }
+
+  {
+    Db db;
+    db.conn->onQuery = [](const Call &call)
+    {
+      if (call.sql == "SELECT id FROM orders WHERE id = ?")
+      {
+        return std::vector<Row>{{"3"}};
+      }
+      if (call.sql == "DELETE FROM orders WHERE id IN (?) RETURNING user_id")
+      {
+        return std::vector<Row>{{"7"}};
+      }
+      return std::vector<Row>{};
+    };
+    BaseRepository<Order> orders(db.pool, "orders");
+    orders.setDialect(sqlite);
+    orders.addCounterCache({"users", "user_id", "orders_count"});
+
+    const auto removed = orders.removeById(3);
+    const auto bumps = db.conn->callsWith("UPDATE users");
+
+    check(removed == 1, "counter cache: removeById reports the RETURNING rows");
+    check(bumps.size() == 1 && as_int(bumps[0].binds[0]) == -1 && as_int(bumps[0].binds[1]) == 7,
+          "counter cache: parents decremented from DELETE ... RETURNING");
+  }
+
+  {
+    Db db;
+    std::uint64_t deleted = 0;
+    db.conn->onQuery = [](const Call &call)
+    {
+      return call.sql == "SELECT id, user_id FROM orders WHERE id = ?" ? std::vector<Row>{{"3", "7"}}
+                                                                       : std::vector<Row>{};
+    };
+    db.conn->onExec = [&](const Call &call)
+    {
+      return call.sql.rfind("DELETE", 0) == 0 ? deleted : std::uint64_t{1};
+    };
+    BaseRepository<Order> orders(db.pool, "orders");
+    orders.setDialect(oldSqlite);
+    orders.addCounterCache({"users", "user_id", "orders_count"});
+
+    check(orders.removeById(3) == 0 && db.conn->callsWith("UPDATE users").empty(),
+          "counter cache: a row deleted concurrently is not counted");
+
+    deleted = 1;
+    db.conn->clear();
+    const auto removed = orders.removeById(3);
+    const auto bumps = db.conn->callsWith("UPDATE users");
+
+    check(removed == 1 && db.conn->callsWith("DELETE FROM orders WHERE id = ?").size() == 1,
+          "counter cache: rows deleted one by one without RETURNING");
+    check(bumps.size() == 1 && as_int(bumps[0].binds[0]) == -1, "counter cache: deleted row decrements");
+  }
+
+  {
+    Db db;
+    db.conn->onQuery = [](const Call &call)
+    {
+      return call.sql == "SELECT id, user_id FROM orders WHERE total < ? FOR UPDATE"
+                 ? std::vector<Row>{{"3", "7"}, {"4", std::nullopt}, {"5", "7"}}
+                 : std::vector<Row>{};
+    };
+    db.conn->onExec = [](const Call &call)
+    {
+      return call.sql.rfind("DELETE", 0) == 0 ? std::uint64_t{3} : std::uint64_t{1};
+    };
+    BaseRepository<Order> orders(db.pool, "orders");
+    orders.setDialect(DialectInfo{Dialect::MySQL, 8, 0});
+    orders.addCounterCache({"users", "user_id", "orders_count"});
+
+    QueryBuilder small("total < ?");
+    small.param(std::int64_t{5});
+
+    const auto removed = orders.removeWhere(small);
+    const auto deletes = db.conn->callsWith("DELETE FROM orders");
+    const auto bumps = db.conn->callsWith("UPDATE users");
+
+    check(removed == 3 && deletes.size() == 1 && deletes[0].sql == "DELETE FROM orders WHERE id IN (?,?,?)",
+          "counter cache: MySQL locks the rows and deletes them by id");
+    check(bumps.size() == 1 && as_int(bumps[0].binds[0]) == -2 && as_int(bumps[0].binds[1]) == 7,
+          "counter cache: NULL foreign keys are not counted");
+  }
+
+  {
+    Db db;
+    db.conn->onQuery = [](const Call &call)
+    {
+      if (call.sql.find("WHERE id = ?") != std::string::npos)
+      {
+        return *as_int(call.binds[0]) == 1 ? std::vector<Row>{{"1", "ann"}} : std::vector<Row>{};
+      }
+      return std::vector<Row>{{"1", "ann"}, {"2", "bob"}};
+    };
+    BaseRepository<User> users(db.pool, "users");
+
+    const auto one = users.findByIdAs<UserSummary>(1);
+    const auto none = users.findByIdAs<UserSummary>(2);
+    const auto all = users.findAllAs<UserSummary>();
+    const auto calls = db.conn->calls();
+
+    check(one && one->name == "ann" && !none, "findByIdAs: maps the row or returns nullopt");
+    check(all.size() == 2 && all[1].id == 2 && all[1].name == "bob", "findAllAs: one DTO per row");
+    check(calls.size() == 3 && calls[0].sql == "SELECT id, name FROM users WHERE id = ? LIMIT 1",
+          "findByIdAs: selects only the projected columns");
+    check(calls.size() == 3 && calls[2].sql == "SELECT id, name FROM users",
+          "findAllAs: selects only the projected columns");
+
+    db.conn->clear();
+    check(throws([&]
+                 { (void)users.findAllAs<BadSummary>(); }),
+          "projection: invalid column names throw");
+    check(db.conn->calls().empty(), "projection: nothing runs for an invalid column list");
+  }
+
+  return failures == 0 ? 0 : 1;
+}
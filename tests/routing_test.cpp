@@ -0,0 +1,300 @@
+/**
+ *
+ *  @file routing_test.cpp
+ *  @author Gaspard Kirira
+ *
+ *  Copyright 2025, Gaspard Kirira.
+ *  All rights reserved.
+ *  https://github.com/vixcpp/vix
+ *
+ *  Use of this source code is governed by a MIT license
+ *  that can be found in the License file.
+ *
+ *  Vix.cpp
+ */
+#include <vix/orm/RoutedRepository.hpp>
+
+#include "fake_db.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct Item
+{
+  std::int64_t id = 0;
+  std::string source;
+};
+
+template <>
+struct vix::orm::Mapper<Item>
+{
+  static Item fromRow(const vix::db::ResultRow &row)
+  {
+    return Item{row.getInt64(0), row.getString(1)};
+  }
+
+  static FieldValues toInsertFields(const Item &item)
+  {
+    return {{"source", item.source}};
+  }
+
+  static FieldValues toUpdateFields(const Item &item)
+  {
+    return {{"source", item.source}};
+  }
+};
+
+namespace
+{
+  using namespace std::chrono_literals;
+
+  using vix::orm::ConsistencyToken;
+  using vix::orm::HedgingPolicy;
+  using vix::orm::RoutedRepository;
+  using vix::orm::RoutingOptions;
+  using vix::orm::test::Call;
+  using vix::orm::test::FakeConnection;
+  using vix::orm::test::Row;
+
+  int failures = 0;
+
+  void check(bool ok, const char *what)
+  {
+    if (!ok)
+    {
+      std::fprintf(stderr, "FAILED: %s\n", what);
+      ++failures;
+    }
+  }
+
+  /**
+   * @brief Connection answering every query with a row naming @p source.
+   */
+  std::shared_ptr<FakeConnection> server(std::string source,
+                                         std::chrono::milliseconds latency = 0ms,
+                                         bool broken = false)
+  {
+    auto conn = std::make_shared<FakeConnection>();
+    conn->onQuery = [source, latency, broken](const Call &)
+    {
+      std::this_thread::sleep_for(latency);
+      if (broken)
+      {
+        throw vix::db::DBError(source + " is down");
+      }
+      return std::vector<Row>{{"1", source}};
+    };
+    return conn;
+  }
+
+  /**
+   * @brief A primary and replicas, each with its own fake pool.
+   */
+  struct Cluster
+  {
+    vix::db::ConnectionPool primary;
+    std::vector<std::unique_ptr<vix::db::ConnectionPool>> replicas;
+
+    explicit Cluster(std::vector<std::shared_ptr<FakeConnection>> conns)
+        : primary(vix::orm::test::fake_pool(server("primary")))
+    {
+      for (const auto &c : conns)
+      {
+        replicas.push_back(std::make_unique<vix::db::ConnectionPool>(vix::orm::test::fake_pool(c)));
+      }
+    }
+
+    std::vector<vix::db::ConnectionPool *> pools()
+    {
+      std::vector<vix::db::ConnectionPool *> out;
+      for (auto &p : replicas)
+      {
+        out.push_back(p.get());
+      }
+      return out;
+    }
+  };
+
+  std::string source(RoutedRepository<Item> &repo, const ConsistencyToken *token = nullptr)
+  {
+    const auto item = repo.findById(1, token);
+    return item ? item->source : std::string();
+  }
+
+  RoutingOptions hedged(HedgingPolicy policy)
+  {
+    RoutingOptions opt;
+    opt.hedging = policy;
+    return opt;
+  }
+
+  /**
+   * @brief Retry trySubmit until a worker has started and is idle.
+   */
+  bool submitWhenIdle(vix::orm::detail::HedgeExecutor &executor, std::function<void()> task)
+  {
+    const auto deadline = std::chrono::steady_clock::now() + 5s;
+    while (std::chrono::steady_clock::now() < deadline)
+    {
+      if (executor.trySubmit(task))
+      {
+        return true;
+      }
+      std::this_thread::sleep_for(1ms);
+    }
+    return false;
+  }
+} // namespace
+
+int main()
+{
+  {
+    vix::orm::detail::HedgeExecutor executor(1);
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool release = false;
+
+    const bool started = submitWhenIdle(executor, [&]
+                                        {
+                                          std::unique_lock<std::mutex> lock(mutex);
+                                          cv.wait(lock, [&] { return release; }); });
+    check(started, "executor: idle worker accepts a task");
+    check(!executor.trySubmit([] {}), "executor: busy workers refuse work instead of queueing");
+
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      release = true;
+    }
+    cv.notify_all();
+    check(submitWhenIdle(executor, [] {}), "executor: worker accepts again once idle");
+  }
+
+  {
+    Cluster cluster({server("r0"), server("r1")});
+    RoutedRepository<Item> repo(cluster.primary, cluster.pools(), "items");
+
+    check(source(repo) == "r0" && source(repo) == "r1", "reads rotate across replicas");
+
+    ConsistencyToken session;
+    repo.removeById(1, &session);
+    check(session.pinned(), "writes pin the token");
+    check(source(repo, &session) == "primary", "pinned token reads from the primary");
+    check(source(repo) != "primary", "other sessions still read replicas");
+
+    session.reset();
+    check(source(repo, &session) != "primary", "reset token reads replicas again");
+  }
+
+  {
+    Cluster cluster({server("r0", 0ms, true)});
+    RoutedRepository<Item> repo(cluster.primary, cluster.pools(), "items");
+    check(source(repo) == "primary", "failed replica read falls back to the primary");
+
+    RoutingOptions strict;
+    strict.fallbackToPrimary = false;
+    RoutedRepository<Item> noFallback(cluster.primary, cluster.pools(), "items", strict);
+
+    bool threw = false;
+    try
+    {
+      (void)source(noFallback);
+    }
+    catch (const vix::db::DBError &)
+    {
+      threw = true;
+    }
+    check(threw, "without fallback the replica error propagates");
+  }
+
+  {
+    HedgingPolicy policy;
+    policy.warmupSamples = 5;
+    policy.minDelay = 1000us;
+    policy.maxDelay = 1000us;
+
+    Cluster cluster({server("r0"), server("r1")});
+    RoutedRepository<Item> repo(cluster.primary, cluster.pools(), "items", hedged(policy));
+
+    for (int i = 0; i < 4; ++i)
+    {
+      (void)source(repo);
+    }
+    check(repo.hedgeStats().delay.count() == 0, "warmup: no hedge delay before enough samples");
+
+    (void)source(repo);
+    check(repo.hedgeStats().delay == 1000us, "warmup: delay set from the observed percentile");
+    check(repo.hedgeStats().reads == 5 && repo.hedgeStats().hedged == 0, "warmup: reads are not hedged");
+  }
+
+  {
+    HedgingPolicy policy;
+    policy.warmupSamples = 1;
+    policy.minDelay = 1000us;
+    policy.maxDelay = 1000us;
+    policy.budget = 1.0;
+
+    Cluster cluster({server("slow", 100ms), server("fast")});
+    RoutedRepository<Item> repo(cluster.primary, cluster.pools(), "items", hedged(policy));
+
+    bool correct = true;
+    for (int i = 0; i < 6; ++i)
+    {
+      const std::string s = source(repo);
+      correct = correct && (s == "slow" || s == "fast");
+    }
+    check(correct, "hedging: every read returns a replica row");
+    check(repo.hedgeStats().hedged >= 1, "hedging: slow replica reads are hedged");
+    check(repo.hedgeStats().hedgeWins >= 1, "hedging: the fast replica wins the race");
+
+    ConsistencyToken session;
+    session.pin(10s);
+    const auto before = repo.hedgeStats().reads;
+    check(source(repo, &session) == "primary", "hedging: pinned token reads from the primary");
+    check(repo.hedgeStats().reads == before, "hedging: pinned reads bypass the hedge path");
+  }
+
+  {
+    HedgingPolicy policy;
+    policy.warmupSamples = 1;
+    policy.minDelay = 1000us;
+    policy.maxDelay = 1000us;
+    policy.budget = 0.0;
+
+    Cluster cluster({server("slow", 20ms), server("fast")});
+    RoutedRepository<Item> repo(cluster.primary, cluster.pools(), "items", hedged(policy));
+
+    for (int i = 0; i < 6; ++i)
+    {
+      (void)source(repo);
+    }
+    check(repo.hedgeStats().hedged == 0, "budget: no hedges without budget");
+  }
+
+  {
+    HedgingPolicy policy;
+    policy.warmupSamples = 1;
+    policy.minDelay = 1000us;
+    policy.maxDelay = 1000us;
+    policy.budget = 1.0;
+    policy.workers = 1;
+
+    Cluster cluster({server("slow", 20ms), server("slow", 20ms)});
+    RoutedRepository<Item> repo(cluster.primary, cluster.pools(), "items", hedged(policy));
+
+    for (int i = 0; i < 6; ++i)
+    {
+      (void)source(repo);
+    }
+    check(repo.hedgeStats().hedged == 0, "budget: no hedge is counted when no worker is idle");
+  }
+
+  return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,189 @@
+/**
+ *
+ *  @file sharding_test.cpp
+ *  @author Gaspard Kirira
+ *
+ *  Copyright 2025, Gaspard Kirira.
+ *  All rights reserved.
+ *  https://github.com/vixcpp/vix
+ *
+ *  Use of this source code is governed by a MIT license
+ *  that can be found in the License file.
+ *
+ *  Vix.cpp
+ */
+#include <vix/orm/ShardedRepository.hpp>
+
+#include <cstdint>
+#include <cstdio>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace
+{
+  using vix::orm::FieldValues;
+  using vix::orm::ShardingOptions;
+  using vix::orm::ShardRouter;
+  using vix::orm::ShardStrategy;
+
+  struct Row
+  {
+    std::int64_t at;
+    std::int64_t id;
+  };
+
+  int failures = 0;
+
+  void check(bool ok, const char *what)
+  {
+    if (!ok)
+    {
+      std::fprintf(stderr, "FAILED: %s\n", what);
+      ++failures;
+    }
+  }
+
+  template <class Fn>
+  bool throws(Fn &&fn)
+  {
+    try
+    {
+      fn();
+    }
+    catch (const vix::db::DBError &)
+    {
+      return true;
+    }
+    return false;
+  }
+
+  ShardingOptions ranges(std::vector<std::int64_t> bounds)
+  {
+    ShardingOptions opt;
+    opt.strategy = ShardStrategy::Range;
+    opt.rangeBounds = std::move(bounds);
+    return opt;
+  }
+
+  std::vector<std::int64_t> ids(const std::vector<Row> &rows)
+  {
+    std::vector<std::int64_t> out;
+    for (const Row &r : rows)
+    {
+      out.push_back(r.id);
+    }
+    return out;
+  }
+
+  bool ascending(const Row &a, const Row &b)
+  {
+    return a.at < b.at || (!(b.at < a.at) && a.id < b.id);
+  }
+} // namespace
+
+int main()
+{
+  {
+    const ShardRouter router(ranges({100, 200}), 3);
+    check(router.shardFor(std::numeric_limits<std::int64_t>::min()) == 0, "range: minimum key on first shard");
+    check(router.shardFor(std::int64_t{99}) == 0, "range: below first bound");
+    check(router.shardFor(std::int64_t{100}) == 1, "range: bound opens the next shard");
+    check(router.shardFor(std::int64_t{199}) == 1, "range: below second bound");
+    check(router.shardFor(std::numeric_limits<std::int64_t>::max()) == 2, "range: maximum key on last shard");
+    check(throws([&]
+                 { (void)router.shardFor(std::string_view("tenant")); }),
+          "range: text keys rejected");
+  }
+
+  {
+    check(throws([]
+                 { ShardRouter(ShardingOptions{}, 0); }),
+          "zero shards rejected");
+    check(throws([]
+                 { ShardRouter(ranges({100}), 3); }),
+          "range: bound count must be shards - 1");
+    check(throws([]
+                 { ShardRouter(ranges({200, 100}), 3); }),
+          "range: bounds must ascend");
+
+    ShardingOptions bad;
+    bad.keyColumn = "tenant; DROP TABLE t";
+    check(throws([&]
+                 { ShardRouter(bad, 2); }),
+          "key column must be an identifier");
+  }
+
+  {
+    ShardingOptions opt;
+    opt.keyColumn = "tenant_id";
+    const ShardRouter router(opt, 4);
+
+    std::vector<int> hits(4);
+    for (std::int64_t key = 0; key < 4000; ++key)
+    {
+      ++hits[router.shardFor(key)];
+    }
+    bool balanced = true;
+    for (int n : hits)
+    {
+      balanced = balanced && n > 800 && n < 1200;
+    }
+    check(balanced, "hash: sequential keys spread across shards");
+
+    check(router.shardFor(std::string_view("acme")) == router.shardFor(std::string_view("acme")),
+          "hash: text routing is stable");
+
+    const FieldValues byInt{{"name", std::string("x")}, {"tenant_id", std::int64_t{42}}};
+    check(router.shardOf(byInt, "test") == router.shardFor(std::int64_t{42}),
+          "shardOf reads an integer key field");
+
+    const FieldValues byText{{"tenant_id", std::string("acme")}};
+    check(router.shardOf(byText, "test") == router.shardFor(std::string_view("acme")),
+          "shardOf reads a text key field");
+
+    const FieldValues missing{{"name", std::string("x")}};
+    check(throws([&]
+                 { (void)router.shardOf(missing, "test"); }),
+          "shardOf requires the key field");
+  }
+
+  {
+    // Equal sort values on different shards are ordered by id, not by shard.
+    std::vector<std::vector<Row>> parts{
+        {{1, 9}, {2, 5}, {4, 1}},
+        {{1, 3}, {2, 4}, {3, 2}},
+        {},
+        {{2, 1}, {5, 6}}};
+
+    auto page = vix::orm::detail::merge_pages(parts, 0, 8, ascending);
+    check(ids(page) == std::vector<std::int64_t>{3, 9, 1, 4, 5, 2, 1, 6},
+          "merge orders by value then id");
+  }
+
+  {
+    std::vector<std::vector<Row>> parts{
+        {{1, 1}, {3, 3}, {5, 5}},
+        {{2, 2}, {4, 4}, {6, 6}}};
+
+    auto page = vix::orm::detail::merge_pages(parts, 2, 3, ascending);
+    check(ids(page) == std::vector<std::int64_t>{3, 4, 5}, "merge skips offset and keeps limit");
+
+    std::vector<std::vector<Row>> empty(3);
+    check(vix::orm::detail::merge_pages(empty, 0, 10, ascending).empty(), "merge of empty shards");
+  }
+
+  {
+    const auto descending = [](const Row &a, const Row &b)
+    { return ascending(b, a); };
+
+    std::vector<std::vector<Row>> parts{
+        {{7, 8}, {7, 2}, {1, 1}},
+        {{7, 5}, {3, 3}}};
+
+    auto page = vix::orm::detail::merge_pages(parts, 0, 5, descending);
+    check(ids(page) == std::vector<std::int64_t>{8, 5, 2, 3, 1}, "descending merge breaks ties by id");
+  }
+
+  return failures == 0 ? 0 : 1;
+}
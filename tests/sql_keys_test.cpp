@@ -0,0 +1,99 @@
+/**
+ *
+ *  @file sql_keys_test.cpp
+ *  @author Gaspard Kirira
+ *
+ *  Copyright 2025, Gaspard Kirira.
+ *  All rights reserved.
+ *  https://github.com/vixcpp/vix
+ *
+ *  Use of this source code is governed by a MIT license
+ *  that can be found in the License file.
+ *
+ *  Vix.cpp
+ */
+#include <vix/orm/Fingerprint.hpp>
+#include <vix/orm/QueryBuilder.hpp>
+#include <vix/orm/SqlTemplate.hpp>
+
+#include <cstdio>
+
+namespace
+{
+  using vix::orm::sql;
+  using vix::orm::sql_fingerprint;
+
+  // Statements that normalize to the same fingerprint must keep distinct keys.
+
+  static_assert(sql<"SELECT id FROM users WHERE status = 'a'">.key !=
+                sql<"SELECT id FROM users WHERE status = 'b'">.key);
+  static_assert(sql<"SELECT id FROM users WHERE status = 'a'">.fingerprint ==
+                sql<"SELECT id FROM users WHERE status = 'b'">.fingerprint);
+
+  static_assert(sql<"SELECT id FROM users WHERE id IN (?, ?)">.key !=
+                sql<"SELECT id FROM users WHERE id IN (?, ?, ?)">.key);
+  static_assert(sql<"SELECT id FROM users WHERE id IN (?, ?)">.fingerprint ==
+                sql<"SELECT id FROM users WHERE id IN (?, ?, ?)">.fingerprint);
+
+  static_assert(sql<"SELECT id FROM users LIMIT ?, ?">.key !=
+                sql<"SELECT id FROM users LIMIT ?">.key);
+  static_assert(sql<"SELECT id FROM users LIMIT ?, ?">.fingerprint ==
+                sql<"SELECT id FROM users LIMIT ?">.fingerprint);
+
+  static_assert(sql<"SELECT 1, 2">.key != sql<"SELECT 1">.key);
+  static_assert(sql<"SELECT 1, 2">.fingerprint == sql<"SELECT 1">.fingerprint);
+
+  // Formatting differences only affect the key.
+
+  static_assert(sql<"SELECT id FROM users">.key != sql<"select  id\nfrom users">.key);
+  static_assert(sql<"SELECT id FROM users">.fingerprint ==
+                sql<"select  id\nfrom users">.fingerprint);
+
+  int failures = 0;
+
+  void check(bool ok, const char *what)
+  {
+    if (!ok)
+    {
+      std::fprintf(stderr, "FAILED: %s\n", what);
+      ++failures;
+    }
+  }
+} // namespace
+
+int main()
+{
+  using vix::orm::QueryBuilder;
+
+  {
+    QueryBuilder qb;
+    qb.raw("SELECT id, name ")
+        .raw("FRO")
+        .raw("M users WHERE na")
+        .raw("me = 'x' AND id IN (?,")
+        .space()
+        .raw("?)")
+        .newline()
+        .raw("-- trailing comment");
+
+    check(qb.fingerprint() == sql_fingerprint(qb.sql()),
+          "fragmented builder matches whole-text fingerprint");
+    check(qb.fingerprint() ==
+              sql<"select id, name from users where name = ? and id in (?)">.fingerprint,
+          "builder matches compile-time fingerprint");
+  }
+
+  {
+    QueryBuilder qb("SELECT 1");
+    const auto before = qb.fingerprint();
+    qb.raw(", 2");
+    check(qb.fingerprint() == before, "value runs collapse");
+    qb.raw(" FROM t");
+    check(qb.fingerprint() != before, "appending SQL updates the fingerprint");
+
+    qb.clear();
+    check(qb.fingerprint() == sql_fingerprint(""), "clear() resets the fingerprint");
+  }
+
+  return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,157 @@
+/**
+ *
+ *  @file typed_query_test.cpp
+ *  @author Gaspard Kirira
+ *
+ *  Copyright 2025, Gaspard Kirira.
+ *  All rights reserved.
+ *  https://github.com/vixcpp/vix
+ *
+ *  Use of this source code is governed by a MIT license
+ *  that can be found in the License file.
+ *
+ *  Vix.cpp
+ */
+#include <vix/orm/SqlTemplate.hpp>
+#include <vix/orm/TypedQuery.hpp>
+
+#include <cstdint>
+#include <cstdio>
+#include <optional>
+#include <string>
+#include <string_view>
+
+struct User
+{
+  std::int64_t id;
+  std::string name;
+  int age;
+  std::optional<double> score;
+};
+
+struct Order
+{
+  std::int64_t id;
+  std::int64_t userId;
+};
+
+template <>
+struct vix::orm::Table<User>
+{
+  static constexpr std::string_view name = "users";
+};
+
+template <>
+struct vix::orm::Column<&User::id>
+{
+  static constexpr std::string_view name = "id";
+};
+
+template <>
+struct vix::orm::Column<&User::name>
+{
+  static constexpr std::string_view name = "name";
+};
+
+template <>
+struct vix::orm::Column<&User::age>
+{
+  static constexpr std::string_view name = "age";
+};
+
+template <>
+struct vix::orm::Column<&User::score>
+{
+  static constexpr std::string_view name = "score";
+};
+
+template <>
+struct vix::orm::Column<&Order::userId>
+{
+  static constexpr std::string_view name = "user_id";
+};
+
+namespace
+{
+  using namespace vix::orm::placeholders;
+  using vix::orm::col;
+  using vix::orm::select;
+
+  constexpr auto adults = select<&User::id, &User::name, &User::score>()
+                              .from<User>()
+                              .where(col<&User::age> > _1 && col<&User::name> != _2)
+                              .orderBy<&User::id>()
+                              .orderByDesc<&User::age>()
+                              .limit(_3);
+
+  using Adults = decltype(adults);
+
+  static_assert(Adults::sql() ==
+                "SELECT id, name, score FROM users WHERE (age > ? AND name <> ?) "
+                "ORDER BY id, age DESC LIMIT ?");
+  static_assert(Adults::arity == 3);
+  static_assert(Adults::key == vix::orm::sql<"SELECT id, name, score FROM users WHERE (age > ? AND name <> ?) "
+                                             "ORDER BY id, age DESC LIMIT ?">
+                                   .key);
+
+  constexpr auto firstTen = select<&User::id>().from<User>().limit<10>();
+  static_assert(decltype(firstTen)::sql() == "SELECT id FROM users LIMIT 10");
+  static_assert(decltype(firstTen)::arity == 0);
+
+  // Reused placeholders bind the same argument twice.
+  constexpr auto band = select<&User::id>().from<User>().where(col<&User::age> >= _1 || col<&User::age> == _1);
+  static_assert(decltype(band)::arity == 1);
+
+  // Predicate columns are checked against the FROM entity.
+  using AgeAbove = decltype(col<&User::age> > _1);
+  using ByUser = decltype(col<&Order::userId> == _1);
+  static_assert(AgeAbove::belongs_to<User>);
+  static_assert(!ByUser::belongs_to<User>);
+  static_assert(!decltype(col<&User::age> > _1 && col<&Order::userId> == _2)::belongs_to<User>);
+
+  // Arguments must convert to the member compared with their placeholder.
+  static_assert(AgeAbove::accepts<1, int>);
+  static_assert(AgeAbove::accepts<1, short &>);
+  static_assert(!AgeAbove::accepts<1, std::string>);
+  static_assert(AgeAbove::accepts<2, std::string>);
+  static_assert(decltype(col<&User::name> == _1)::accepts<1, const char (&)[4]>);
+  static_assert(decltype(col<&User::score> < _1)::accepts<1, double>);
+  static_assert(!decltype(col<&User::name> == _1)::accepts<1, int>);
+
+  // Optionals bind only when their value type does.
+  static_assert(vix::orm::DbBindable<std::optional<std::string>>);
+  static_assert(vix::orm::DbBindable<const std::optional<std::optional<int>> &>);
+  static_assert(!vix::orm::DbBindable<std::optional<Order>>);
+  static_assert(!vix::orm::DbBindable<std::optional<std::optional<Order>>>);
+
+  // LIMIT placeholders take integers.
+  static_assert(vix::orm::detail::BoundCount<3>::accepts<3, std::size_t>);
+  static_assert(!vix::orm::detail::BoundCount<3>::accepts<3, double>);
+
+  int failures = 0;
+
+  void check(bool ok, const char *what)
+  {
+    if (!ok)
+    {
+      std::fprintf(stderr, "FAILED: %s\n", what);
+      ++failures;
+    }
+  }
+} // namespace
+
+int main()
+{
+  {
+    const auto qb = adults.toBuilder(18, "bob", 5);
+    check(qb.sql() == Adults::sql(), "toBuilder keeps the rendered SQL");
+    check(qb.params().size() == 3, "toBuilder binds one value per placeholder");
+  }
+
+  {
+    const auto qb = band.toBuilder(30);
+    check(qb.params().size() == 2, "reused placeholder is bound at each use");
+  }
+
+  return failures == 0 ? 0 : 1;
+}